@@ -6,6 +6,7 @@
             "./deps/src/active_info.c",
             "./deps/src/block_entropy.c",
             "./deps/src/conditional_entropy.c",
+            "./deps/src/counts.c",
             "./deps/src/cross_entropy.c",
             "./deps/src/dist.c",
             "./deps/src/effective_info.c",
@@ -15,11 +16,14 @@
             "./deps/src/information_flow.c",
             "./deps/src/integration.c",
             "./deps/src/mutual_info.c",
+            "./deps/src/parallel.c",
             "./deps/src/pid.c",
             "./deps/src/predictive_info.c",
             "./deps/src/relative_entropy.c",
             "./deps/src/separable_info.c",
+            "./deps/src/series_profile.c",
             "./deps/src/shannon.c",
+            "./deps/src/sparse.c",
             "./deps/src/transfer_entropy.c",
             "./deps/src/utilities/binning.c",
             "./deps/src/utilities/black_boxing.c",
@@ -28,9 +32,15 @@
             "./deps/src/utilities/partitions.c",
             "./deps/src/utilities/random.c",
             "./deps/src/utilities/tpm.c",
+            "./deps/src/xlogx.c",
+            "./cpp/estimator.cpp",
+            "./cpp/handle.cpp",
             "./cpp/inform.cpp",
+            "./cpp/matrix.cpp",
             "./cpp/series.cpp",
-            "./cpp/util.cpp"
+            "./cpp/significance.cpp",
+            "./cpp/util.cpp",
+            "./cpp/window.cpp"
         ],
         "include_dirs": [
             "./deps/include",
@@ -0,0 +1,459 @@
+#include "./estimator.h"
+
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+
+using namespace v8;
+
+namespace inform {
+    static uint32_t const magic = 0x534a4649;
+    static uint32_t const version = 2;
+
+    // The largest histogram, in counts, that an estimator will allocate.
+    static double const max_support = 1 << 30;
+
+    static auto table() -> XLogXTable const& {
+        static XLogXTable const values(1 << 16);
+        return values;
+    }
+
+    static auto power(uint64_t b, size_t k) -> uint64_t {
+        uint64_t q = 1;
+        for (size_t i = 0; i < k; ++i) {
+            q *= b;
+        }
+        return q;
+    }
+
+    static auto throws_error(Isolate *isolate, inform_error err) -> void {
+        throws(isolate, Exception::Error, inform_strerror(&err));
+    }
+
+    static auto get_base(Isolate *isolate, Local<Value> const &arg) -> Maybe<int32_t> {
+        auto const maybe_b = get_number<Integer, int32_t>(arg);
+        if (maybe_b.IsNothing()) {
+            throws(isolate, Exception::TypeError, "base is not an integer");
+        } else if (maybe_b.FromJust() < 2) {
+            throws_error(isolate, INFORM_EBASE);
+            return Nothing<int32_t>();
+        }
+        return maybe_b;
+    }
+
+    static auto get_history(Isolate *isolate, Local<Value> const &arg, int32_t b, size_t extra) -> Maybe<size_t> {
+        auto const maybe_k = get_number<Integer, size_t>(arg);
+        if (maybe_k.IsNothing()) {
+            throws(isolate, Exception::TypeError, "history length is not an unsigned integer");
+        } else if (maybe_k.FromJust() == 0) {
+            throws_error(isolate, INFORM_EKZERO);
+            return Nothing<size_t>();
+        } else if (std::pow(static_cast<double>(b), maybe_k.FromJust() + extra) > max_support) {
+            throws_error(isolate, INFORM_ENOMEM);
+            return Nothing<size_t>();
+        }
+        return maybe_k;
+    }
+
+    /**
+     * Parse a chunk of a stream, and check that every state is in `[0, b)`
+     * before any of it is observed, so that an invalid chunk leaves the
+     * estimator untouched.
+     */
+    static auto get_chunk(Isolate *isolate, Local<Value> const &arg, int32_t b) -> Maybe<SeriesView> {
+        auto const maybe_xs = get_series(isolate, arg);
+        if (maybe_xs.IsNothing()) {
+            return Nothing<SeriesView>();
+        }
+
+        auto const xs = maybe_xs.FromJust();
+        if (xs.trials() != 1) {
+            throws(isolate, Exception::TypeError, "estimators accept one trial at a time");
+            return Nothing<SeriesView>();
+        } else if (xs.validated() && xs.base() <= b) {
+            return maybe_xs;
+        }
+        for (auto const x : xs) {
+            if (x < 0) {
+                throws_error(isolate, INFORM_ENEGSTATE);
+                return Nothing<SeriesView>();
+            } else if (x >= b) {
+                throws_error(isolate, INFORM_EBADSTATE);
+                return Nothing<SeriesView>();
+            }
+        }
+        return maybe_xs;
+    }
+
+    static auto get_chunks(Arguments const &args, int32_t b, SeriesView &xs, SeriesView &ys) -> bool {
+        auto isolate = args.GetIsolate();
+
+        if (args.Length() < 2) {
+            throws(isolate, Exception::TypeError, "two arguments are required");
+            return false;
+        }
+
+        auto const maybe_xs = get_chunk(isolate, args[0], b);
+        if (maybe_xs.IsNothing()) {
+            return false;
+        }
+
+        auto const maybe_ys = get_chunk(isolate, args[1], b);
+        if (maybe_ys.IsNothing()) {
+            return false;
+        }
+
+        xs = maybe_xs.FromJust();
+        ys = maybe_ys.FromJust();
+        if (xs.size() != ys.size()) {
+            throws(isolate, Exception::TypeError, "time series have different lengths");
+            return false;
+        }
+        return true;
+    }
+
+    // Widen the counters of the histograms if a total of `observations`
+    // observations could overflow them.
+    static auto reserve(uint64_t observations, std::initializer_list<StreamHistogram*> histograms) -> void {
+        for (auto histogram : histograms) {
+            histogram->reserve(observations);
+        }
+    }
+
+    // Check that the serialized state is at least large enough to hold
+    // histograms with `support` counts before allocating them.
+    static auto fits(StateReader const &reader, double support) -> bool {
+        return support <= max_support && support * sizeof(uint32_t) <= reader.remaining();
+    }
+}
+
+inform::MutualInfoStream::MutualInfoStream(int32_t b)
+    : b(b), joint(b * b, table()), x(b, table()), y(b, table()) {}
+
+auto inform::MutualInfoStream::parse(Arguments const& args) -> Maybe<MutualInfoStream> {
+    auto isolate = args.GetIsolate();
+
+    if (args.Length() < 1) {
+        inform::throws(isolate, Exception::TypeError, "one argument is required");
+        return Nothing<MutualInfoStream>();
+    }
+
+    auto const maybe_b = inform::get_base(isolate, args[0]);
+    if (maybe_b.IsNothing()) {
+        return Nothing<MutualInfoStream>();
+    } else if (std::pow(maybe_b.FromJust(), 2) > max_support) {
+        throws_error(isolate, INFORM_ENOMEM);
+        return Nothing<MutualInfoStream>();
+    }
+
+    return Just(MutualInfoStream(maybe_b.FromJust()));
+}
+
+auto inform::MutualInfoStream::restore(StateReader &reader) -> Maybe<MutualInfoStream> {
+    int32_t b = 0;
+    if (!reader.read(b) || b < 2 || !fits(reader, std::pow(b, 2))) {
+        return Nothing<MutualInfoStream>();
+    }
+
+    auto stream = MutualInfoStream(b);
+    if (reader.read(stream.observations) && reader.read(stream.joint) && reader.read(stream.x)
+        && reader.read(stream.y)) {
+        return Just(stream);
+    }
+    return Nothing<MutualInfoStream>();
+}
+
+auto inform::MutualInfoStream::push(Arguments const& args) -> bool {
+    auto xs = SeriesView(), ys = SeriesView();
+    if (!get_chunks(args, b, xs, ys)) {
+        return false;
+    }
+
+    reserve(observations + xs.size(), { &joint, &x, &y });
+    for (size_t i = 0; i < xs.size(); ++i) {
+        joint.add(xs.data()[i] * b + ys.data()[i]);
+        x.add(xs.data()[i]);
+        y.add(ys.data()[i]);
+    }
+    observations += xs.size();
+    return true;
+}
+
+auto inform::MutualInfoStream::value() const -> double {
+    if (observations == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    auto const N = static_cast<double>(observations);
+    return (joint.xlogx() - x.xlogx() - y.xlogx()) / N + std::log2(N);
+}
+
+auto inform::MutualInfoStream::save(StateWriter &writer) const -> void {
+    writer.write(b);
+    writer.write(observations);
+    writer.write(joint);
+    writer.write(x);
+    writer.write(y);
+}
+
+inform::ActiveInfoStream::ActiveInfoStream(size_t k, int32_t b)
+    : k(k), b(b), q(power(b, k))
+    , states(q * b, table()), histories(q, table()), futures(b, table()) {}
+
+auto inform::ActiveInfoStream::parse(Arguments const& args) -> Maybe<ActiveInfoStream> {
+    auto isolate = args.GetIsolate();
+
+    if (args.Length() < 2) {
+        inform::throws(isolate, Exception::TypeError, "two arguments are required");
+        return Nothing<ActiveInfoStream>();
+    }
+
+    auto const maybe_b = inform::get_base(isolate, args[1]);
+    if (maybe_b.IsNothing()) {
+        return Nothing<ActiveInfoStream>();
+    }
+
+    auto const maybe_k = inform::get_history(isolate, args[0], maybe_b.FromJust(), 1);
+    if (maybe_k.IsNothing()) {
+        return Nothing<ActiveInfoStream>();
+    }
+
+    return Just(ActiveInfoStream(maybe_k.FromJust(), maybe_b.FromJust()));
+}
+
+auto inform::ActiveInfoStream::restore(StateReader &reader) -> Maybe<ActiveInfoStream> {
+    uint64_t k = 0;
+    int32_t b = 0;
+    if (!reader.read(k) || !reader.read(b) || k == 0 || b < 2 || !fits(reader, std::pow(b, k + 1))) {
+        return Nothing<ActiveInfoStream>();
+    }
+
+    auto stream = ActiveInfoStream(k, b);
+    if (reader.read(stream.pushed) && reader.read(stream.history) && reader.read(stream.observations)
+        && reader.read(stream.states) && reader.read(stream.histories) && reader.read(stream.futures)
+        && stream.history < stream.q) {
+        return Just(stream);
+    }
+    return Nothing<ActiveInfoStream>();
+}
+
+auto inform::ActiveInfoStream::push(Arguments const& args) -> bool {
+    auto isolate = args.GetIsolate();
+
+    if (args.Length() < 1) {
+        inform::throws(isolate, Exception::TypeError, "one argument is required");
+        return false;
+    }
+
+    auto const maybe_xs = get_chunk(isolate, args[0], b);
+    if (maybe_xs.IsNothing()) {
+        return false;
+    }
+
+    reserve(observations + maybe_xs.FromJust().size(), { &states, &histories, &futures });
+    for (auto const x : maybe_xs.FromJust()) {
+        auto const future = static_cast<uint64_t>(x);
+        if (pushed >= k) {
+            states.add(history * b + future);
+            histories.add(history);
+            futures.add(future);
+            ++observations;
+        }
+        history = (history * b + future) % q;
+        ++pushed;
+    }
+    return true;
+}
+
+auto inform::ActiveInfoStream::value() const -> double {
+    if (observations == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    auto const N = static_cast<double>(observations);
+    return (states.xlogx() - histories.xlogx() - futures.xlogx()) / N + std::log2(N);
+}
+
+auto inform::ActiveInfoStream::save(StateWriter &writer) const -> void {
+    writer.write<uint64_t>(k);
+    writer.write(b);
+    writer.write(pushed);
+    writer.write(history);
+    writer.write(observations);
+    writer.write(states);
+    writer.write(histories);
+    writer.write(futures);
+}
+
+inform::TransferEntropyStream::TransferEntropyStream(size_t k, int32_t b)
+    : k(k), b(b), q(power(b, k))
+    , states(q * b * b, table()), histories(q, table())
+    , sources(q * b, table()), predicates(q * b, table()) {}
+
+auto inform::TransferEntropyStream::parse(Arguments const& args) -> Maybe<TransferEntropyStream> {
+    auto isolate = args.GetIsolate();
+
+    if (args.Length() < 2) {
+        inform::throws(isolate, Exception::TypeError, "two arguments are required");
+        return Nothing<TransferEntropyStream>();
+    }
+
+    auto const maybe_b = inform::get_base(isolate, args[1]);
+    if (maybe_b.IsNothing()) {
+        return Nothing<TransferEntropyStream>();
+    }
+
+    auto const maybe_k = inform::get_history(isolate, args[0], maybe_b.FromJust(), 2);
+    if (maybe_k.IsNothing()) {
+        return Nothing<TransferEntropyStream>();
+    }
+
+    return Just(TransferEntropyStream(maybe_k.FromJust(), maybe_b.FromJust()));
+}
+
+auto inform::TransferEntropyStream::restore(StateReader &reader) -> Maybe<TransferEntropyStream> {
+    uint64_t k = 0;
+    int32_t b = 0;
+    if (!reader.read(k) || !reader.read(b) || k == 0 || b < 2 || !fits(reader, std::pow(b, k + 2))) {
+        return Nothing<TransferEntropyStream>();
+    }
+
+    auto stream = TransferEntropyStream(k, b);
+    if (reader.read(stream.pushed) && reader.read(stream.history) && reader.read(stream.source)
+        && reader.read(stream.observations) && reader.read(stream.states) && reader.read(stream.histories)
+        && reader.read(stream.sources) && reader.read(stream.predicates)
+        && stream.history < stream.q && 0 <= stream.source && stream.source < b) {
+        return Just(stream);
+    }
+    return Nothing<TransferEntropyStream>();
+}
+
+auto inform::TransferEntropyStream::push(Arguments const& args) -> bool {
+    auto xs = SeriesView(), ys = SeriesView();
+    if (!get_chunks(args, b, xs, ys)) {
+        return false;
+    }
+
+    reserve(observations + xs.size(), { &states, &histories, &sources, &predicates });
+    for (size_t i = 0; i < xs.size(); ++i) {
+        auto const future = static_cast<uint64_t>(ys.data()[i]);
+        if (pushed >= k) {
+            auto const predicate = history * b + future;
+            states.add(predicate * b + source);
+            histories.add(history);
+            sources.add(history * b + source);
+            predicates.add(predicate);
+            ++observations;
+        }
+        history = (history * b + future) % q;
+        source = xs.data()[i];
+        ++pushed;
+    }
+    return true;
+}
+
+auto inform::TransferEntropyStream::value() const -> double {
+    if (observations == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    auto const N = static_cast<double>(observations);
+    return (states.xlogx() + histories.xlogx() - sources.xlogx() - predicates.xlogx()) / N;
+}
+
+auto inform::TransferEntropyStream::save(StateWriter &writer) const -> void {
+    writer.write<uint64_t>(k);
+    writer.write(b);
+    writer.write(pushed);
+    writer.write(history);
+    writer.write(source);
+    writer.write(observations);
+    writer.write(states);
+    writer.write(histories);
+    writer.write(sources);
+    writer.write(predicates);
+}
+
+template <typename Stream>
+auto inform::Estimator<Stream>::init(Local<Object> exports) -> void {
+    auto isolate = exports->GetIsolate();
+    auto context = isolate->GetCurrentContext();
+
+    auto const name = String::NewFromUtf8(isolate, Stream::name(), NewStringType::kNormal).ToLocalChecked();
+    auto tpl = FunctionTemplate::New(isolate, Estimator::construct);
+    tpl->SetClassName(name);
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+    NODE_SET_PROTOTYPE_METHOD(tpl, "push", Estimator::push);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "value", Estimator::value);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "serialize", Estimator::serialize);
+
+    exports->Set(context, name, tpl->GetFunction(context).ToLocalChecked()).FromJust();
+}
+
+template <typename Stream>
+auto inform::Estimator<Stream>::construct(FunctionCallbackInfo<Value> const& args) -> void {
+    auto isolate = args.GetIsolate();
+
+    if (!args.IsConstructCall()) {
+        return inform::throws(isolate, Exception::TypeError, "estimators must be constructed with new");
+    }
+
+    auto maybe_stream = Nothing<Stream>();
+    if (args.Length() == 1 && args[0]->IsArrayBuffer()) {
+        auto const buffer = args[0].As<ArrayBuffer>();
+        auto reader = StateReader(static_cast<uint8_t const*>(buffer->GetContents().Data()), buffer->ByteLength());
+
+        uint32_t header[3] = { 0, 0, 0 };
+        if (reader.read(header[0]) && reader.read(header[1]) && reader.read(header[2])
+            && header[0] == magic && 1 <= header[1] && header[1] <= version && header[2] == Stream::kind) {
+            reader.set_version(header[1]);
+            maybe_stream = Stream::restore(reader);
+        }
+        if (maybe_stream.IsNothing() || !reader.done()) {
+            return inform::throws(isolate, Exception::TypeError, "estimator state is invalid");
+        }
+    } else {
+        maybe_stream = Stream::parse(Arguments(args));
+        if (maybe_stream.IsNothing()) {
+            return;
+        }
+    }
+
+    auto estimator = new Estimator(maybe_stream.FromJust());
+    estimator->Wrap(args.This());
+    args.GetReturnValue().Set(args.This());
+}
+
+template <typename Stream>
+auto inform::Estimator<Stream>::push(FunctionCallbackInfo<Value> const& args) -> void {
+    auto estimator = node::ObjectWrap::Unwrap<Estimator>(args.Holder());
+    if (estimator->stream.push(Arguments(args))) {
+        args.GetReturnValue().Set(args.This());
+    }
+}
+
+template <typename Stream>
+auto inform::Estimator<Stream>::value(FunctionCallbackInfo<Value> const& args) -> void {
+    auto estimator = node::ObjectWrap::Unwrap<Estimator>(args.Holder());
+    args.GetReturnValue().Set(Number::New(args.GetIsolate(), estimator->stream.value()));
+}
+
+template <typename Stream>
+auto inform::Estimator<Stream>::serialize(FunctionCallbackInfo<Value> const& args) -> void {
+    auto estimator = node::ObjectWrap::Unwrap<Estimator>(args.Holder());
+
+    auto writer = StateWriter();
+    writer.write(magic);
+    writer.write(version);
+    writer.write(Stream::kind);
+    estimator->stream.save(writer);
+
+    auto const &bytes = writer.data();
+    auto buffer = ArrayBuffer::New(args.GetIsolate(), bytes.size());
+    std::copy(bytes.begin(), bytes.end(), static_cast<uint8_t*>(buffer->GetContents().Data()));
+    args.GetReturnValue().Set(buffer);
+}
+
+auto inform::init_estimators(Local<Object> exports) -> void {
+    Estimator<MutualInfoStream>::init(exports);
+    Estimator<ActiveInfoStream>::init(exports);
+    Estimator<TransferEntropyStream>::init(exports);
+}
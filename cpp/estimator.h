@@ -0,0 +1,207 @@
+#pragma once
+
+#include "./histogram.h"
+#include "./util.h"
+
+#include <cstring>
+#include <inform/error.h>
+#include <node_object_wrap.h>
+
+namespace inform {
+    using namespace v8;
+
+    /**
+     * The serialized state of an estimator: a flat sequence of fixed-width
+     * fields in native byte order, starting with a magic number, a format
+     * version and the kind of estimator.
+     */
+    class StateWriter {
+        public:
+            template <typename Type>
+            auto write(Type value) -> void {
+                auto const first = reinterpret_cast<uint8_t const*>(&value);
+                bytes.insert(bytes.end(), first, first + sizeof(Type));
+            }
+
+            auto write(StreamHistogram const &histogram) -> void {
+                write<uint8_t>(histogram.is_wide() ? sizeof(uint64_t) : sizeof(uint32_t));
+                histogram.visit([this](auto const &counts) {
+                    write<uint64_t>(counts.size());
+                    for (auto const count : counts) {
+                        write(count);
+                    }
+                });
+            }
+
+            auto data() const -> std::vector<uint8_t> const& { return bytes; }
+
+        private:
+            std::vector<uint8_t> bytes;
+    };
+
+    /**
+     * Reads the fields written by a `StateWriter`. Reading past the end of
+     * the state, or reading a histogram of the wrong size, marks the reader
+     * as failed rather than reading out of bounds.
+     *
+     * Histograms are written with the width of their counters since
+     * version 2 of the format; version 1 always wrote 32-bit counters.
+     */
+    class StateReader {
+        public:
+            StateReader(uint8_t const *data, size_t size) : data(data), size(size) {}
+
+            auto set_version(uint32_t format) -> void { version = format; }
+
+            template <typename Type>
+            auto read(Type &value) -> bool {
+                if (!ok || size - offset < sizeof(Type)) {
+                    return ok = false;
+                }
+                std::memcpy(&value, data + offset, sizeof(Type));
+                offset += sizeof(Type);
+                return true;
+            }
+
+            auto read(StreamHistogram &histogram) -> bool {
+                uint8_t width = sizeof(uint32_t);
+                if (version > 1 && !read(width)) {
+                    return false;
+                } else if (width == sizeof(uint32_t)) {
+                    return read_counts<uint32_t>(histogram);
+                } else if (width == sizeof(uint64_t)) {
+                    return read_counts<uint64_t>(histogram);
+                }
+                return ok = false;
+            }
+
+            auto remaining() const -> size_t { return size - offset; }
+            auto done() const -> bool { return ok && offset == size; }
+
+        private:
+            template <typename Count>
+            auto read_counts(StreamHistogram &histogram) -> bool {
+                uint64_t length = 0;
+                if (!read(length) || length != histogram.size()) {
+                    return ok = false;
+                }
+                auto counts = std::vector<Count>(length);
+                for (auto &count : counts) {
+                    read(count);
+                }
+                if (ok) {
+                    histogram.restore(std::move(counts));
+                }
+                return ok;
+            }
+
+            uint8_t const *data;
+            size_t size;
+            size_t offset = 0;
+            uint32_t version = 1;
+            bool ok = true;
+    };
+
+    /**
+     * The mutual information between two streams of observations.
+     */
+    class MutualInfoStream {
+        public:
+            static auto name() -> char const* { return "MutualInfoEstimator"; }
+            static uint32_t const kind = 1;
+
+            MutualInfoStream() = default;
+            explicit MutualInfoStream(int32_t b);
+
+            static auto parse(Arguments const&) -> Maybe<MutualInfoStream>;
+            static auto restore(StateReader&) -> Maybe<MutualInfoStream>;
+
+            auto push(Arguments const&) -> bool;
+            auto value() const -> double;
+            auto save(StateWriter&) const -> void;
+
+        private:
+            int32_t b = 2;
+            uint64_t observations = 0;
+            StreamHistogram joint, x, y;
+    };
+
+    /**
+     * The active information of a stream of observations. The last `k`
+     * observations are kept as the history for the next chunk.
+     */
+    class ActiveInfoStream {
+        public:
+            static auto name() -> char const* { return "ActiveInfoEstimator"; }
+            static uint32_t const kind = 2;
+
+            ActiveInfoStream() = default;
+            ActiveInfoStream(size_t k, int32_t b);
+
+            static auto parse(Arguments const&) -> Maybe<ActiveInfoStream>;
+            static auto restore(StateReader&) -> Maybe<ActiveInfoStream>;
+
+            auto push(Arguments const&) -> bool;
+            auto value() const -> double;
+            auto save(StateWriter&) const -> void;
+
+        private:
+            size_t k = 1;
+            int32_t b = 2;
+            uint64_t q = 2;
+            uint64_t pushed = 0, history = 0, observations = 0;
+            StreamHistogram states, histories, futures;
+    };
+
+    /**
+     * The transfer entropy between two streams of observations. The last `k`
+     * observations of the target, and the last observation of the source,
+     * are kept for the next chunk.
+     */
+    class TransferEntropyStream {
+        public:
+            static auto name() -> char const* { return "TransferEntropyEstimator"; }
+            static uint32_t const kind = 3;
+
+            TransferEntropyStream() = default;
+            TransferEntropyStream(size_t k, int32_t b);
+
+            static auto parse(Arguments const&) -> Maybe<TransferEntropyStream>;
+            static auto restore(StateReader&) -> Maybe<TransferEntropyStream>;
+
+            auto push(Arguments const&) -> bool;
+            auto value() const -> double;
+            auto save(StateWriter&) const -> void;
+
+        private:
+            size_t k = 1;
+            int32_t b = 2;
+            uint64_t q = 2;
+            uint64_t pushed = 0, history = 0, observations = 0;
+            int32_t source = 0;
+            StreamHistogram states, histories, sources, predicates;
+    };
+
+    /**
+     * A JavaScript class wrapping a `Stream`. The class is constructed either
+     * with the arguments expected by `Stream::parse` or with a single
+     * `ArrayBuffer` returned by `serialize`.
+     */
+    template <typename Stream>
+    class Estimator : public node::ObjectWrap {
+        public:
+            static auto init(Local<Object> exports) -> void;
+
+        private:
+            explicit Estimator(Stream stream) : stream(std::move(stream)) {}
+
+            static auto construct(FunctionCallbackInfo<Value> const& args) -> void;
+            static auto push(FunctionCallbackInfo<Value> const& args) -> void;
+            static auto value(FunctionCallbackInfo<Value> const& args) -> void;
+            static auto serialize(FunctionCallbackInfo<Value> const& args) -> void;
+
+            Stream stream;
+    };
+
+    auto init_estimators(Local<Object> exports) -> void;
+}
@@ -0,0 +1,85 @@
+#include "./handle.h"
+
+#include <inform/error.h>
+
+using namespace v8;
+
+auto inform::SeriesHandle::init(Local<Object> exports) -> void {
+    auto isolate = exports->GetIsolate();
+    auto context = isolate->GetCurrentContext();
+
+    auto const name = String::NewFromUtf8(isolate, "SeriesHandle", NewStringType::kNormal).ToLocalChecked();
+    auto tpl = FunctionTemplate::New(isolate, SeriesHandle::construct);
+    tpl->SetClassName(name);
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+    exports->Set(context, name, tpl->GetFunction(context).ToLocalChecked()).FromJust();
+}
+
+// Handles are recognized by a private symbol rather than by their
+// constructor, so that no V8 state outlives the isolate that created it.
+auto inform::SeriesHandle::brand(Isolate *isolate) -> Local<Private> {
+    auto key = String::NewFromUtf8(isolate, "informjs:SeriesHandle", NewStringType::kNormal);
+    return Private::ForApi(isolate, key.ToLocalChecked());
+}
+
+auto inform::SeriesHandle::unwrap(Isolate *isolate, Local<Value> const &arg) -> SeriesView const* {
+    if (!arg->IsObject()) {
+        return nullptr;
+    }
+    auto const object = arg.As<Object>();
+    if (!object->HasPrivate(isolate->GetCurrentContext(), brand(isolate)).FromMaybe(false)) {
+        return nullptr;
+    }
+    return &node::ObjectWrap::Unwrap<SeriesHandle>(object)->view;
+}
+
+auto inform::SeriesHandle::construct(FunctionCallbackInfo<Value> const& args) -> void {
+    auto isolate = args.GetIsolate();
+    auto context = isolate->GetCurrentContext();
+
+    if (!args.IsConstructCall()) {
+        return inform::throws(isolate, Exception::TypeError, "series handles must be constructed with new");
+    } else if (args.Length() != 1) {
+        return inform::throws(isolate, Exception::TypeError, "one argument is required");
+    }
+
+    auto const maybe_view = get_series(isolate, args[0]);
+    if (maybe_view.IsNothing()) {
+        return;
+    }
+    auto view = maybe_view.FromJust();
+    view.own();
+
+    if (view.size() == 0) {
+        inform_error err = INFORM_ETIMESERIES;
+        return inform::throws(isolate, Exception::Error, inform_strerror(&err));
+    }
+
+    auto const range = std::minmax_element(view.begin(), view.end());
+    auto const min = *range.first, max = *range.second;
+    if (min < 0) {
+        inform_error err = INFORM_ENEGSTATE;
+        return inform::throws(isolate, Exception::Error, inform_strerror(&err));
+    }
+    view.validate(std::max(2, max + 1));
+
+    auto const self = args.This();
+    auto const define = [&](char const *name, double value) {
+        auto const key = String::NewFromUtf8(isolate, name, NewStringType::kNormal).ToLocalChecked();
+        self->DefineOwnProperty(context, key, Number::New(isolate, value),
+            static_cast<PropertyAttribute>(ReadOnly | DontDelete)).FromJust();
+    };
+    define("base", view.base());
+    define("min", min);
+    define("max", max);
+    define("length", static_cast<double>(view.size()));
+    define("trials", static_cast<double>(view.trials()));
+    define("steps", static_cast<double>(view.steps()));
+
+    self->SetPrivate(context, brand(isolate), True(isolate)).FromJust();
+
+    auto handle = new SeriesHandle(view);
+    handle->Wrap(self);
+    args.GetReturnValue().Set(self);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "./util.h"
+
+#include <node_object_wrap.h>
+
+namespace inform {
+    using namespace v8;
+
+    /**
+     * A JavaScript class holding a copy of a time series (or of several
+     * trials) which has been checked for negative states, together with its
+     * base and range. Every export accepts a handle wherever it accepts a
+     * series, and skips rescanning it.
+     */
+    class SeriesHandle : public node::ObjectWrap {
+        public:
+            static auto init(Local<Object> exports) -> void;
+
+            /**
+             * The view of `arg` if it is a `SeriesHandle`, and `nullptr`
+             * otherwise.
+             */
+            static auto unwrap(Isolate *isolate, Local<Value> const &arg) -> SeriesView const*;
+
+        private:
+            explicit SeriesHandle(SeriesView view) : view(std::move(view)) {}
+
+            static auto construct(FunctionCallbackInfo<Value> const& args) -> void;
+            static auto brand(Isolate *isolate) -> Local<Private>;
+
+            SeriesView view;
+    };
+}
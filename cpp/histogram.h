@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace inform {
+    using Histogram = std::vector<uint32_t>;
+
+    /**
+     * The most counters in a histogram indexed directly by code (64 MiB of
+     * 32-bit counters). Histograms with larger supports are indexed by the
+     * codes which actually occur, as numbered by `compact`.
+     */
+    static uint64_t const max_dense = uint64_t{1} << 24;
+
+    /**
+     * Replace each code with a dense identifier in `[0, distinct)`, in order
+     * of first appearance, and return the number of distinct codes. Codes
+     * are looked up in a table when the `support` is small relative to the
+     * number of codes, and in a hash map otherwise.
+     */
+    inline auto compact(std::vector<uint64_t> const &codes, uint64_t support, std::vector<uint32_t> &ids) -> size_t {
+        auto const none = std::numeric_limits<uint32_t>::max();
+        uint32_t distinct = 0;
+
+        ids.resize(codes.size());
+        if (support <= 2 * codes.size() + 1024) {
+            auto table = std::vector<uint32_t>(support, none);
+            for (size_t i = 0; i < codes.size(); ++i) {
+                auto &id = table[codes[i]];
+                if (id == none) {
+                    id = distinct++;
+                }
+                ids[i] = id;
+            }
+        } else {
+            auto table = std::unordered_map<uint64_t, uint32_t>();
+            for (size_t i = 0; i < codes.size(); ++i) {
+                auto const inserted = table.emplace(codes[i], distinct);
+                if (inserted.second) {
+                    ++distinct;
+                }
+                ids[i] = inserted.first->second;
+            }
+        }
+        return distinct;
+    }
+
+    /**
+     * The sum of `n log2(n)` over the counts in `[first, last)`. Entropies of
+     * histograms with a common total `N` follow from this as
+     * `log2(N) - xlogx(...) / N`, which lets callers combine several
+     * histograms without normalizing each one.
+     */
+    template <typename Iterator>
+    auto xlogx(Iterator first, Iterator last) -> double {
+        auto sum = 0.0;
+        for (auto it = first; it != last; ++it) {
+            if (*it != 0) {
+                sum += *it * std::log2(static_cast<double>(*it));
+            }
+        }
+        return sum;
+    }
+
+    /**
+     * A table of `n log2(n)` for `n` in `[0, max]`. Larger counts are
+     * computed on demand.
+     */
+    class XLogXTable {
+        public:
+            explicit XLogXTable(size_t max) : values(max + 1) {
+                for (size_t n = 1; n <= max; ++n) {
+                    values[n] = n * std::log2(static_cast<double>(n));
+                }
+            }
+
+            auto operator[](size_t n) const -> double {
+                return n < values.size() ? values[n] : n * std::log2(static_cast<double>(n));
+            }
+
+        private:
+            std::vector<double> values;
+    };
+
+    /**
+     * A histogram which keeps `xlogx` of its counts up to date as
+     * observations are added and removed, so that each update costs a pair
+     * of table lookups rather than a pass over the histogram. The counters
+     * are `Count`s, which callers size from the most observations the
+     * histogram will hold, e.g. 16 bits for a short window.
+     */
+    template <typename Count>
+    class RunningHistogram {
+        public:
+            using Counts = std::vector<Count>;
+
+            RunningHistogram() = default;
+            RunningHistogram(size_t size, XLogXTable const &table) : histogram(size), table(&table) {}
+
+            auto add(size_t i) -> void {
+                auto &count = histogram[i];
+                sum += (*table)[count + 1] - (*table)[count];
+                ++count;
+            }
+
+            auto remove(size_t i) -> void {
+                auto &count = histogram[i];
+                --count;
+                sum += (*table)[count] - (*table)[count + 1];
+            }
+
+            auto xlogx() const -> double { return sum; }
+            auto counts() const -> Counts const& { return histogram; }
+
+            auto restore(Counts counts) -> void {
+                histogram = std::move(counts);
+                sum = inform::xlogx(histogram.begin(), histogram.end());
+            }
+
+            /**
+             * A copy of the histogram with wider counters.
+             */
+            template <typename Wider>
+            auto widen() const -> RunningHistogram<Wider> {
+                auto wider = RunningHistogram<Wider>(histogram.size(), *table);
+                wider.restore(typename RunningHistogram<Wider>::Counts(histogram.begin(), histogram.end()));
+                return wider;
+            }
+
+        private:
+            Counts histogram;
+            XLogXTable const *table = nullptr;
+            double sum = 0.0;
+    };
+
+    /**
+     * A running histogram of an unbounded stream of observations. Its
+     * counters start out 32 bits wide, and are widened to 64 bits before
+     * the stream can overflow them.
+     */
+    class StreamHistogram {
+        public:
+            StreamHistogram() = default;
+            StreamHistogram(size_t size, XLogXTable const &table) : narrow(size, table) {}
+
+            /**
+             * Make room for a total of `observations` observations.
+             */
+            auto reserve(uint64_t observations) -> void {
+                if (!wide_counters && observations > std::numeric_limits<uint32_t>::max()) {
+                    wide = narrow.widen<uint64_t>();
+                    narrow = RunningHistogram<uint32_t>();
+                    wide_counters = true;
+                }
+            }
+
+            auto add(size_t i) -> void {
+                if (wide_counters) {
+                    wide.add(i);
+                } else {
+                    narrow.add(i);
+                }
+            }
+
+            auto xlogx() const -> double { return wide_counters ? wide.xlogx() : narrow.xlogx(); }
+            auto is_wide() const -> bool { return wide_counters; }
+            auto size() const -> size_t { return wide_counters ? wide.counts().size() : narrow.counts().size(); }
+
+            /**
+             * Call `f` with the counts, as either 32- or 64-bit counters.
+             */
+            template <typename Function>
+            auto visit(Function f) const -> void {
+                if (wide_counters) {
+                    f(wide.counts());
+                } else {
+                    f(narrow.counts());
+                }
+            }
+
+            auto restore(RunningHistogram<uint32_t>::Counts counts) -> void {
+                narrow.restore(std::move(counts));
+            }
+
+            auto restore(RunningHistogram<uint64_t>::Counts counts) -> void {
+                wide = narrow.widen<uint64_t>();
+                wide.restore(std::move(counts));
+                narrow = RunningHistogram<uint32_t>();
+                wide_counters = true;
+            }
+
+        private:
+            RunningHistogram<uint32_t> narrow;
+            RunningHistogram<uint64_t> wide;
+            bool wide_counters = false;
+    };
+}
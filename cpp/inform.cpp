@@ -1,4 +1,9 @@
+#include "./estimator.h"
+#include "./handle.h"
+#include "./matrix.h"
 #include "./series.h"
+#include "./significance.h"
+#include "./window.h"
 
 namespace inform {
     using namespace v8;
@@ -7,6 +12,27 @@ namespace inform {
         NODE_SET_METHOD(exports, "mutualInfo", inform::mutual_info);
         NODE_SET_METHOD(exports, "activeInfo", inform::active_info);
         NODE_SET_METHOD(exports, "transferEntropy", inform::transfer_entropy);
+        NODE_SET_METHOD(exports, "seriesProfile", inform::series_profile);
+
+        NODE_SET_METHOD(exports, "localMutualInfo", inform::local_mutual_info);
+        NODE_SET_METHOD(exports, "localActiveInfo", inform::local_active_info);
+        NODE_SET_METHOD(exports, "localTransferEntropy", inform::local_transfer_entropy);
+
+        NODE_SET_METHOD(exports, "mutualInfoAsync", inform::mutual_info_async);
+        NODE_SET_METHOD(exports, "activeInfoAsync", inform::active_info_async);
+        NODE_SET_METHOD(exports, "transferEntropyAsync", inform::transfer_entropy_async);
+
+        NODE_SET_METHOD(exports, "mutualInfoMatrix", inform::mutual_info_matrix);
+        NODE_SET_METHOD(exports, "transferEntropyMatrix", inform::transfer_entropy_matrix);
+
+        NODE_SET_METHOD(exports, "mutualInfoWindows", inform::mutual_info_windows);
+        NODE_SET_METHOD(exports, "activeInfoWindows", inform::active_info_windows);
+        NODE_SET_METHOD(exports, "transferEntropyWindows", inform::transfer_entropy_windows);
+
+        NODE_SET_METHOD(exports, "permutationTest", inform::permutation_test);
+
+        inform::init_estimators(exports);
+        inform::SeriesHandle::init(exports);
     }
 
     NODE_MODULE(NODE_GYP_MODULE_NAME, init);
@@ -0,0 +1,334 @@
+#include "./matrix.h"
+#include "./histogram.h"
+#include "./measure.h"
+#include "./parallel.h"
+
+#include <atomic>
+#include <limits>
+#include <new>
+
+using namespace v8;
+
+namespace inform {
+    static auto get_series_list(Isolate *isolate, Local<Value> const &arg) -> Maybe<SeriesList> {
+        if (!arg->IsArray()) {
+            throws(isolate, Exception::TypeError, "time series list is not an array");
+            return Nothing<SeriesList>();
+        }
+
+        auto const list = Arguments(isolate, arg.As<Array>());
+        auto series = SeriesList();
+        for (auto i = 0; i < list.Length(); ++i) {
+            auto const maybe_xs = get_series(isolate, list[i]);
+            if (maybe_xs.IsNothing()) {
+                return Nothing<SeriesList>();
+            }
+            series.push_back(maybe_xs.FromJust());
+            if (series.front().size() != series.back().size()) {
+                throws(isolate, Exception::TypeError, "time series have different lengths");
+                return Nothing<SeriesList>();
+            } else if (series.front().trials() != series.back().trials()) {
+                throws(isolate, Exception::TypeError, "time series have different numbers of trials");
+                return Nothing<SeriesList>();
+            }
+        }
+        return Just(series);
+    }
+
+    /**
+     * Check each series once, up front, rather than once for every pair it
+     * takes part in.
+     */
+    static auto check_series(SeriesList const &series, size_t min_length, inform_error *err) -> bool {
+        if (series.empty()) {
+            return false;
+        }
+
+        auto const &front = series.front();
+        if (front.size() == 0) {
+            INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+        } else if (front.steps() < min_length) {
+            INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, true);
+        }
+
+        for (auto const &xs : series) {
+            if (has_negative_state(xs)) {
+                INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
+            }
+        }
+        return false;
+    }
+
+    /**
+     * The sum of `c log2 c` over the counts of the distinct codes.
+     */
+    static auto xlogx_codes(std::vector<uint64_t> const &codes, uint64_t support, std::vector<uint32_t> &ids)
+        -> double {
+        auto counts = Histogram(compact(codes, support, ids));
+        for (auto const id : ids) {
+            counts[id]++;
+        }
+        return xlogx(counts.begin(), counts.end());
+    }
+
+    /**
+     * A series whose states have been replaced by dense identifiers, so that
+     * histograms of it span only the states that occur rather than its base.
+     */
+    struct CompactSeries {
+        explicit CompactSeries(SeriesView const &xs) {
+            auto codes = std::vector<uint64_t>(xs.begin(), xs.end());
+            states = compact(codes, static_cast<uint64_t>(series_base(xs)), ids);
+        }
+
+        std::vector<uint32_t> ids;
+        size_t states;
+    };
+
+    /**
+     * Whether the histories of a base-`b` series, together with their next
+     * state, can be encoded in 64 bits, i.e. whether `b^(k+1)` fits.
+     */
+    static auto encodable(uint64_t b, size_t k) -> bool {
+        uint64_t q = 1;
+        for (size_t i = 0; i <= k; ++i) {
+            if (q > std::numeric_limits<uint64_t>::max() / b) {
+                return false;
+            }
+            q *= b;
+        }
+        return true;
+    }
+
+    /**
+     * The length-`k` histories of a target series and their futures, encoded
+     * once and shared by every source. The codes are compacted so that
+     * the joint histograms only span the histories that actually occur.
+     * The target must be `encodable`.
+     */
+    class TargetHistory {
+        public:
+            TargetHistory(SeriesView const &ys, size_t k) {
+                uint64_t const b = series_base(ys);
+                uint64_t q = 1;
+                for (size_t i = 0; i < k; ++i) {
+                    q *= b;
+                }
+
+                auto codes = std::vector<uint64_t>(), predicate_codes = std::vector<uint64_t>();
+                codes.reserve(ys.trials() * (ys.steps() - k));
+                predicate_codes.reserve(ys.trials() * (ys.steps() - k));
+
+                for (size_t i = 0; i < ys.trials(); ++i) {
+                    auto const trial = ys.data() + i * ys.steps();
+                    uint64_t code = 0;
+                    for (size_t j = 0; j < k; ++j) {
+                        code = code * b + trial[j];
+                    }
+                    for (size_t j = k; j < ys.steps(); ++j) {
+                        auto const predicate = code * b + trial[j];
+                        codes.push_back(code);
+                        predicate_codes.push_back(predicate);
+                        code = predicate - trial[j - k] * q;
+                    }
+                }
+
+                histories = compact(codes, q, history);
+                predicates = compact(predicate_codes, q * b, predicate);
+
+                auto counts = Histogram(histories);
+                for (auto const h : history) {
+                    counts[h]++;
+                }
+                invariant = xlogx(counts.begin(), counts.end());
+
+                counts.assign(predicates, 0);
+                for (auto const p : predicate) {
+                    counts[p]++;
+                }
+                invariant -= xlogx(counts.begin(), counts.end());
+            }
+
+            std::vector<uint32_t> history, predicate;
+            size_t histories, predicates;
+            double invariant;
+    };
+}
+
+auto inform::MutualInfoMatrix::parse(Arguments const& args) -> Maybe<MutualInfoMatrix> {
+    auto isolate = args.GetIsolate();
+
+    if (args.Length() < 1) {
+        inform::throws(isolate, Exception::TypeError, "one argument is required");
+        return Nothing<MutualInfoMatrix>();
+    }
+
+    auto const maybe_series = inform::get_series_list(isolate, args[0]);
+    if (maybe_series.IsNothing()) {
+        return Nothing<MutualInfoMatrix>();
+    }
+
+    return Just(MutualInfoMatrix{ maybe_series.FromJust() });
+}
+
+auto inform::MutualInfoMatrix::compute(double *matrix, inform_error *err) const -> void {
+    if (check_series(series, 1, err)) {
+        return;
+    }
+
+    try {
+        auto const n = series.size();
+        auto compacted = std::vector<CompactSeries>();
+        auto marginals = std::vector<double>(n);
+        for (size_t i = 0; i < n; ++i) {
+            compacted.emplace_back(series[i]);
+            auto counts = Histogram(compacted[i].states);
+            for (auto const x : compacted[i].ids) {
+                counts[x]++;
+            }
+            marginals[i] = xlogx(counts.begin(), counts.end());
+        }
+
+        std::atomic<size_t> next_row(0);
+        auto worker = [&]() {
+            auto joint = Histogram();
+            auto codes = std::vector<uint64_t>();
+            auto ids = std::vector<uint32_t>();
+            for (auto i = next_row++; i < n; i = next_row++) {
+                auto const &xs = compacted[i].ids;
+                auto const N = static_cast<double>(xs.size());
+                for (auto j = i; j < n; ++j) {
+                    auto const &ys = compacted[j].ids;
+                    auto const by = static_cast<uint64_t>(compacted[j].states);
+                    auto const support = compacted[i].states * by;
+                    auto sum = 0.0;
+                    if (support <= max_dense) {
+                        joint.assign(support, 0);
+                        for (size_t t = 0; t < xs.size(); ++t) {
+                            joint[xs[t] * by + ys[t]]++;
+                        }
+                        sum = xlogx(joint.begin(), joint.end());
+                    } else {
+                        codes.resize(xs.size());
+                        for (size_t t = 0; t < xs.size(); ++t) {
+                            codes[t] = xs[t] * by + ys[t];
+                        }
+                        sum = xlogx_codes(codes, support, ids);
+                    }
+                    auto const mi = (sum - marginals[i] - marginals[j]) / N + std::log2(N);
+                    matrix[i * n + j] = mi;
+                    matrix[j * n + i] = mi;
+                }
+            }
+        };
+        run_workers(n, worker);
+    } catch (std::bad_alloc const &) {
+        INFORM_ERROR_RETURN_VOID(err, INFORM_ENOMEM);
+    }
+}
+
+auto inform::TransferEntropyMatrix::parse(Arguments const& args) -> Maybe<TransferEntropyMatrix> {
+    auto isolate = args.GetIsolate();
+
+    if (args.Length() < 2) {
+        inform::throws(isolate, Exception::TypeError, "two arguments are required");
+        return Nothing<TransferEntropyMatrix>();
+    }
+
+    auto const maybe_series = inform::get_series_list(isolate, args[0]);
+    if (maybe_series.IsNothing()) {
+        return Nothing<TransferEntropyMatrix>();
+    }
+
+    auto const maybe_k = inform::get_number<Integer, size_t>(args[1]);
+    if (maybe_k.IsNothing()) {
+        throws(isolate, Exception::TypeError, "history length is not an unsigned integer");
+        return Nothing<TransferEntropyMatrix>();
+    }
+
+    return Just(TransferEntropyMatrix{ maybe_series.FromJust(), maybe_k.FromJust() });
+}
+
+auto inform::TransferEntropyMatrix::compute(double *matrix, inform_error *err) const -> void {
+    if (check_series(series, 2, err)) {
+        return;
+    } else if (!series.empty() && series.front().steps() <= k) {
+        INFORM_ERROR_RETURN_VOID(err, INFORM_EKLONG);
+    } else if (!series.empty() && k == 0) {
+        INFORM_ERROR_RETURN_VOID(err, INFORM_EKZERO);
+    }
+
+    auto const n = series.size();
+    for (auto const &ys : series) {
+        if (!encodable(static_cast<uint64_t>(series_base(ys)), k)) {
+            INFORM_ERROR_RETURN_VOID(err, INFORM_EENCODE);
+        }
+    }
+
+    try {
+        auto sources = std::vector<CompactSeries>();
+        for (auto const &xs : series) {
+            sources.emplace_back(xs);
+        }
+
+        // Each worker takes one target at a time, encodes its history once,
+        // and then sweeps every source past it.
+        std::atomic<size_t> next_target(0);
+        auto worker = [&]() {
+            auto arena = Histogram();
+            auto codes = std::vector<uint64_t>();
+            auto ids = std::vector<uint32_t>();
+            for (auto j = next_target++; j < n; j = next_target++) {
+                auto const target = TargetHistory(series[j], k);
+                auto const N = static_cast<double>(target.history.size());
+                for (size_t i = 0; i < n; ++i) {
+                    auto const b = static_cast<uint64_t>(sources[i].states);
+                    auto const &xs = sources[i].ids;
+                    auto const steps = series[i].steps();
+                    auto const support = (target.predicates + target.histories) * b;
+
+                    auto sum = 0.0;
+                    if (support <= max_dense) {
+                        arena.assign(support, 0);
+                        auto const states = arena.begin();
+                        auto const histories = states + target.predicates * b;
+                        for (size_t r = 0, t = 0; r < series[i].trials(); ++r) {
+                            auto const src = xs.data() + r * steps + k - 1;
+                            for (size_t s = 0; s < steps - k; ++s, ++t) {
+                                states[target.predicate[t] * b + src[s]]++;
+                                histories[target.history[t] * b + src[s]]++;
+                            }
+                        }
+                        sum = xlogx(states, histories) - xlogx(histories, arena.end());
+                    } else {
+                        codes.resize(target.history.size());
+                        for (auto const which : { 0, 1 }) {
+                            auto const &target_codes = which ? target.history : target.predicate;
+                            for (size_t r = 0, t = 0; r < series[i].trials(); ++r) {
+                                auto const src = xs.data() + r * steps + k - 1;
+                                for (size_t s = 0; s < steps - k; ++s, ++t) {
+                                    codes[t] = target_codes[t] * b + src[s];
+                                }
+                            }
+                            auto const term = xlogx_codes(codes, support, ids);
+                            sum += which ? -term : term;
+                        }
+                    }
+
+                    matrix[i * n + j] = (target.invariant + sum) / N;
+                }
+            }
+        };
+        run_workers(n, worker);
+    } catch (std::bad_alloc const &) {
+        INFORM_ERROR_RETURN_VOID(err, INFORM_ENOMEM);
+    }
+}
+
+auto inform::mutual_info_matrix(FunctionCallbackInfo<Value> const& args) -> void {
+    inform::evaluate_array<MutualInfoMatrix>(args);
+}
+
+auto inform::transfer_entropy_matrix(FunctionCallbackInfo<Value> const& args) -> void {
+    inform::evaluate_array<TransferEntropyMatrix>(args);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "./util.h"
+
+#include <inform/error.h>
+
+namespace inform {
+    using namespace v8;
+
+    using SeriesList = std::vector<SeriesView>;
+
+    /**
+     * The mutual information between every pair of a list of time series.
+     * The matrix is symmetric, and its diagonal holds the entropy of each
+     * series.
+     */
+    struct MutualInfoMatrix {
+        SeriesList series;
+
+        static auto parse(Arguments const&) -> Maybe<MutualInfoMatrix>;
+        auto output_size() const -> size_t { return series.size() * series.size(); }
+        auto compute(double *matrix, inform_error*) const -> void;
+    };
+
+    /**
+     * The transfer entropy between every ordered pair of a list of time
+     * series. Element `i * n + j` of the matrix is the transfer entropy from
+     * series `i` to series `j`.
+     */
+    struct TransferEntropyMatrix {
+        SeriesList series;
+        size_t k;
+
+        static auto parse(Arguments const&) -> Maybe<TransferEntropyMatrix>;
+        auto output_size() const -> size_t { return series.size() * series.size(); }
+        auto compute(double *matrix, inform_error*) const -> void;
+    };
+
+    auto mutual_info_matrix(v8::FunctionCallbackInfo<v8::Value> const& args) -> void;
+    auto transfer_entropy_matrix(v8::FunctionCallbackInfo<v8::Value> const& args) -> void;
+}
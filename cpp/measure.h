@@ -0,0 +1,209 @@
+#pragma once
+
+#include "./util.h"
+
+#include <inform/error.h>
+#include <utility>
+#include <uv.h>
+
+namespace inform {
+    using namespace v8;
+
+    /**
+     * A `Measure` is any type with a static
+     * `parse(Arguments const&) -> Maybe<Measure>` method,
+     * which validates the JavaScript arguments, an `own() -> void` method,
+     * which copies any series borrowed from JavaScript, and a
+     * `compute(inform_error*) const -> double` method which runs the
+     * underlying Inform function. Because `compute` never touches V8, it is
+     * safe to call it off of the main thread once `own` has copied any
+     * borrowed series.
+     */
+    template <typename Measure>
+    auto evaluate(FunctionCallbackInfo<Value> const& args) -> void {
+        auto isolate = args.GetIsolate();
+
+        auto const maybe_measure = Measure::parse(Arguments(args));
+        if (maybe_measure.IsNothing()) {
+            return;
+        }
+
+        inform_error err = INFORM_SUCCESS;
+        auto const value = maybe_measure.FromJust().compute(&err);
+
+        if (err) {
+            return throws(isolate, Exception::Error, inform_strerror(&err));
+        }
+
+        args.GetReturnValue().Set(Number::New(isolate, value));
+    }
+
+    /**
+     * Like `evaluate`, but for measures which produce an array of values,
+     * e.g. one value per pair of series or per window. Such a measure has an
+     * `output_size() const -> size_t` method and a
+     * `compute(double*, inform_error*) const -> void` method which fills an
+     * array of that size. The array is returned as a `Float64Array`, which
+     * the measure writes into directly.
+     */
+    template <typename Measure>
+    auto evaluate_array(FunctionCallbackInfo<Value> const& args) -> void {
+        auto isolate = args.GetIsolate();
+
+        auto const maybe_measure = Measure::parse(Arguments(args));
+        if (maybe_measure.IsNothing()) {
+            return;
+        }
+        auto const &measure = maybe_measure.FromJust();
+
+        auto const size = measure.output_size();
+        auto buffer = ArrayBuffer::New(isolate, size * sizeof(double));
+        auto data = static_cast<double*>(buffer->GetContents().Data());
+
+        inform_error err = INFORM_SUCCESS;
+        measure.compute(data, &err);
+        if (err) {
+            return throws(isolate, Exception::Error, inform_strerror(&err));
+        }
+
+        args.GetReturnValue().Set(Float64Array::New(buffer, 0, size));
+    }
+
+    /**
+     * Like `evaluate_array`, but the caller may pass a `Float64Array` as
+     * argument `Measure::output` for the values to be written into rather
+     * than a new array, so that repeated calls over long series can reuse
+     * one array instead of leaving a fresh one to the garbage collector. The
+     * array must hold at least `output_size()` values; it is returned as is
+     * if it holds exactly that many, and as a view of the first
+     * `output_size()` values otherwise.
+     */
+    template <typename Measure>
+    auto evaluate_into(FunctionCallbackInfo<Value> const& args) -> void {
+        auto isolate = args.GetIsolate();
+
+        Local<Value> const output = args[Measure::output];
+        if (output->IsUndefined()) {
+            return evaluate_array<Measure>(args);
+        } else if (!output->IsFloat64Array()) {
+            return throws(isolate, Exception::TypeError, "output is not a Float64Array");
+        }
+
+        auto const maybe_measure = Measure::parse(Arguments(args));
+        if (maybe_measure.IsNothing()) {
+            return;
+        }
+        auto const &measure = maybe_measure.FromJust();
+
+        auto const array = output.As<Float64Array>();
+        auto const size = measure.output_size();
+        if (array->Length() < size) {
+            return throws(isolate, Exception::TypeError, "output array is too short");
+        }
+        auto const bytes = static_cast<uint8_t*>(array->Buffer()->GetContents().Data());
+        auto data = reinterpret_cast<double*>(bytes + array->ByteOffset());
+
+        inform_error err = INFORM_SUCCESS;
+        measure.compute(data, &err);
+        if (err) {
+            return throws(isolate, Exception::Error, inform_strerror(&err));
+        }
+
+        if (array->Length() == size) {
+            args.GetReturnValue().Set(array);
+        } else {
+            args.GetReturnValue().Set(Float64Array::New(array->Buffer(), array->ByteOffset(), size));
+        }
+    }
+
+    /**
+     * A measure queued on the libuv worker pool together with the promise
+     * that it will settle once the computation has finished.
+     */
+    template <typename Measure>
+    class AsyncMeasure : public node::AsyncResource {
+        public:
+            AsyncMeasure(Isolate *isolate, Local<Promise::Resolver> resolver, Measure measure)
+                : node::AsyncResource(isolate, Object::New(isolate), "informjs:measure")
+                , isolate(isolate)
+                , context(isolate, isolate->GetCurrentContext())
+                , resolver(isolate, resolver)
+                , measure(std::move(measure)) {
+                request.data = this;
+            }
+
+            auto queue() -> int {
+                return uv_queue_work(node::GetCurrentEventLoop(isolate), &request,
+                    AsyncMeasure::execute, AsyncMeasure::complete);
+            }
+
+        private:
+            static auto execute(uv_work_t *request) -> void {
+                auto self = static_cast<AsyncMeasure*>(request->data);
+                self->value = self->measure.compute(&self->err);
+            }
+
+            static auto complete(uv_work_t *request, int) -> void {
+                auto self = static_cast<AsyncMeasure*>(request->data);
+                {
+                    auto const isolate = self->isolate;
+                    HandleScope handle_scope(isolate);
+                    auto const context = Local<Context>::New(isolate, self->context);
+                    Context::Scope context_scope(context);
+                    CallbackScope callback_scope(self);
+
+                    auto const resolver = Local<Promise::Resolver>::New(isolate, self->resolver);
+                    if (self->err) {
+                        auto message = String::NewFromUtf8(isolate,
+                            inform_strerror(&self->err), NewStringType::kNormal);
+                        resolver->Reject(context, Exception::Error(message.ToLocalChecked()))
+                            .FromMaybe(false);
+                    } else {
+                        resolver->Resolve(context, Number::New(isolate, self->value))
+                            .FromMaybe(false);
+                    }
+                }
+                delete self;
+            }
+
+            uv_work_t request;
+            Isolate *isolate;
+            Global<Context> context;
+            Global<Promise::Resolver> resolver;
+            Measure measure;
+            inform_error err = INFORM_SUCCESS;
+            double value = 0.0;
+    };
+
+    /**
+     * Parse the arguments on the main thread, then compute the measure on the
+     * libuv worker pool. The returned promise is rejected if either the
+     * arguments are invalid or the computation fails.
+     */
+    template <typename Measure>
+    auto evaluate_async(FunctionCallbackInfo<Value> const& args) -> void {
+        auto isolate = args.GetIsolate();
+        auto context = isolate->GetCurrentContext();
+
+        auto resolver = Promise::Resolver::New(context).ToLocalChecked();
+        args.GetReturnValue().Set(resolver->GetPromise());
+
+        TryCatch try_catch(isolate);
+        auto maybe_measure = Measure::parse(Arguments(args));
+        if (maybe_measure.IsNothing()) {
+            resolver->Reject(context, try_catch.Exception()).FromMaybe(false);
+            return;
+        }
+
+        auto measure = maybe_measure.FromJust();
+        measure.own();
+
+        auto work = new AsyncMeasure<Measure>(isolate, resolver, std::move(measure));
+        if (work->queue() != 0) {
+            delete work;
+            auto message = String::NewFromUtf8(isolate,
+                "failed to queue work on the libuv thread pool", NewStringType::kNormal);
+            resolver->Reject(context, Exception::Error(message.ToLocalChecked())).FromMaybe(false);
+        }
+    }
+}
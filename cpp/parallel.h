@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace inform {
+    /**
+     * The number of threads to use for `tasks` independent units of work:
+     * one per hardware thread, but never more than there are tasks.
+     */
+    inline auto worker_count(size_t tasks) -> size_t {
+        auto const hardware = std::max(1u, std::thread::hardware_concurrency());
+        return std::max<size_t>(1, std::min<size_t>(hardware, tasks));
+    }
+
+    /**
+     * Run `worker` on `worker_count(tasks)` threads, including the calling
+     * thread, and wait for all of them to finish. Each worker is expected to
+     * pull its tasks from shared state, e.g. an atomic counter, so that any
+     * per-thread scratch space is allocated once per thread.
+     *
+     * An exception must not escape a thread, so the first one thrown by any
+     * worker, e.g. a `std::bad_alloc`, is rethrown here once every worker
+     * has finished. If a thread cannot be started, the work is shared
+     * between those that were.
+     */
+    template <typename Worker>
+    auto run_workers(size_t tasks, Worker worker) -> void {
+        auto error = std::exception_ptr();
+        std::mutex mutex;
+        auto guarded = [&]() {
+            try {
+                worker();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        };
+
+        auto threads = std::vector<std::thread>();
+        for (size_t i = 1; i < worker_count(tasks); ++i) {
+            try {
+                threads.emplace_back(guarded);
+            } catch (std::system_error const &) {
+                break;
+            }
+        }
+        guarded();
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <inform/utilities/random.h>
+#include <utility>
+
+namespace inform {
+    /**
+     * The xoshiro256** generator of Blackman and Vigna, seeded with splitmix64,
+     * as implemented by Inform's `inform_rng`.
+     *
+     * Unlike `Math.random` or a seedrandom `prng`, a generator lives entirely
+     * on the native side, so it can be used from worker threads. The `jump`
+     * method advances the generator by 2^128 steps, which is how independent
+     * streams are handed out to parallel workers.
+     */
+    class Xoshiro256 {
+        public:
+            explicit Xoshiro256(uint64_t seed) {
+                inform_rng_seed(&rng, seed);
+            }
+
+            auto next() -> uint64_t {
+                return inform_rng_next(&rng);
+            }
+
+            /**
+             * Draw an integer uniformly from $[0, n)$ without modulo bias
+             * using Lemire's multiply-and-reject method.
+             */
+            auto bounded(uint32_t n) -> uint32_t {
+                return static_cast<uint32_t>(inform_rng_bounded(&rng, n));
+            }
+
+            auto jump() -> void {
+                inform_rng_jump(&rng);
+            }
+
+        private:
+            inform_rng rng;
+    };
+
+    /**
+     * Shuffle a range in place using Durstenfeld's version of the
+     * Fisher-Yates shuffle.
+     */
+    template <typename Type>
+    auto shuffle(Type *first, size_t n, Xoshiro256 &rng) -> void {
+        for (auto i = n; i > 1; --i) {
+            auto const j = rng.bounded(static_cast<uint32_t>(i));
+            std::swap(first[i - 1], first[j]);
+        }
+    }
+}
@@ -1,102 +1,165 @@
 #include "./series.h"
+#include "./measure.h"
 
 #include <inform/mutual_info.h>
 #include <inform/active_info.h>
+#include <inform/series_profile.h>
 #include <inform/transfer_entropy.h>
 
 using namespace v8;
 
-auto inform::mutual_info(FunctionCallbackInfo<Value> const& args) -> void {
+namespace inform {
+    /**
+     * Call `f` with the series of `xs` followed by that of `ys`, laid out one
+     * after the other as Inform expects. If the caller handed us adjacent
+     * views of one buffer, then they already are; otherwise they are copied
+     * into a combined buffer.
+     */
+    template <typename Function>
+    static auto with_joint_series(SeriesView const &xs, SeriesView const &ys, Function f) -> decltype(f(nullptr)) {
+        if (xs.data() + xs.size() == ys.data()) {
+            return f(xs.data());
+        }
+
+        auto series = Series(xs.size() + ys.size());
+        std::copy(xs.begin(), xs.end(), series.begin());
+        std::copy(ys.begin(), ys.end(), series.begin() + xs.size());
+        return f(series.data());
+    }
+}
+
+auto inform::MutualInfo::parse(Arguments const& args) -> Maybe<MutualInfo> {
     auto isolate = args.GetIsolate();
 
     if (args.Length() < 2) {
-        return inform::throws(isolate, Exception::TypeError, "two arguments are required");
+        inform::throws(isolate, Exception::TypeError, "two arguments are required");
+        return Nothing<MutualInfo>();
     }
 
-    auto const maybe_xs = inform::get_vector(isolate, args[0]);
+    auto const maybe_xs = inform::get_series(isolate, args[0]);
     if (maybe_xs.IsNothing()) {
-        return;
+        return Nothing<MutualInfo>();
     }
 
-    auto const maybe_ys = inform::get_vector(isolate, args[1]);
+    auto const maybe_ys = inform::get_series(isolate, args[1]);
     if (maybe_ys.IsNothing()) {
-        return;
+        return Nothing<MutualInfo>();
     }
 
     auto const xs = maybe_xs.FromJust();
     auto const ys = maybe_ys.FromJust();
 
     if (xs.size() != ys.size()) {
-        return throws(isolate, Exception::TypeError, "time series have different lengths");
+        throws(isolate, Exception::TypeError, "time series have different lengths");
+        return Nothing<MutualInfo>();
     }
-    auto series = std::vector<int32_t>(xs.size() + ys.size());
-    std::copy(xs.begin(), xs.end(), series.begin());
-    std::copy(ys.begin(), ys.end(), series.begin() + xs.size());
 
-    auto bases = std::vector<int>{ series_base(xs), series_base(ys) };
+    return Just(MutualInfo{ xs, ys });
+}
 
-    inform_error err = INFORM_SUCCESS;
-    auto mi = inform_mutual_info(series.data(), 2, xs.size(), bases.data(), &err);
+auto inform::MutualInfo::own() -> void {
+    xs.own();
+    ys.own();
+}
 
-    if (err) {
-        return throws(isolate, Exception::Error, inform_strerror(&err));
-    }
+auto inform::MutualInfo::compute(inform_error *err) const -> double {
+    int const bases[2] = { series_base(xs), series_base(ys) };
 
-    args.GetReturnValue().Set(Number::New(isolate, mi));
+    return with_joint_series(xs, ys, [&](int32_t const *series) {
+        return inform_mutual_info(series, 2, xs.size(), bases, err);
+    });
 }
 
-auto inform::active_info(FunctionCallbackInfo<Value> const& args) -> void {
+auto inform::ActiveInfo::parse(Arguments const& args) -> Maybe<ActiveInfo> {
     auto isolate = args.GetIsolate();
 
-    if (args.Length() != 2) {
-        return inform::throws(isolate, Exception::TypeError, "two arguments are required");
+    if (args.Length() < 2) {
+        inform::throws(isolate, Exception::TypeError, "two arguments are required");
+        return Nothing<ActiveInfo>();
     }
 
-    auto const maybe_xs = inform::get_vector(isolate, args[0]);
+    auto const maybe_xs = inform::get_series(isolate, args[0]);
     if (maybe_xs.IsNothing()) {
-        return;
+        return Nothing<ActiveInfo>();
     }
 
     auto const maybe_k = inform::get_number<Integer, size_t>(args[1]);
     if (maybe_k.IsNothing()) {
-        return throws(isolate, Exception::TypeError, "history length is not an unsigned integer");
+        throws(isolate, Exception::TypeError, "history length is not an unsigned integer");
+        return Nothing<ActiveInfo>();
     }
 
-    auto const xs = maybe_xs.FromJust();
-    auto const k = maybe_k.FromJust();
+    return Just(ActiveInfo{ maybe_xs.FromJust(), maybe_k.FromJust() });
+}
 
+auto inform::ActiveInfo::own() -> void {
+    xs.own();
+}
+
+auto inform::ActiveInfo::compute(inform_error *err) const -> double {
     auto const b = series_base(xs);
 
-    inform_error err = INFORM_SUCCESS;
-    auto ai = inform_active_info(xs.data(), 1, xs.size(), b, k, &err);
+    return inform_active_info(xs.data(), xs.trials(), xs.steps(), b, k, err);
+}
+
+auto inform::SeriesProfile::parse(Arguments const& args) -> Maybe<SeriesProfile> {
+    auto isolate = args.GetIsolate();
+
+    if (args.Length() != 2) {
+        inform::throws(isolate, Exception::TypeError, "two arguments are required");
+        return Nothing<SeriesProfile>();
+    }
+
+    auto const maybe_xs = inform::get_series(isolate, args[0]);
+    if (maybe_xs.IsNothing()) {
+        return Nothing<SeriesProfile>();
+    }
 
-    if (err) {
-        return throws(isolate, Exception::Error, inform_strerror(&err));
+    auto const maybe_k = inform::get_number<Integer, size_t>(args[1]);
+    if (maybe_k.IsNothing()) {
+        throws(isolate, Exception::TypeError, "history length is not an unsigned integer");
+        return Nothing<SeriesProfile>();
     }
 
-    args.GetReturnValue().Set(Number::New(isolate, ai));
+    return Just(SeriesProfile{ maybe_xs.FromJust(), maybe_k.FromJust() });
 }
 
-auto inform::transfer_entropy(FunctionCallbackInfo<Value> const& args) -> void {
+auto inform::SeriesProfile::output_size() const -> size_t {
+    return 4;
+}
+
+auto inform::SeriesProfile::compute(double *profile, inform_error *err) const -> void {
+    auto const b = series_base(xs);
+
+    auto const p = inform_profile_series(xs.data(), xs.trials(), xs.steps(), b, k, err);
+    profile[0] = p.active_info;
+    profile[1] = p.entropy_rate;
+    profile[2] = p.block_entropy;
+    profile[3] = p.predictive_info;
+}
+
+auto inform::TransferEntropy::parse(Arguments const& args) -> Maybe<TransferEntropy> {
     auto isolate = args.GetIsolate();
 
     if (args.Length() < 3) {
-        return inform::throws(isolate, Exception::TypeError, "three arguments are required");
+        inform::throws(isolate, Exception::TypeError, "three arguments are required");
+        return Nothing<TransferEntropy>();
     }
 
-    auto const maybe_xs = inform::get_vector(isolate, args[0]);
+    auto const maybe_xs = inform::get_series(isolate, args[0]);
     if (maybe_xs.IsNothing()) {
-        return;
+        return Nothing<TransferEntropy>();
     }
 
-    auto const maybe_ys = inform::get_vector(isolate, args[1]);
+    auto const maybe_ys = inform::get_series(isolate, args[1]);
     if (maybe_ys.IsNothing()) {
-        return;
+        return Nothing<TransferEntropy>();
     }
 
     auto const maybe_k = inform::get_number<Integer, size_t>(args[2]);
     if (maybe_k.IsNothing()) {
-        return throws(isolate, Exception::TypeError, "history length is not an unsigned integer");
+        throws(isolate, Exception::TypeError, "history length is not an unsigned integer");
+        return Nothing<TransferEntropy>();
     }
 
     auto const xs = maybe_xs.FromJust();
@@ -104,17 +167,125 @@ auto inform::transfer_entropy(FunctionCallbackInfo<Value> const& args) -> void {
     auto const k = maybe_k.FromJust();
 
     if (xs.size() != ys.size()) {
-        return throws(isolate, Exception::TypeError, "time series have different lengths");
+        throws(isolate, Exception::TypeError, "time series have different lengths");
+        return Nothing<TransferEntropy>();
+    } else if (xs.trials() != ys.trials()) {
+        throws(isolate, Exception::TypeError, "time series have different numbers of trials");
+        return Nothing<TransferEntropy>();
     }
 
+    return Just(TransferEntropy{ xs, ys, k });
+}
+
+auto inform::TransferEntropy::own() -> void {
+    xs.own();
+    ys.own();
+}
+
+auto inform::TransferEntropy::compute(inform_error *err) const -> double {
     auto const b = std::max(series_base(xs), series_base(ys));
 
-    inform_error err = INFORM_SUCCESS;
-    auto te = inform_transfer_entropy(xs.data(), ys.data(), NULL, 0,  1, xs.size(), b, k, &err);
+    return inform_transfer_entropy(xs.data(), ys.data(), NULL, 0, xs.trials(), xs.steps(), b, k, err);
+}
 
-    if (err) {
-        return throws(isolate, Exception::Error, inform_strerror(&err));
+auto inform::LocalMutualInfo::parse(Arguments const& args) -> Maybe<LocalMutualInfo> {
+    auto const maybe_measure = MutualInfo::parse(args);
+    if (maybe_measure.IsNothing()) {
+        return Nothing<LocalMutualInfo>();
     }
+    return Just(LocalMutualInfo{ maybe_measure.FromJust() });
+}
+
+auto inform::LocalMutualInfo::output_size() const -> size_t {
+    return measure.xs.size();
+}
+
+auto inform::LocalMutualInfo::compute(double *local, inform_error *err) const -> void {
+    auto const &xs = measure.xs, &ys = measure.ys;
+    int const bases[2] = { series_base(xs), series_base(ys) };
+
+    with_joint_series(xs, ys, [&](int32_t const *series) {
+        return inform_local_mutual_info(series, 2, xs.size(), bases, local, err);
+    });
+}
+
+auto inform::LocalActiveInfo::parse(Arguments const& args) -> Maybe<LocalActiveInfo> {
+    auto const maybe_measure = ActiveInfo::parse(args);
+    if (maybe_measure.IsNothing()) {
+        return Nothing<LocalActiveInfo>();
+    }
+    return Just(LocalActiveInfo{ maybe_measure.FromJust() });
+}
+
+auto inform::LocalActiveInfo::output_size() const -> size_t {
+    auto const &xs = measure.xs;
+    return xs.steps() > measure.k ? xs.trials() * (xs.steps() - measure.k) : 0;
+}
+
+auto inform::LocalActiveInfo::compute(double *local, inform_error *err) const -> void {
+    auto const &xs = measure.xs;
+    auto const b = series_base(xs);
+
+    inform_local_active_info(xs.data(), xs.trials(), xs.steps(), b, measure.k, local, err);
+}
+
+auto inform::LocalTransferEntropy::parse(Arguments const& args) -> Maybe<LocalTransferEntropy> {
+    auto const maybe_measure = TransferEntropy::parse(args);
+    if (maybe_measure.IsNothing()) {
+        return Nothing<LocalTransferEntropy>();
+    }
+    return Just(LocalTransferEntropy{ maybe_measure.FromJust() });
+}
+
+auto inform::LocalTransferEntropy::output_size() const -> size_t {
+    auto const &ys = measure.ys;
+    return ys.steps() > measure.k ? ys.trials() * (ys.steps() - measure.k) : 0;
+}
+
+auto inform::LocalTransferEntropy::compute(double *local, inform_error *err) const -> void {
+    auto const &xs = measure.xs, &ys = measure.ys;
+    auto const b = std::max(series_base(xs), series_base(ys));
+
+    inform_local_transfer_entropy(xs.data(), ys.data(), NULL, 0, xs.trials(), xs.steps(), b, measure.k,
+        local, err);
+}
+
+auto inform::mutual_info(FunctionCallbackInfo<Value> const& args) -> void {
+    inform::evaluate<MutualInfo>(args);
+}
+
+auto inform::active_info(FunctionCallbackInfo<Value> const& args) -> void {
+    inform::evaluate<ActiveInfo>(args);
+}
+
+auto inform::series_profile(FunctionCallbackInfo<Value> const& args) -> void {
+    inform::evaluate_array<SeriesProfile>(args);
+}
+
+auto inform::transfer_entropy(FunctionCallbackInfo<Value> const& args) -> void {
+    inform::evaluate<TransferEntropy>(args);
+}
+
+auto inform::local_mutual_info(FunctionCallbackInfo<Value> const& args) -> void {
+    inform::evaluate_into<LocalMutualInfo>(args);
+}
+
+auto inform::local_active_info(FunctionCallbackInfo<Value> const& args) -> void {
+    inform::evaluate_into<LocalActiveInfo>(args);
+}
+
+auto inform::local_transfer_entropy(FunctionCallbackInfo<Value> const& args) -> void {
+    inform::evaluate_into<LocalTransferEntropy>(args);
+}
+
+auto inform::mutual_info_async(FunctionCallbackInfo<Value> const& args) -> void {
+    inform::evaluate_async<MutualInfo>(args);
+}
+
+auto inform::active_info_async(FunctionCallbackInfo<Value> const& args) -> void {
+    inform::evaluate_async<ActiveInfo>(args);
+}
 
-    args.GetReturnValue().Set(Number::New(isolate, te));
+auto inform::transfer_entropy_async(FunctionCallbackInfo<Value> const& args) -> void {
+    inform::evaluate_async<TransferEntropy>(args);
 }
@@ -1,9 +1,103 @@
+#pragma once
+
 #include "./util.h"
 
+#include <inform/error.h>
+
 namespace inform {
     using namespace v8;
 
+    struct MutualInfo {
+        SeriesView xs, ys;
+
+        static auto parse(Arguments const& args) -> Maybe<MutualInfo>;
+        auto own() -> void;
+        auto compute(inform_error *err) const -> double;
+    };
+
+    struct ActiveInfo {
+        SeriesView xs;
+        size_t k;
+
+        static auto parse(Arguments const& args) -> Maybe<ActiveInfo>;
+        auto own() -> void;
+        auto compute(inform_error *err) const -> double;
+    };
+
+    /**
+     * The active information, entropy rate, block entropy and predictive
+     * information of a series, computed in one pass by
+     * `inform_profile_series` and returned in that order.
+     */
+    struct SeriesProfile {
+        SeriesView xs;
+        size_t k;
+
+        static auto parse(Arguments const& args) -> Maybe<SeriesProfile>;
+        auto output_size() const -> size_t;
+        auto compute(double *profile, inform_error *err) const -> void;
+    };
+
+    struct TransferEntropy {
+        SeriesView xs, ys;
+        size_t k;
+
+        static auto parse(Arguments const& args) -> Maybe<TransferEntropy>;
+        auto own() -> void;
+        auto compute(inform_error *err) const -> double;
+    };
+
+    /**
+     * The local mutual information at each time step, written into the
+     * optional `Float64Array` given as the third argument.
+     */
+    struct LocalMutualInfo {
+        MutualInfo measure;
+        static int const output = 2;
+
+        static auto parse(Arguments const& args) -> Maybe<LocalMutualInfo>;
+        auto output_size() const -> size_t;
+        auto compute(double *local, inform_error *err) const -> void;
+    };
+
+    /**
+     * The local active information at each time step of each trial after
+     * the first `k`, written into the optional `Float64Array` given as the
+     * third argument.
+     */
+    struct LocalActiveInfo {
+        ActiveInfo measure;
+        static int const output = 2;
+
+        static auto parse(Arguments const& args) -> Maybe<LocalActiveInfo>;
+        auto output_size() const -> size_t;
+        auto compute(double *local, inform_error *err) const -> void;
+    };
+
+    /**
+     * The local transfer entropy at each time step of each trial after the
+     * first `k`, written into the optional `Float64Array` given as the
+     * fourth argument.
+     */
+    struct LocalTransferEntropy {
+        TransferEntropy measure;
+        static int const output = 3;
+
+        static auto parse(Arguments const& args) -> Maybe<LocalTransferEntropy>;
+        auto output_size() const -> size_t;
+        auto compute(double *local, inform_error *err) const -> void;
+    };
+
     auto mutual_info(v8::FunctionCallbackInfo<v8::Value> const& args) -> void;
     auto active_info(v8::FunctionCallbackInfo<v8::Value> const& args) -> void;
+    auto series_profile(v8::FunctionCallbackInfo<v8::Value> const& args) -> void;
     auto transfer_entropy(v8::FunctionCallbackInfo<v8::Value> const& args) -> void;
+
+    auto local_mutual_info(v8::FunctionCallbackInfo<v8::Value> const& args) -> void;
+    auto local_active_info(v8::FunctionCallbackInfo<v8::Value> const& args) -> void;
+    auto local_transfer_entropy(v8::FunctionCallbackInfo<v8::Value> const& args) -> void;
+
+    auto mutual_info_async(v8::FunctionCallbackInfo<v8::Value> const& args) -> void;
+    auto active_info_async(v8::FunctionCallbackInfo<v8::Value> const& args) -> void;
+    auto transfer_entropy_async(v8::FunctionCallbackInfo<v8::Value> const& args) -> void;
 }
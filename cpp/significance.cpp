@@ -0,0 +1,397 @@
+#include "./significance.h"
+#include "./histogram.h"
+#include "./parallel.h"
+#include "./random.h"
+
+#include <atomic>
+#include <cmath>
+#include <new>
+
+using namespace v8;
+
+namespace inform {
+    // Surrogate values are compared against the observed value with a small
+    // tolerance since permuted histograms are summed in a different order.
+    static double const tolerance = 1e-10;
+
+    // The number of permutations drawn from each random stream. Permutations
+    // are split across threads in chunks of this size, so the result depends
+    // only on the seed and not on the number of threads.
+    static size_t const chunk_size = 64;
+
+    // The most counters in the histogram arena of each thread (64 MiB). A
+    // measure whose histograms would not fit is evaluated by Inform instead,
+    // which counts large supports in hash tables.
+    static double const max_arena = 1 << 24;
+
+    /**
+     * The mutual information of `xs` and a permutation of `ys`. The marginal
+     * entropies are invariant under permutation, so only the joint histogram
+     * is rebuilt for each surrogate.
+     */
+    class MutualInfoSurrogate {
+        public:
+            explicit MutualInfoSurrogate(MutualInfo const &measure)
+                : xs(measure.xs), ys(measure.ys)
+                , bx(series_base(xs)), by(series_base(ys)) {
+                auto const N = static_cast<double>(xs.size());
+                auto hx = Histogram(bx), hy = Histogram(by);
+                for (size_t i = 0; i < xs.size(); ++i) {
+                    hx[xs.data()[i]]++;
+                    hy[ys.data()[i]]++;
+                }
+                marginals = 2 * N * std::log2(N) - xlogx(hx.begin(), hx.end()) - xlogx(hy.begin(), hy.end());
+            }
+
+            static auto fits(MutualInfo const &measure) -> bool {
+                return static_cast<double>(series_base(measure.xs)) * series_base(measure.ys) <= max_arena;
+            }
+
+            auto series() const -> SeriesView const& { return ys; }
+            auto arena_size() const -> size_t { return static_cast<size_t>(bx) * by; }
+
+            auto evaluate(int32_t const *shuffled, Histogram &joint, inform_error *) const -> double {
+                std::fill(joint.begin(), joint.end(), 0);
+                for (size_t i = 0; i < xs.size(); ++i) {
+                    joint[xs.data()[i] * by + shuffled[i]]++;
+                }
+                auto const N = static_cast<double>(xs.size());
+                return (marginals + xlogx(joint.begin(), joint.end()) - N * std::log2(N)) / N;
+            }
+
+        private:
+            SeriesView xs, ys;
+            int32_t bx, by;
+            double marginals;
+    };
+
+    /**
+     * The active information of a permutation of `xs`.
+     */
+    class ActiveInfoSurrogate {
+        public:
+            explicit ActiveInfoSurrogate(ActiveInfo const &measure)
+                : xs(measure.xs), k(measure.k), b(series_base(xs)) {
+                q = 1;
+                for (size_t i = 0; i < k; ++i) {
+                    q *= b;
+                }
+            }
+
+            static auto fits(ActiveInfo const &measure) -> bool {
+                auto const b = static_cast<double>(series_base(measure.xs));
+                auto const q = std::pow(b, static_cast<double>(measure.k));
+                return q * b + q + b <= max_arena;
+            }
+
+            auto series() const -> SeriesView const& { return xs; }
+            auto arena_size() const -> size_t { return q * b + q + b; }
+
+            auto evaluate(int32_t const *shuffled, Histogram &arena, inform_error *) const -> double {
+                std::fill(arena.begin(), arena.end(), 0);
+                auto const states = arena.begin();
+                auto const histories = states + q * b;
+                auto const futures = histories + q;
+
+                auto const m = xs.steps();
+                for (size_t i = 0; i < xs.trials(); ++i) {
+                    auto const trial = shuffled + i * m;
+                    size_t history = 0;
+                    for (size_t j = 0; j < k; ++j) {
+                        history = history * b + trial[j];
+                    }
+                    for (size_t j = k; j < m; ++j) {
+                        auto const future = static_cast<size_t>(trial[j]);
+                        auto const state = history * b + future;
+                        states[state]++;
+                        histories[history]++;
+                        futures[future]++;
+                        history = state - trial[j - k] * q;
+                    }
+                }
+
+                auto const N = static_cast<double>(xs.trials() * (m - k));
+                return (xlogx(states, histories) - xlogx(histories, futures)
+                    - xlogx(futures, arena.end())) / N + std::log2(N);
+            }
+
+        private:
+            SeriesView xs;
+            size_t k;
+            int32_t b;
+            size_t q;
+    };
+
+    /**
+     * The transfer entropy from a permutation of `xs` to `ys`. The target's
+     * history and future do not change from one surrogate to the next, so
+     * they are encoded once up front along with the entropy of the history
+     * and predicate histograms.
+     */
+    class TransferEntropySurrogate {
+        public:
+            explicit TransferEntropySurrogate(TransferEntropy const &measure)
+                : xs(measure.xs), k(measure.k)
+                , b(std::max(series_base(measure.xs), series_base(measure.ys))) {
+                auto const &ys = measure.ys;
+                size_t q = 1;
+                for (size_t i = 0; i < k; ++i) {
+                    q *= b;
+                }
+                qb = q * b;
+
+                auto histories = Histogram(q), predicates_hist = Histogram(qb);
+                for (size_t i = 0; i < ys.trials(); ++i) {
+                    auto const trial = ys.data() + i * ys.steps();
+                    size_t history = 0;
+                    for (size_t j = 0; j < k; ++j) {
+                        history = history * b + trial[j];
+                    }
+                    for (size_t j = k; j < ys.steps(); ++j) {
+                        auto const predicate = history * b + trial[j];
+                        this->history.push_back(history);
+                        this->predicate.push_back(predicate);
+                        histories[history]++;
+                        predicates_hist[predicate]++;
+                        history = predicate - trial[j - k] * q;
+                    }
+                }
+                invariant = xlogx(histories.begin(), histories.end())
+                    - xlogx(predicates_hist.begin(), predicates_hist.end());
+            }
+
+            static auto fits(TransferEntropy const &measure) -> bool {
+                auto const b = static_cast<double>(std::max(series_base(measure.xs), series_base(measure.ys)));
+                auto const qb = std::pow(b, static_cast<double>(measure.k + 1));
+                return qb * b + qb <= max_arena;
+            }
+
+            auto series() const -> SeriesView const& { return xs; }
+            auto arena_size() const -> size_t { return qb * b + qb; }
+
+            auto evaluate(int32_t const *shuffled, Histogram &arena, inform_error *) const -> double {
+                std::fill(arena.begin(), arena.end(), 0);
+                auto const states = arena.begin();
+                auto const sources = states + qb * b;
+
+                auto const m = xs.steps();
+                for (size_t i = 0, t = 0; i < xs.trials(); ++i) {
+                    auto const trial = shuffled + i * m + k - 1;
+                    for (size_t j = 0; j < m - k; ++j, ++t) {
+                        auto const src = static_cast<size_t>(trial[j]);
+                        states[predicate[t] * b + src]++;
+                        sources[history[t] * b + src]++;
+                    }
+                }
+
+                auto const N = static_cast<double>(history.size());
+                return (invariant + xlogx(states, sources) - xlogx(sources, arena.end())) / N;
+            }
+
+        private:
+            SeriesView xs;
+            size_t k;
+            int32_t b;
+            size_t qb;
+            std::vector<size_t> history, predicate;
+            double invariant;
+    };
+
+    /**
+     * The series of a measure which is permuted to form its surrogates, and
+     * the measure with that series replaced.
+     */
+    static auto permuted(MutualInfo const &measure) -> SeriesView const& { return measure.ys; }
+    static auto permuted(ActiveInfo const &measure) -> SeriesView const& { return measure.xs; }
+    static auto permuted(TransferEntropy const &measure) -> SeriesView const& { return measure.xs; }
+
+    static auto replace(MutualInfo measure, SeriesView const &series) -> MutualInfo {
+        measure.ys = series;
+        return measure;
+    }
+    static auto replace(ActiveInfo measure, SeriesView const &series) -> ActiveInfo {
+        measure.xs = series;
+        return measure;
+    }
+    static auto replace(TransferEntropy measure, SeriesView const &series) -> TransferEntropy {
+        measure.xs = series;
+        return measure;
+    }
+
+    /**
+     * A measure of a permutation of one of its series, computed by Inform
+     * from scratch. This is used when the histograms of a surrogate are too
+     * large to keep an arena of them per thread; Inform counts them in hash
+     * tables sized by the series instead.
+     */
+    template <typename Measure>
+    class InformSurrogate {
+        public:
+            explicit InformSurrogate(Measure const &measure)
+                : measure(measure), base(series_base(permuted(measure))) {}
+
+            auto series() const -> SeriesView const& { return permuted(measure); }
+            auto arena_size() const -> size_t { return 0; }
+
+            auto evaluate(int32_t const *shuffled, Histogram &, inform_error *err) const -> double {
+                auto const &original = series();
+                auto view = SeriesView(shuffled, original.size());
+                view.reshape(original.trials());
+                view.validate(base);
+                return replace(measure, view).compute(err);
+            }
+
+        private:
+            Measure measure;
+            int32_t base;
+    };
+
+    /**
+     * Count the surrogates whose value is at least as large as that of the
+     * original series. Each thread owns a single histogram arena and a single
+     * surrogate buffer which it reuses for every permutation it evaluates.
+     * If any surrogate fails to evaluate, every thread stops and the first
+     * error is reported.
+     */
+    template <typename Surrogate>
+    static auto count_extreme(Surrogate const &surrogate, size_t nperm, uint64_t seed, inform_error *err)
+        -> size_t {
+        auto const &series = surrogate.series();
+
+        auto observed_arena = Histogram(surrogate.arena_size());
+        auto const observed = surrogate.evaluate(series.data(), observed_arena, err);
+        if (*err) {
+            return 0;
+        }
+
+        auto const nchunks = (nperm + chunk_size - 1) / chunk_size;
+        auto streams = std::vector<Xoshiro256>();
+        auto rng = Xoshiro256(seed);
+        for (size_t i = 0; i < nchunks; ++i) {
+            streams.push_back(rng);
+            rng.jump();
+        }
+
+        std::atomic<size_t> next_chunk(0), count(0);
+        std::atomic<int> failure(INFORM_SUCCESS);
+        auto worker = [&]() {
+            auto arena = Histogram(surrogate.arena_size());
+            auto shuffled = Series(series.size());
+            size_t local_count = 0;
+            for (auto chunk = next_chunk++; chunk < nchunks && !failure; chunk = next_chunk++) {
+                std::copy(series.begin(), series.end(), shuffled.begin());
+                auto stream = streams[chunk];
+                auto const last = std::min(nperm, (chunk + 1) * chunk_size);
+                for (auto i = chunk * chunk_size; i < last; ++i) {
+                    inform_error local_err = INFORM_SUCCESS;
+                    shuffle(shuffled.data(), shuffled.size(), stream);
+                    auto const value = surrogate.evaluate(shuffled.data(), arena, &local_err);
+                    if (local_err) {
+                        auto expected = static_cast<int>(INFORM_SUCCESS);
+                        failure.compare_exchange_strong(expected, local_err);
+                        return;
+                    } else if (value >= observed - tolerance) {
+                        ++local_count;
+                    }
+                }
+            }
+            count += local_count;
+        };
+
+        run_workers(nchunks, worker);
+
+        if (failure) {
+            INFORM_ERROR_RETURN(err, static_cast<inform_error>(failure.load()), 0);
+        }
+        return count;
+    }
+
+    template <typename Measure, typename Surrogate>
+    static auto run(Arguments const &measure_args, size_t nperm, uint64_t seed) -> MaybeLocal<Object> {
+        auto isolate = measure_args.GetIsolate();
+        auto context = isolate->GetCurrentContext();
+
+        auto const maybe_measure = Measure::parse(measure_args);
+        if (maybe_measure.IsNothing()) {
+            return MaybeLocal<Object>();
+        }
+        auto const &measure = maybe_measure.FromJust();
+
+        inform_error err = INFORM_SUCCESS;
+        auto const value = measure.compute(&err);
+        if (err) {
+            throws(isolate, Exception::Error, inform_strerror(&err));
+            return MaybeLocal<Object>();
+        }
+
+        size_t count = 1;
+        try {
+            count += Surrogate::fits(measure)
+                ? count_extreme(Surrogate(measure), nperm, seed, &err)
+                : count_extreme(InformSurrogate<Measure>(measure), nperm, seed, &err);
+        } catch (std::bad_alloc const &) {
+            err = INFORM_ENOMEM;
+        }
+        if (err) {
+            throws(isolate, Exception::Error, inform_strerror(&err));
+            return MaybeLocal<Object>();
+        }
+        auto const p = static_cast<double>(count) / (nperm + 1);
+        auto const se = std::sqrt((p * (1 - p)) / (nperm + 1));
+
+        auto result = Object::New(isolate);
+        result->Set(context, String::NewFromUtf8(isolate, "value", NewStringType::kNormal).ToLocalChecked(),
+            Number::New(isolate, value)).FromJust();
+        result->Set(context, String::NewFromUtf8(isolate, "p", NewStringType::kNormal).ToLocalChecked(),
+            Number::New(isolate, p)).FromJust();
+        result->Set(context, String::NewFromUtf8(isolate, "se", NewStringType::kNormal).ToLocalChecked(),
+            Number::New(isolate, se)).FromJust();
+
+        return result;
+    }
+}
+
+auto inform::permutation_test(FunctionCallbackInfo<Value> const& args) -> void {
+    auto isolate = args.GetIsolate();
+
+    if (args.Length() != 4) {
+        return inform::throws(isolate, Exception::TypeError, "four arguments are required");
+    }
+
+    if (!args[0]->IsString()) {
+        return inform::throws(isolate, Exception::TypeError, "measure is not a string");
+    }
+    auto const measure = std::string(*String::Utf8Value(isolate, args[0]));
+
+    if (!args[1]->IsArray()) {
+        return inform::throws(isolate, Exception::TypeError, "measure arguments are not an array");
+    }
+    auto const measure_args = Arguments(isolate, args[1].As<Array>());
+
+    auto const maybe_nperm = inform::get_number<Number, double>(args[2]);
+    if (maybe_nperm.IsNothing() || maybe_nperm.FromJust() < 10) {
+        return inform::throws(isolate, Exception::TypeError, "too few permutations");
+    }
+    auto const nperm = static_cast<size_t>(maybe_nperm.FromJust());
+
+    auto const maybe_seed = inform::get_number<Number, double>(args[3]);
+    if (maybe_seed.IsNothing() || maybe_seed.FromJust() < 0) {
+        return inform::throws(isolate, Exception::TypeError, "seed is not an unsigned integer");
+    }
+    auto const seed = static_cast<uint64_t>(maybe_seed.FromJust());
+
+    auto result = MaybeLocal<Object>();
+    if (measure == "mutualInfo") {
+        result = run<MutualInfo, MutualInfoSurrogate>(measure_args, nperm, seed);
+    } else if (measure == "activeInfo") {
+        result = run<ActiveInfo, ActiveInfoSurrogate>(measure_args, nperm, seed);
+    } else if (measure == "transferEntropy") {
+        result = run<TransferEntropy, TransferEntropySurrogate>(measure_args, nperm, seed);
+    } else {
+        return inform::throws(isolate, Exception::TypeError, "unsupported measure \"" + measure + "\"");
+    }
+
+    if (!result.IsEmpty()) {
+        args.GetReturnValue().Set(result.ToLocalChecked());
+    }
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "./series.h"
+
+namespace inform {
+    using namespace v8;
+
+    auto permutation_test(v8::FunctionCallbackInfo<v8::Value> const& args) -> void;
+}
@@ -1,11 +1,21 @@
 #include "./util.h"
+#include "./handle.h"
+
+#include <inform/utilities/binning.h>
 
 namespace inform {
     using namespace v8;
 
-    auto get_vector(Isolate *isolate, Local<Value> const &arg) -> Maybe<Series> {
+    static auto is_series(Isolate *isolate, Local<Value> const &arg) -> bool {
+        return arg->IsArray() || arg->IsInt32Array() || arg->IsArrayBuffer()
+            || SeriesHandle::unwrap(isolate, arg) != nullptr;
+    }
+
+    static auto get_flat_series(Isolate *isolate, Local<Value> const &arg) -> Maybe<SeriesView> {
         auto context = isolate->GetCurrentContext();
-        if (arg->IsArray()) {
+        if (auto const handle = SeriesHandle::unwrap(isolate, arg)) {
+            return Just(*handle);
+        } else if (arg->IsArray()) {
             auto const array = arg.As<Array>();
             auto const len = array->Length();
             auto series = Series(len);
@@ -17,32 +27,208 @@ namespace inform {
                 } else {
                     throws(isolate, Exception::TypeError,
                         "element of time series is not an integer");
-                    return Nothing<Series>();
+                    return Nothing<SeriesView>();
                 }
             }
-            return Just(series);
+            return Just(SeriesView(std::move(series)));
         } else if (arg->IsInt32Array()) {
             auto const array = arg.As<Int32Array>();
-            auto const len = array->Length();
-            auto series = Series(len);
-            array->CopyContents(series.data(), sizeof(int32_t)*len);
-            return Just(series);
+            auto const base = static_cast<char const*>(array->Buffer()->GetContents().Data());
+            auto const data = reinterpret_cast<int32_t const*>(base + array->ByteOffset());
+            return Just(SeriesView(data, array->Length()));
         } else if (arg->IsArrayBuffer()) {
             auto const array = arg.As<ArrayBuffer>();
 
             if (array->ByteLength() % sizeof(int32_t) != 0) {
                 throws(isolate, Exception::TypeError,
                     "array buffer length is inconsistent with 32-bit integer contents");
-                return Nothing<Series>();
+                return Nothing<SeriesView>();
             }
 
             auto const len = array->ByteLength() / sizeof(int32_t);
-            auto const data = static_cast<int32_t*>(array->GetContents().Data());
-            auto series = Series(data, data+len);
-
-            return Just(series);
+            auto const data = static_cast<int32_t const*>(array->GetContents().Data());
+            return Just(SeriesView(data, len));
         }
         throws(isolate, Exception::TypeError, "time series is not an array");
-        return Nothing<Series>();
+        return Nothing<SeriesView>();
+    }
+
+    // An array of series, one per trial, is copied into a single buffer so
+    // that Inform can pool the trials in one call.
+    static auto get_trial_list(Isolate *isolate, Local<Array> const &list) -> Maybe<SeriesView> {
+        auto context = isolate->GetCurrentContext();
+        auto const trials = list->Length();
+        auto series = Series();
+
+        for (uint32_t i = 0; i < trials; ++i) {
+            auto const maybe_trial = get_flat_series(isolate, list->Get(context, i).ToLocalChecked());
+            if (maybe_trial.IsNothing()) {
+                return Nothing<SeriesView>();
+            }
+            auto const trial = maybe_trial.FromJust();
+            if (i == 0) {
+                series.reserve(trials * trial.size());
+            } else if (trial.size() != series.size() / i) {
+                throws(isolate, Exception::TypeError, "trials have different lengths");
+                return Nothing<SeriesView>();
+            }
+            series.insert(series.end(), trial.begin(), trial.end());
+        }
+        return Just(SeriesView(std::move(series), trials));
+    }
+
+    // The number of trials of a shaped series, checked against its length
+    // and its number of steps.
+    static auto get_shape(Isolate *isolate, Local<Value> const &trials, Local<Value> const &steps,
+        size_t size) -> Maybe<size_t> {
+        auto const maybe_trials = get_number<Integer, size_t>(trials);
+        if (maybe_trials.IsNothing()) {
+            throws(isolate, Exception::TypeError, "number of trials is not an unsigned integer");
+            return Nothing<size_t>();
+        }
+
+        auto const maybe_steps = get_number<Integer, size_t>(steps);
+        if (maybe_steps.IsNothing()) {
+            throws(isolate, Exception::TypeError, "number of steps is not an unsigned integer");
+            return Nothing<size_t>();
+        }
+
+        if (maybe_trials.FromJust() * maybe_steps.FromJust() != size) {
+            throws(isolate, Exception::TypeError,
+                "time series length is inconsistent with the number of trials and steps");
+            return Nothing<size_t>();
+        }
+        return maybe_trials;
+    }
+
+    static auto get_bounds(Isolate *isolate, Local<Value> const &arg) -> Maybe<std::vector<double>> {
+        auto context = isolate->GetCurrentContext();
+        if (arg->IsFloat64Array()) {
+            auto const array = arg.As<Float64Array>();
+            auto const base = static_cast<char const*>(array->Buffer()->GetContents().Data());
+            auto const data = reinterpret_cast<double const*>(base + array->ByteOffset());
+            return Just(std::vector<double>(data, data + array->Length()));
+        } else if (arg->IsArray()) {
+            auto const array = arg.As<Array>();
+            auto bounds = std::vector<double>(array->Length());
+            for (size_t i = 0; i < bounds.size(); ++i) {
+                auto const datum = array->Get(context, i).ToLocalChecked();
+                if (!datum->IsNumber()) {
+                    throws(isolate, Exception::TypeError, "bin boundary is not a number");
+                    return Nothing<std::vector<double>>();
+                }
+                bounds[i] = datum.As<Number>()->Value();
+            }
+            return Just(std::move(bounds));
+        }
+        throws(isolate, Exception::TypeError, "bin boundaries are not an array");
+        return Nothing<std::vector<double>>();
+    }
+
+    // A continuous series together with how to bin it, `{ data, bins }`,
+    // `{ data, step }` or `{ data, bounds }`, and optionally its shape. Inform
+    // bins the data straight into the storage of the view, which is then
+    // known to be non-negative with the base of the binning.
+    template <typename Field>
+    static auto get_binned_series(Isolate *isolate, Local<Float64Array> const &array, Field const &field)
+        -> Maybe<SeriesView> {
+        auto const base = static_cast<char const*>(array->Buffer()->GetContents().Data());
+        auto const data = reinterpret_cast<double const*>(base + array->ByteOffset());
+        auto const n = array->Length();
+
+        auto trials = size_t{1};
+        auto const trials_field = field("trials"), steps_field = field("steps");
+        if (!trials_field->IsUndefined() || !steps_field->IsUndefined()) {
+            auto const maybe_trials = get_shape(isolate, trials_field, steps_field, n);
+            if (maybe_trials.IsNothing()) {
+                return Nothing<SeriesView>();
+            }
+            trials = maybe_trials.FromJust();
+        }
+
+        auto const bins = field("bins"), step = field("step"), bounds = field("bounds");
+        if (bins->IsUndefined() + step->IsUndefined() + bounds->IsUndefined() != 2) {
+            throws(isolate, Exception::TypeError, "exactly one of bins, step or bounds is required");
+            return Nothing<SeriesView>();
+        }
+
+        auto series = Series(n);
+        auto b = 0;
+        inform_error err = INFORM_SUCCESS;
+        if (!bins->IsUndefined()) {
+            auto const maybe_bins = get_number<Integer, int>(bins);
+            if (maybe_bins.IsNothing()) {
+                throws(isolate, Exception::TypeError, "number of bins is not an integer");
+                return Nothing<SeriesView>();
+            }
+            b = maybe_bins.FromJust();
+            inform_bin(data, n, b, series.data(), &err);
+        } else if (!step->IsUndefined()) {
+            auto const maybe_step = get_number<Number, double>(step);
+            if (maybe_step.IsNothing()) {
+                throws(isolate, Exception::TypeError, "bin width is not a number");
+                return Nothing<SeriesView>();
+            }
+            b = inform_bin_step(data, n, maybe_step.FromJust(), series.data(), &err);
+        } else {
+            auto const maybe_bounds = get_bounds(isolate, bounds);
+            if (maybe_bounds.IsNothing()) {
+                return Nothing<SeriesView>();
+            }
+            auto const &edges = maybe_bounds.FromJust();
+            b = inform_bin_bounds(data, n, edges.data(), edges.size(), series.data(), &err);
+        }
+        if (inform_failed(&err)) {
+            throws(isolate, Exception::Error, inform_strerror(&err));
+            return Nothing<SeriesView>();
+        }
+
+        auto view = SeriesView(std::move(series), trials);
+        view.validate(std::max(2, b));
+        return Just(view);
+    }
+
+    // A flat series together with its shape, `{ data, trials, steps }`. The
+    // data is borrowed exactly as a flat series would be.
+    static auto get_shaped_series(Isolate *isolate, Local<Object> const &shape) -> Maybe<SeriesView> {
+        auto context = isolate->GetCurrentContext();
+        auto const field = [&](char const *name) {
+            auto const key = String::NewFromUtf8(isolate, name, NewStringType::kNormal).ToLocalChecked();
+            return shape->Get(context, key).ToLocalChecked();
+        };
+
+        auto const data_field = field("data");
+        if (data_field->IsFloat64Array()) {
+            return get_binned_series(isolate, data_field.As<Float64Array>(), field);
+        }
+
+        auto const maybe_data = get_flat_series(isolate, data_field);
+        if (maybe_data.IsNothing()) {
+            return Nothing<SeriesView>();
+        }
+
+        auto data = maybe_data.FromJust();
+        auto const maybe_trials = get_shape(isolate, field("trials"), field("steps"), data.size());
+        if (maybe_trials.IsNothing()) {
+            return Nothing<SeriesView>();
+        }
+
+        data.reshape(maybe_trials.FromJust());
+        return Just(data);
+    }
+
+    auto get_series(Isolate *isolate, Local<Value> const &arg) -> Maybe<SeriesView> {
+        auto context = isolate->GetCurrentContext();
+        if (arg->IsArray()) {
+            auto const array = arg.As<Array>();
+            if (array->Length() != 0 && is_series(isolate, array->Get(context, 0).ToLocalChecked())) {
+                return get_trial_list(isolate, array);
+            }
+        } else if (auto const handle = SeriesHandle::unwrap(isolate, arg)) {
+            return Just(*handle);
+        } else if (arg->IsObject() && !is_series(isolate, arg) && !arg->IsTypedArray()) {
+            return get_shaped_series(isolate, arg.As<Object>());
+        }
+        return get_flat_series(isolate, arg);
     }
 }
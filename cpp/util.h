@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <memory>
 #include <node.h>
 #include <numeric>
 #include <v8.h>
@@ -11,17 +12,123 @@ namespace inform {
 
     using Series = std::vector<int32_t>;
 
+    /**
+     * A read-only view of a time series.
+     *
+     * Typed arrays and array buffers already hold contiguous 32-bit integers,
+     * so their backing stores are borrowed rather than copied. Plain arrays
+     * have to be converted element-by-element, and so the view shares
+     * ownership of the resulting storage; copying a view never copies the
+     * series. A borrowed view is only valid for as long as the JavaScript
+     * object it was created from; call `own` to take a copy before using the
+     * view outside of the current call.
+     *
+     * A view may hold several trials, i.e. independent realizations of the
+     * same process, laid out one after the other. Each trial has
+     * `steps()` time steps, and `size()` is the total over all trials.
+     *
+     * A view of a `SeriesHandle` is known to be non-negative and to have
+     * the base recorded by the handle, so it need not be scanned again.
+     */
+    class SeriesView {
+        public:
+            SeriesView() = default;
+            explicit SeriesView(Series series, size_t trials = 1)
+                : storage(std::make_shared<Series const>(std::move(series)))
+                , length(storage->size()), ntrials(trials) {}
+            SeriesView(int32_t const *data, size_t size) : borrowed(data), length(size) {}
+
+            auto data() const -> int32_t const* {
+                if (borrowed) {
+                    return borrowed;
+                }
+                return storage ? storage->data() : nullptr;
+            }
+            auto size() const -> size_t { return length; }
+            auto trials() const -> size_t { return ntrials; }
+            auto steps() const -> size_t { return ntrials == 0 ? 0 : length / ntrials; }
+            auto begin() const -> int32_t const* { return data(); }
+            auto end() const -> int32_t const* { return data() + length; }
+
+            auto reshape(size_t trials) -> void {
+                ntrials = trials;
+            }
+
+            auto validate(int32_t base) -> void {
+                known_base = base;
+            }
+            auto validated() const -> bool { return known_base != 0; }
+            auto base() const -> int32_t { return known_base; }
+
+            auto own() -> void {
+                if (borrowed) {
+                    storage = std::make_shared<Series const>(borrowed, borrowed + length);
+                    borrowed = nullptr;
+                }
+            }
+
+        private:
+            std::shared_ptr<Series const> storage;
+            int32_t const *borrowed = nullptr;
+            size_t length = 0;
+            size_t ntrials = 1;
+            int32_t known_base = 0;
+    };
+
+    /**
+     * The arguments of a JavaScript call. These come either directly from a
+     * function callback or from an array of arguments forwarded by another
+     * export, e.g. `permutationTest`.
+     */
+    class Arguments {
+        public:
+            Arguments(FunctionCallbackInfo<Value> const &info) : isolate(info.GetIsolate()) {
+                for (auto i = 0; i < info.Length(); ++i) {
+                    values.push_back(info[i]);
+                }
+            }
+
+            Arguments(Isolate *isolate, Local<Array> const &array) : isolate(isolate) {
+                auto context = isolate->GetCurrentContext();
+                for (uint32_t i = 0; i < array->Length(); ++i) {
+                    values.push_back(array->Get(context, i).ToLocalChecked());
+                }
+            }
+
+            auto GetIsolate() const -> Isolate* { return isolate; }
+            auto Length() const -> int { return static_cast<int>(values.size()); }
+            auto operator[](int i) const -> Local<Value> {
+                if (i < 0 || i >= Length()) {
+                    return Undefined(isolate);
+                }
+                return values[i];
+            }
+
+        private:
+            Isolate *isolate;
+            std::vector<Local<Value>> values;
+    };
+
     template <typename Iterator, typename Type = typename std::iterator_traits<Iterator>::value_type>
     auto series_base(Iterator start, Iterator stop) -> Type {
         return std::accumulate(start, stop, Type{2},
             [](Type x, Type y) { return std::max(x, y + 1); });
     }
 
-    template <typename Container, typename Type = typename Container::value_type>
-    auto series_base(Container series) -> Type {
+    template <typename Container>
+    auto series_base(Container const &series) -> int32_t {
         return series_base(series.begin(), series.end());
     }
 
+    inline auto series_base(SeriesView const &series) -> int32_t {
+        return series.validated() ? series.base() : series_base(series.begin(), series.end());
+    }
+
+    inline auto has_negative_state(SeriesView const &series) -> bool {
+        return !series.validated() &&
+            std::any_of(series.begin(), series.end(), [](int32_t x) { return x < 0; });
+    }
+
     template <typename ExceptionType>
     auto throws(Isolate *isolate, ExceptionType type, std::string message) -> void {
         auto msg = String::NewFromUtf8(isolate, message.data(), NewStringType::kNormal);
@@ -36,5 +143,5 @@ namespace inform {
         return Nothing<CType>();
     }
 
-    auto get_vector(Isolate *isolate, Local<Value> const &arg) -> Maybe<Series>;
+    auto get_series(Isolate *isolate, Local<Value> const &arg) -> Maybe<SeriesView>;
 }
@@ -0,0 +1,475 @@
+#include "./window.h"
+#include "./histogram.h"
+#include "./measure.h"
+
+#include <limits>
+#include <new>
+
+using namespace v8;
+
+namespace inform {
+    static auto get_window(Isolate *isolate, Local<Value> const &width, Local<Value> const &step,
+        SeriesView const &xs) -> Maybe<Window> {
+        auto const maybe_width = get_number<Integer, size_t>(width);
+        if (maybe_width.IsNothing()) {
+            throws(isolate, Exception::TypeError, "window length is not an unsigned integer");
+            return Nothing<Window>();
+        }
+
+        auto const maybe_step = get_number<Integer, size_t>(step);
+        if (maybe_step.IsNothing() || maybe_step.FromJust() == 0) {
+            throws(isolate, Exception::TypeError, "window step is not a positive integer");
+            return Nothing<Window>();
+        }
+
+        if (maybe_width.FromJust() > xs.steps()) {
+            throws(isolate, Exception::TypeError, "window is longer than the time series");
+            return Nothing<Window>();
+        }
+
+        return Just(Window{ maybe_width.FromJust(), maybe_step.FromJust() });
+    }
+
+    static auto check_window(SeriesView const &xs, size_t min_width, size_t width, inform_error *err) -> bool {
+        if (xs.size() == 0) {
+            INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+        } else if (width < min_width) {
+            INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, true);
+        } else if (has_negative_state(xs)) {
+            INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
+        }
+        return false;
+    }
+
+    static auto check_history(size_t k, size_t width, inform_error *err) -> bool {
+        if (k == 0) {
+            INFORM_ERROR_RETURN(err, INFORM_EKZERO, true);
+        } else if (width <= k) {
+            INFORM_ERROR_RETURN(err, INFORM_EKLONG, true);
+        }
+        return false;
+    }
+
+    /**
+     * `b^k`, or zero if it does not fit in 64 bits.
+     */
+    static auto power(uint64_t b, size_t k) -> uint64_t {
+        uint64_t q = 1;
+        for (size_t i = 0; i < k; ++i) {
+            if (q > std::numeric_limits<uint64_t>::max() / b) {
+                return 0;
+            }
+            q *= b;
+        }
+        return q;
+    }
+
+    /**
+     * The bin of each observation in one histogram. Observations are binned
+     * by their code when the histogram's `support` has at most `max_dense`
+     * codes; otherwise the codes of the `n` observations, as given by
+     * `code(t)`, are compacted up front so the histogram only spans those
+     * which occur.
+     */
+    class Bins {
+        public:
+            template <typename Code>
+            Bins(uint64_t support, size_t n, Code code) : dense(support <= max_dense), bins(support) {
+                if (!dense) {
+                    auto codes = std::vector<uint64_t>(n);
+                    for (size_t t = 0; t < n; ++t) {
+                        codes[t] = code(t);
+                    }
+                    bins = compact(codes, support, ids);
+                }
+            }
+
+            auto operator()(size_t t, uint64_t code) const -> size_t {
+                return dense ? code : ids[t];
+            }
+
+            auto size() const -> size_t { return bins; }
+
+        private:
+            bool dense;
+            size_t bins;
+            std::vector<uint32_t> ids;
+    };
+
+    /**
+     * The length-`k` history preceding each time step of each trial, encoded
+     * once for the whole series. Time steps before the first full history
+     * are left as zero.
+     */
+    static auto encode_histories(SeriesView const &xs, uint64_t b, size_t k) -> std::vector<uint64_t> {
+        auto const m = xs.steps();
+        auto const q = power(b, k);
+        auto codes = std::vector<uint64_t>(xs.size());
+
+        for (size_t i = 0; i < xs.trials(); ++i) {
+            auto const trial = xs.data() + i * m;
+            uint64_t history = 0;
+            for (size_t j = 0; j < k; ++j) {
+                history = history * b + trial[j];
+            }
+            for (size_t j = k; j < m; ++j) {
+                codes[i * m + j] = history;
+                history = history * b + trial[j] - trial[j - k] * q;
+            }
+        }
+        return codes;
+    }
+
+    /**
+     * Slide the window along the series. The observations in the window
+     * starting at time step `s` are those at time steps `[s + first,
+     * s + width)`. Moving from one window to the next removes the
+     * observations that fall out of it and adds those that come into it,
+     * so each step costs `O(step)` rather than `O(width)`.
+     */
+    template <typename Estimator>
+    static auto slide(Estimator &estimator, size_t first, Window const &window, size_t count,
+        double *values) -> void {
+        if (count == 0) {
+            return;
+        }
+
+        for (auto j = first; j < window.width; ++j) {
+            estimator.template update<&Estimator::Histogram::add>(j);
+        }
+        values[0] = estimator.value();
+
+        for (size_t w = 1; w < count; ++w) {
+            auto const prev = (w - 1) * window.step, next = w * window.step;
+            for (auto j = prev + first; j < std::min(prev + window.width, next + first); ++j) {
+                estimator.template update<&Estimator::Histogram::remove>(j);
+            }
+            for (auto j = std::max(prev + window.width, next + first); j < next + window.width; ++j) {
+                estimator.template update<&Estimator::Histogram::add>(j);
+            }
+            values[w] = estimator.value();
+        }
+    }
+
+    template <typename Count>
+    class MutualInfoEstimator {
+        public:
+            using Histogram = RunningHistogram<Count>;
+
+            MutualInfoEstimator(SeriesView const &xs, SeriesView const &ys, size_t width)
+                : xs(xs), ys(ys), bx(series_base(xs)), by(series_base(ys))
+                , N(static_cast<double>(xs.trials() * width)), table(xs.trials() * width)
+                , joint_bins(bx * by, xs.size(), [&](size_t t) { return code(t); })
+                , x_bins(bx, xs.size(), [&](size_t t) { return xs.data()[t]; })
+                , y_bins(by, ys.size(), [&](size_t t) { return ys.data()[t]; })
+                , joint(joint_bins.size(), table), x(x_bins.size(), table), y(y_bins.size(), table) {}
+
+            template <void (Histogram::*Update)(size_t)>
+            auto update(size_t j) -> void {
+                for (size_t i = 0; i < xs.trials(); ++i) {
+                    auto const t = i * xs.steps() + j;
+                    (joint.*Update)(joint_bins(t, code(t)));
+                    (x.*Update)(x_bins(t, xs.data()[t]));
+                    (y.*Update)(y_bins(t, ys.data()[t]));
+                }
+            }
+
+            auto value() const -> double {
+                return (joint.xlogx() - x.xlogx() - y.xlogx()) / N + std::log2(N);
+            }
+
+        private:
+            auto code(size_t t) const -> uint64_t {
+                return static_cast<uint64_t>(xs.data()[t]) * by + ys.data()[t];
+            }
+
+            SeriesView const &xs, &ys;
+            uint64_t bx, by;
+            double N;
+            XLogXTable table;
+            Bins joint_bins, x_bins, y_bins;
+            Histogram joint, x, y;
+    };
+
+    template <typename Count>
+    class ActiveInfoEstimator {
+        public:
+            using Histogram = RunningHistogram<Count>;
+
+            ActiveInfoEstimator(SeriesView const &xs, size_t k, size_t width)
+                : xs(xs), b(series_base(xs)), codes(encode_histories(xs, b, k))
+                , N(static_cast<double>(xs.trials() * (width - k))), table(xs.trials() * (width - k))
+                , state_bins(power(b, k + 1), xs.size(), [&](size_t t) { return state(t); })
+                , history_bins(power(b, k), xs.size(), [&](size_t t) { return codes[t]; })
+                , future_bins(b, xs.size(), [&](size_t t) { return xs.data()[t]; })
+                , states(state_bins.size(), table), histories(history_bins.size(), table)
+                , futures(future_bins.size(), table) {}
+
+            template <void (Histogram::*Update)(size_t)>
+            auto update(size_t j) -> void {
+                for (size_t i = 0; i < xs.trials(); ++i) {
+                    auto const t = i * xs.steps() + j;
+                    (states.*Update)(state_bins(t, state(t)));
+                    (histories.*Update)(history_bins(t, codes[t]));
+                    (futures.*Update)(future_bins(t, xs.data()[t]));
+                }
+            }
+
+            auto value() const -> double {
+                return (states.xlogx() - histories.xlogx() - futures.xlogx()) / N + std::log2(N);
+            }
+
+        private:
+            auto state(size_t t) const -> uint64_t {
+                return codes[t] * b + xs.data()[t];
+            }
+
+            SeriesView const &xs;
+            uint64_t b;
+            std::vector<uint64_t> codes;
+            double N;
+            XLogXTable table;
+            Bins state_bins, history_bins, future_bins;
+            Histogram states, histories, futures;
+    };
+
+    template <typename Count>
+    class TransferEntropyEstimator {
+        public:
+            using Histogram = RunningHistogram<Count>;
+
+            TransferEntropyEstimator(SeriesView const &xs, SeriesView const &ys, size_t k, size_t width)
+                : xs(xs), ys(ys), k(k), b(std::max(series_base(xs), series_base(ys)))
+                , codes(encode_histories(ys, b, k))
+                , N(static_cast<double>(xs.trials() * (width - k))), table(xs.trials() * (width - k))
+                , state_bins(power(b, k + 2), xs.size(), [&](size_t t) { return predicate(t) * b + source(t); })
+                , history_bins(power(b, k), xs.size(), [&](size_t t) { return codes[t]; })
+                , source_bins(power(b, k + 1), xs.size(), [&](size_t t) { return codes[t] * b + source(t); })
+                , predicate_bins(power(b, k + 1), xs.size(), [&](size_t t) { return predicate(t); })
+                , states(state_bins.size(), table), histories(history_bins.size(), table)
+                , sources(source_bins.size(), table), predicates(predicate_bins.size(), table) {}
+
+            template <void (Histogram::*Update)(size_t)>
+            auto update(size_t j) -> void {
+                for (size_t i = 0; i < xs.trials(); ++i) {
+                    auto const t = i * xs.steps() + j;
+                    auto const history = codes[t];
+                    auto const src = source(t);
+                    auto const pred = predicate(t);
+                    (states.*Update)(state_bins(t, pred * b + src));
+                    (histories.*Update)(history_bins(t, history));
+                    (sources.*Update)(source_bins(t, history * b + src));
+                    (predicates.*Update)(predicate_bins(t, pred));
+                }
+            }
+
+            auto value() const -> double {
+                return (states.xlogx() + histories.xlogx() - sources.xlogx() - predicates.xlogx()) / N;
+            }
+
+        private:
+            // The source state preceding time step `t`, or zero at the start
+            // of a trial, where there is no full history anyway.
+            auto source(size_t t) const -> uint64_t {
+                return t % xs.steps() < k ? 0 : xs.data()[t - 1];
+            }
+
+            auto predicate(size_t t) const -> uint64_t {
+                return codes[t] * b + ys.data()[t];
+            }
+
+            SeriesView const &xs, &ys;
+            size_t k;
+            uint64_t b;
+            std::vector<uint64_t> codes;
+            double N;
+            XLogXTable table;
+            Bins state_bins, history_bins, source_bins, predicate_bins;
+            Histogram states, histories, sources, predicates;
+    };
+
+    /**
+     * Slide a window along the series with an `Estimator<Count>`, where the
+     * counters are 16 bits wide if no count can exceed `observations` (the
+     * observations in one window) and 32 bits wide otherwise.
+     */
+    template <template <typename> class Estimator, typename... Args>
+    static auto slide_counts(size_t observations, size_t first, Window const &window, size_t count,
+        double *values, Args const&... args) -> void {
+        if (observations <= std::numeric_limits<uint16_t>::max()) {
+            auto estimator = Estimator<uint16_t>(args...);
+            slide(estimator, first, window, count, values);
+        } else {
+            auto estimator = Estimator<uint32_t>(args...);
+            slide(estimator, first, window, count, values);
+        }
+    }
+}
+
+auto inform::MutualInfoWindows::parse(Arguments const& args) -> Maybe<MutualInfoWindows> {
+    auto isolate = args.GetIsolate();
+
+    if (args.Length() < 4) {
+        inform::throws(isolate, Exception::TypeError, "four arguments are required");
+        return Nothing<MutualInfoWindows>();
+    }
+
+    auto const maybe_xs = inform::get_series(isolate, args[0]);
+    if (maybe_xs.IsNothing()) {
+        return Nothing<MutualInfoWindows>();
+    }
+
+    auto const maybe_ys = inform::get_series(isolate, args[1]);
+    if (maybe_ys.IsNothing()) {
+        return Nothing<MutualInfoWindows>();
+    }
+
+    auto const xs = maybe_xs.FromJust();
+    auto const ys = maybe_ys.FromJust();
+
+    if (xs.size() != ys.size()) {
+        throws(isolate, Exception::TypeError, "time series have different lengths");
+        return Nothing<MutualInfoWindows>();
+    } else if (xs.trials() != ys.trials()) {
+        throws(isolate, Exception::TypeError, "time series have different numbers of trials");
+        return Nothing<MutualInfoWindows>();
+    }
+
+    auto const maybe_window = inform::get_window(isolate, args[2], args[3], xs);
+    if (maybe_window.IsNothing()) {
+        return Nothing<MutualInfoWindows>();
+    }
+
+    return Just(MutualInfoWindows{ xs, ys, maybe_window.FromJust() });
+}
+
+auto inform::MutualInfoWindows::compute(double *values, inform_error *err) const -> void {
+    if (check_window(xs, 1, window.width, err) || check_window(ys, 1, window.width, err)) {
+        return;
+    }
+
+    try {
+        slide_counts<MutualInfoEstimator>(xs.trials() * window.width, 0, window, output_size(), values,
+            xs, ys, window.width);
+    } catch (std::bad_alloc const &) {
+        INFORM_ERROR_RETURN_VOID(err, INFORM_ENOMEM);
+    }
+}
+
+auto inform::ActiveInfoWindows::parse(Arguments const& args) -> Maybe<ActiveInfoWindows> {
+    auto isolate = args.GetIsolate();
+
+    if (args.Length() < 4) {
+        inform::throws(isolate, Exception::TypeError, "four arguments are required");
+        return Nothing<ActiveInfoWindows>();
+    }
+
+    auto const maybe_xs = inform::get_series(isolate, args[0]);
+    if (maybe_xs.IsNothing()) {
+        return Nothing<ActiveInfoWindows>();
+    }
+
+    auto const maybe_k = inform::get_number<Integer, size_t>(args[1]);
+    if (maybe_k.IsNothing()) {
+        throws(isolate, Exception::TypeError, "history length is not an unsigned integer");
+        return Nothing<ActiveInfoWindows>();
+    }
+
+    auto const xs = maybe_xs.FromJust();
+    auto const maybe_window = inform::get_window(isolate, args[2], args[3], xs);
+    if (maybe_window.IsNothing()) {
+        return Nothing<ActiveInfoWindows>();
+    }
+
+    return Just(ActiveInfoWindows{ xs, maybe_k.FromJust(), maybe_window.FromJust() });
+}
+
+auto inform::ActiveInfoWindows::compute(double *values, inform_error *err) const -> void {
+    if (check_window(xs, 2, window.width, err) || check_history(k, window.width, err)) {
+        return;
+    }
+
+    if (power(series_base(xs), k + 1) == 0) {
+        INFORM_ERROR_RETURN_VOID(err, INFORM_EENCODE);
+    }
+
+    try {
+        slide_counts<ActiveInfoEstimator>(xs.trials() * (window.width - k), k, window, output_size(), values,
+            xs, k, window.width);
+    } catch (std::bad_alloc const &) {
+        INFORM_ERROR_RETURN_VOID(err, INFORM_ENOMEM);
+    }
+}
+
+auto inform::TransferEntropyWindows::parse(Arguments const& args) -> Maybe<TransferEntropyWindows> {
+    auto isolate = args.GetIsolate();
+
+    if (args.Length() < 5) {
+        inform::throws(isolate, Exception::TypeError, "five arguments are required");
+        return Nothing<TransferEntropyWindows>();
+    }
+
+    auto const maybe_xs = inform::get_series(isolate, args[0]);
+    if (maybe_xs.IsNothing()) {
+        return Nothing<TransferEntropyWindows>();
+    }
+
+    auto const maybe_ys = inform::get_series(isolate, args[1]);
+    if (maybe_ys.IsNothing()) {
+        return Nothing<TransferEntropyWindows>();
+    }
+
+    auto const maybe_k = inform::get_number<Integer, size_t>(args[2]);
+    if (maybe_k.IsNothing()) {
+        throws(isolate, Exception::TypeError, "history length is not an unsigned integer");
+        return Nothing<TransferEntropyWindows>();
+    }
+
+    auto const xs = maybe_xs.FromJust();
+    auto const ys = maybe_ys.FromJust();
+
+    if (xs.size() != ys.size()) {
+        throws(isolate, Exception::TypeError, "time series have different lengths");
+        return Nothing<TransferEntropyWindows>();
+    } else if (xs.trials() != ys.trials()) {
+        throws(isolate, Exception::TypeError, "time series have different numbers of trials");
+        return Nothing<TransferEntropyWindows>();
+    }
+
+    auto const maybe_window = inform::get_window(isolate, args[3], args[4], xs);
+    if (maybe_window.IsNothing()) {
+        return Nothing<TransferEntropyWindows>();
+    }
+
+    return Just(TransferEntropyWindows{ xs, ys, maybe_k.FromJust(), maybe_window.FromJust() });
+}
+
+auto inform::TransferEntropyWindows::compute(double *values, inform_error *err) const -> void {
+    if (check_window(xs, 2, window.width, err) || check_window(ys, 2, window.width, err)
+        || check_history(k, window.width, err)) {
+        return;
+    }
+
+    if (power(std::max(series_base(xs), series_base(ys)), k + 2) == 0) {
+        INFORM_ERROR_RETURN_VOID(err, INFORM_EENCODE);
+    }
+
+    try {
+        slide_counts<TransferEntropyEstimator>(xs.trials() * (window.width - k), k, window, output_size(), values,
+            xs, ys, k, window.width);
+    } catch (std::bad_alloc const &) {
+        INFORM_ERROR_RETURN_VOID(err, INFORM_ENOMEM);
+    }
+}
+
+auto inform::mutual_info_windows(FunctionCallbackInfo<Value> const& args) -> void {
+    inform::evaluate_array<MutualInfoWindows>(args);
+}
+
+auto inform::active_info_windows(FunctionCallbackInfo<Value> const& args) -> void {
+    inform::evaluate_array<ActiveInfoWindows>(args);
+}
+
+auto inform::transfer_entropy_windows(FunctionCallbackInfo<Value> const& args) -> void {
+    inform::evaluate_array<TransferEntropyWindows>(args);
+}
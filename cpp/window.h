@@ -0,0 +1,63 @@
+#pragma once
+
+#include "./util.h"
+
+#include <inform/error.h>
+
+namespace inform {
+    using namespace v8;
+
+    /**
+     * A sliding window of `width` time steps which advances by `step` time
+     * steps at a time. Windows never extend past the end of the series.
+     */
+    struct Window {
+        size_t width, step;
+
+        auto count(size_t steps) const -> size_t {
+            return width > steps ? 0 : (steps - width) / step + 1;
+        }
+    };
+
+    /**
+     * The mutual information between two time series over each window.
+     */
+    struct MutualInfoWindows {
+        SeriesView xs, ys;
+        Window window;
+
+        static auto parse(Arguments const&) -> Maybe<MutualInfoWindows>;
+        auto output_size() const -> size_t { return window.count(xs.steps()); }
+        auto compute(double *values, inform_error*) const -> void;
+    };
+
+    /**
+     * The active information of a time series over each window.
+     */
+    struct ActiveInfoWindows {
+        SeriesView xs;
+        size_t k;
+        Window window;
+
+        static auto parse(Arguments const&) -> Maybe<ActiveInfoWindows>;
+        auto output_size() const -> size_t { return window.count(xs.steps()); }
+        auto compute(double *values, inform_error*) const -> void;
+    };
+
+    /**
+     * The transfer entropy between two time series over each window.
+     */
+    struct TransferEntropyWindows {
+        SeriesView xs, ys;
+        size_t k;
+        Window window;
+
+        static auto parse(Arguments const&) -> Maybe<TransferEntropyWindows>;
+        auto output_size() const -> size_t { return window.count(xs.steps()); }
+        auto compute(double *values, inform_error*) const -> void;
+    };
+
+    auto mutual_info_windows(v8::FunctionCallbackInfo<v8::Value> const& args) -> void;
+    auto active_info_windows(v8::FunctionCallbackInfo<v8::Value> const& args) -> void;
+    auto transfer_entropy_windows(v8::FunctionCallbackInfo<v8::Value> const& args) -> void;
+}
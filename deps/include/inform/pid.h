@@ -28,11 +28,46 @@ typedef struct inform_pid_lattice
     size_t size;
 } inform_pid_lattice;
 
+/**
+ * Build the redundancy lattice of `l` responses, with every `imin` and `pi`
+ * zero, so that it can be reused by `inform_pid_into`.
+ *
+ * The lattice is allocated as a single block, which only
+ * `inform_pid_lattice_free` may free. Lattices of more than 6 responses are
+ * too large to build.
+ *
+ * @param[in] l   the number of responses
+ * @param[in] err an error code
+ * @return the lattice
+ */
+EXPORT inform_pid_lattice *inform_pid_lattice_alloc(size_t l,
+        inform_error *err);
+
 EXPORT void inform_pid_lattice_free(inform_pid_lattice *l);
 
 EXPORT inform_pid_lattice *inform_pid(int const *stimulus, int const *responses, size_t l,
         size_t n, int bs, int const *br, inform_error *err);
 
+/**
+ * Compute the partial information decomposition as `inform_pid` does, but
+ * into a lattice built by `inform_pid_lattice_alloc` for `l` responses, or
+ * returned by an earlier call, so that repeated decompositions do not build
+ * the lattice again. If `lattice` is `NULL`, one is allocated.
+ *
+ * @param[in] stimulus  the stimulus time series
+ * @param[in] responses the `l` response time series
+ * @param[in] l         the number of responses
+ * @param[in] n         the number of time steps
+ * @param[in] bs        the base of the stimulus
+ * @param[in] br        the base of each response
+ * @param[in,out] lattice the lattice to fill, or `NULL`
+ * @param[in] err       an error code
+ * @return the lattice, or `NULL` on error
+ */
+EXPORT inform_pid_lattice *inform_pid_into(int const *stimulus,
+        int const *responses, size_t l, size_t n, int bs, int const *br, inform_pid_lattice *lattice,
+        inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
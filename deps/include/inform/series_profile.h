@@ -0,0 +1,53 @@
+// Copyright 2016-2019 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/error.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * The measures of a single time series which depend only on its length-`k`
+ * blocks, as computed by `inform_series_profile`.
+ */
+typedef struct inform_series_profile
+{
+    /// the active information with history length `k`
+    double active_info;
+    /// the entropy rate with history length `k`
+    double entropy_rate;
+    /// the block entropy with block size `k`
+    double block_entropy;
+    /// the predictive information with history and future length `k`, or
+    /// `NAN` if the series are too short (`m <= 2k`)
+    double predictive_info;
+} inform_series_profile;
+
+/**
+ * Compute the active information, entropy rate, block entropy and predictive
+ * information of an ensemble of time series in a single pass.
+ *
+ * This is equivalent to, but much cheaper than, calling each of
+ * `inform_active_info`, `inform_entropy_rate`, `inform_block_entropy` and
+ * `inform_predictive_info` in turn: the series are validated once, and each
+ * length-`k` block is encoded once and counted into every histogram that
+ * needs it.
+ *
+ * @param[in] series  the ensemble of time series
+ * @param[in] n       the number of initial conditions
+ * @param[in] m       the number of time steps in each time series
+ * @param[in] b       the base or number of distinct states at each time step
+ * @param[in] k       the history length
+ * @param[out] err    an error structure
+ * @return the profile of the ensemble; every measure is `NAN` on error
+ */
+EXPORT inform_series_profile inform_profile_series(int const *series,
+    size_t n, size_t m, int b, size_t k, inform_error *err);
+
+#ifdef __cplusplus
+}
+#endif
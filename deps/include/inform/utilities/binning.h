@@ -4,6 +4,7 @@
 #pragma once
 
 #include <inform/error.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -52,6 +53,10 @@ EXPORT int inform_bin_step(double const *series, size_t n, double step,
 /**
  * Bin a continuously-valued timeseries into bins with specified boundaries.
  *
+ * Each value is placed in the bin of the first boundary which exceeds it,
+ * or in bin `m` if none do. Boundaries in ascending order are searched in
+ * logarithmic time; others are scanned.
+ *
  * @param[in] series  the timeseries
  * @param[in] n       the length of the timeseries
  * @param[in] bounds  desired bin boundaries
@@ -63,6 +68,74 @@ EXPORT int inform_bin_step(double const *series, size_t n, double step,
 EXPORT int inform_bin_bounds(double const *series, size_t n,
     double const *bounds, size_t m, int *binned, inform_error *err);
 
+/**
+ * Bin a continuously-valued timeseries into `b` bins of (roughly) equal
+ * frequency, each of which holds the values from one quantile of the series
+ * up to the next.
+ *
+ * The quantiles of a series no longer than 2^19 values are exact; those of
+ * a longer series are estimated with a quantile sketch, to within a relative
+ * 2^-7 of their values. Values tied across a quantile share a bin, so fewer
+ * than `b` bins may be used.
+ *
+ * @param[in] series  the timeseries
+ * @param[in] n       the length of the timeseries
+ * @param[in] b       the desired number of bins
+ * @param[out] binned the resulting binned timeseries
+ * @param[out] err    the error code
+ * @return the number of bins
+ */
+EXPORT int inform_bin_quantiles(double const *series, size_t n, int b,
+    int *binned, inform_error *err);
+
+/**
+ * A streaming sketch of the distribution of a continuously-valued series
+ *
+ * The sketch counts the values in buckets by their sign, exponent and leading
+ * 7 bits of mantissa, so its quantiles are within a relative 2^-7 of the
+ * true ones however many values are added, in a fixed 4 MiB.
+ */
+typedef struct inform_quantile_sketch inform_quantile_sketch;
+
+/**
+ * Allocate an empty quantile sketch.
+ *
+ * @param[out] err    the error code
+ * @return the sketch
+ */
+EXPORT inform_quantile_sketch *inform_quantile_sketch_alloc(inform_error *err);
+
+/**
+ * Free a quantile sketch.
+ *
+ * @param[in] sketch the sketch
+ */
+EXPORT void inform_quantile_sketch_free(inform_quantile_sketch *sketch);
+
+/**
+ * Add the values of (a chunk of) a timeseries to a quantile sketch.
+ *
+ * @param[in] sketch  the sketch
+ * @param[in] series  the timeseries
+ * @param[in] n       the length of the timeseries
+ * @param[out] err    the error code
+ */
+EXPORT void inform_quantile_sketch_add(inform_quantile_sketch *sketch,
+    double const *series, size_t n, inform_error *err);
+
+/**
+ * Estimate a quantile of the values added to a sketch, i.e. the value of rank
+ * `q * (N - 1)` of the `N` values. The least and greatest values are exact.
+ *
+ * @param[in] sketch  the sketch
+ * @param[in] q       the quantile, between 0 and 1
+ * @param[out] err    the error code
+ * @return the estimated value, or NaN (with `INFORM_ESHORTSERIES`) if no
+ *         values have been added
+ */
+EXPORT double inform_quantile_sketch_query(inform_quantile_sketch const *sketch,
+    double q, inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <inform/error.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -13,6 +14,11 @@ extern "C"
 /**
  * Coalesce a timeseries into as few states contiguous states as possible.
  *
+ * The states keep their order: the least state becomes 0, the next 1, and
+ * so on. This takes time linear in the length of the series when its
+ * states span a range comparable to its length, and otherwise sorts only
+ * the distinct states.
+ *
  * @param[in] series  the timeseries
  * @param[in] n       the length of the timeseries
  * @param[out] coal   the resulting coalesced timeseries
@@ -22,6 +28,81 @@ extern "C"
 EXPORT int inform_coalesce(int const *series, size_t n, int *coal,
     inform_error *err);
 
+/**
+ * Coalesce a timeseries of 64-bit states, e.g. as produced by
+ * `inform_black_box64`, into as few contiguous `int` states as possible.
+ *
+ * @param[in] series  the timeseries
+ * @param[in] n       the length of the timeseries
+ * @param[out] coal   the resulting coalesced timeseries
+ * @param[out] err    the error code
+ * @return the number of unique states
+ */
+EXPORT int inform_coalesce64(int64_t const *series, size_t n, int *coal,
+    inform_error *err);
+
+/**
+ * A coalescer of a series which arrives in chunks, which remembers the
+ * symbol given to each state across them.
+ */
+typedef struct inform_coalescer inform_coalescer;
+
+/**
+ * Allocate a coalescer which has not yet observed any states.
+ *
+ * @param[out] err    the error code
+ * @return the coalescer
+ */
+EXPORT inform_coalescer *inform_coalescer_alloc(inform_error *err);
+
+/**
+ * Free a coalescer.
+ *
+ * @param[in] coalescer the coalescer
+ */
+EXPORT void inform_coalescer_free(inform_coalescer *coalescer);
+
+/**
+ * Coalesce the next chunk of a timeseries, giving each state the symbol it
+ * was given in an earlier chunk, or else the next unused symbol.
+ *
+ * Unlike `inform_coalesce`, the symbols are given in the order in which the
+ * states are first observed, as a later chunk may introduce states which
+ * lie between those already observed.
+ *
+ * @param[in] coalescer the coalescer
+ * @param[in] series    the chunk of the timeseries
+ * @param[in] n         the length of the chunk
+ * @param[out] coal     the resulting coalesced chunk
+ * @param[out] err      the error code
+ * @return the number of unique states observed so far
+ */
+EXPORT int inform_coalescer_push(inform_coalescer *coalescer,
+    int const *series, size_t n, int *coal, inform_error *err);
+
+/**
+ * Coalesce the next chunk of a timeseries of 64-bit states, as
+ * `inform_coalescer_push` does.
+ *
+ * @param[in] coalescer the coalescer
+ * @param[in] series    the chunk of the timeseries
+ * @param[in] n         the length of the chunk
+ * @param[out] coal     the resulting coalesced chunk
+ * @param[out] err      the error code
+ * @return the number of unique states observed so far
+ */
+EXPORT int inform_coalescer_push64(inform_coalescer *coalescer,
+    int64_t const *series, size_t n, int *coal, inform_error *err);
+
+/**
+ * Get the state given each symbol by a coalescer, as many as the number of
+ * unique states returned by the last push.
+ *
+ * @param[in] coalescer the coalescer
+ * @return the state of each symbol, or `NULL` if no states have been observed
+ */
+EXPORT int64_t const *inform_coalescer_states(inform_coalescer const *coalescer);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,6 +4,8 @@
 #pragma once
 
 #include <inform/export.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -30,6 +32,90 @@ EXPORT size_t *inform_first_partitioning(size_t size);
  */
 EXPORT size_t inform_next_partitioning(size_t *xs, size_t size);
 
+/**
+ * Count the partitionings of a given size into exactly `blocks` partitions
+ * (a Stirling number of the second kind), or into any number of partitions
+ * if `blocks` is zero (a Bell number)
+ *
+ * @param[in] size   the number of elements
+ * @param[in] blocks the number of partitions, or zero for any number
+ * @return the number of partitionings, or `SIZE_MAX` if it is too large to
+ *         represent
+ */
+EXPORT size_t inform_count_partitionings(size_t size, size_t blocks);
+
+/**
+ * Compute the first partitioning of a given size into exactly `blocks`
+ * partitions
+ *
+ * If `blocks` is zero, this is the same as `inform_first_partitioning`.
+ *
+ * @param[in] size   the number of elements
+ * @param[in] blocks the number of partitions, or zero for any number
+ * @return an array of partition numbers, or `NULL` if there is no such
+ *         partitioning
+ */
+EXPORT size_t *inform_first_partitioning_into(size_t size, size_t blocks);
+
+/**
+ * Compute the next partitioning into exactly `blocks` partitions in place
+ *
+ * The partitionings are visited in the same order as by
+ * `inform_next_partitioning`, skipping those with a different number of
+ * partitions. If `blocks` is zero, this is the same as
+ * `inform_next_partitioning`.
+ *
+ * @param[in,out] xs     the current partitioning
+ * @param[in] size       the number of elements
+ * @param[in] blocks     the number of partitions, or zero for any number
+ * @return the number of partitions, or zero if `xs` was the last
+ *         partitioning
+ */
+EXPORT size_t inform_next_partitioning_into(size_t *xs, size_t size,
+    size_t blocks);
+
+/**
+ * Compute the position of a partitioning in the sequence visited by
+ * `inform_next_partitioning_into`, starting from zero
+ *
+ * @param[in] xs     the partitioning
+ * @param[in] size   the number of elements
+ * @param[in] blocks the number of partitions, or zero for any number
+ * @return the rank of the partitioning, or `SIZE_MAX` if `xs` is not a
+ *         partitioning into `blocks` partitions or there are too many
+ *         partitionings to rank
+ */
+EXPORT size_t inform_rank_partitioning(size_t const *xs, size_t size,
+    size_t blocks);
+
+/**
+ * Compute the partitioning at a given position in the sequence visited by
+ * `inform_next_partitioning_into`
+ *
+ * Together with `inform_next_partitioning_into`, this iterates over any
+ * range of the sequence, so an enumeration can be split evenly between
+ * threads or processes:
+ *
+ * ```c
+ * size_t *xs = inform_unrank_partitioning(begin, size, blocks, NULL);
+ * for (size_t r = begin; r < end; ++r)
+ * {
+ *     // ... use xs ...
+ *     inform_next_partitioning_into(xs, size, blocks);
+ * }
+ * free(xs);
+ * ```
+ *
+ * @param[in] rank    the position of the partitioning
+ * @param[in] size    the number of elements
+ * @param[in] blocks  the number of partitions, or zero for any number
+ * @param[out] xs     the partitioning, or `NULL` to allocate one
+ * @return the partitioning, or `NULL` if `rank` is out of range or the
+ *         partitioning could not be allocated
+ */
+EXPORT size_t *inform_unrank_partitioning(size_t rank, size_t size,
+    size_t blocks, size_t *xs);
+
 #ifdef __cplusplus
 }
 #endif
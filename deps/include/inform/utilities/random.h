@@ -4,6 +4,7 @@
 #pragma once
 
 #include <inform/export.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #ifdef __cplusplus
@@ -15,6 +16,9 @@ extern "C"
  * Seed the C psuedo-random number generator.
  *
  * This is just a convenience wrapper for the standard `srand(time(NULL))`.
+ * The `inform_random_*` functions share the global state of `rand`, so they
+ * are not thread-safe; use an `inform_rng` for reproducible or parallel
+ * streams.
  */
 EXPORT void inform_random_seed();
 
@@ -50,6 +54,110 @@ EXPORT int *inform_random_ints(int a, int b, size_t n);
  */
 EXPORT int *inform_random_series(size_t n, int b);
 
+/**
+ * A xoshiro256** pseudo-random number generator
+ *
+ * Each generator carries its own state, so separate generators may be used
+ * from separate threads. A generator is seeded explicitly, and
+ * `inform_rng_jump` splits off streams which do not overlap: seed one
+ * generator, copy it for each thread, and jump each copy one more time than
+ * the last.
+ */
+typedef struct inform_rng
+{
+    /// the state of the generator
+    uint64_t state[4];
+} inform_rng;
+
+/**
+ * Seed a generator, expanding the seed into its state with splitmix64.
+ *
+ * @param[in] rng  the generator
+ * @param[in] seed the seed
+ */
+EXPORT void inform_rng_seed(inform_rng *rng, uint64_t seed);
+
+/**
+ * Generate 64 pseudo-random bits.
+ *
+ * @param[in] rng the generator
+ * @return the generated bits
+ */
+EXPORT uint64_t inform_rng_next(inform_rng *rng);
+
+/**
+ * Advance a generator by 2^128 steps, i.e. to the start of the next of 2^128
+ * non-overlapping streams.
+ *
+ * @param[in] rng the generator
+ */
+EXPORT void inform_rng_jump(inform_rng *rng);
+
+/**
+ * Generate a pseudo-random integer uniformly sampled from `[0, n)`, without
+ * modulo bias.
+ *
+ * @param[in] rng the generator
+ * @param[in] n   the upper bound
+ * @return the generated integer
+ */
+EXPORT uint64_t inform_rng_bounded(inform_rng *rng, uint64_t n);
+
+/**
+ * Generate a pseudo-random integer uniformly sampled from `[a, b)`, without
+ * modulo bias. Any `a < b` is supported, up to `[INT_MIN, INT_MAX)`. If
+ * `b <= a` the range is empty, and `a` is returned without advancing the
+ * generator.
+ *
+ * @param[in] rng the generator
+ * @param[in] a   the lower bound
+ * @param[in] b   the upper bound
+ * @return the generated integer
+ */
+EXPORT int inform_rng_int(inform_rng *rng, int a, int b);
+
+/**
+ * Generate an array of `n` pseudo-random integers uniformly sampled from
+ * `[a, b)`. As with `inform_rng_int`, if `b <= a` every element is `a` and
+ * the generator is not advanced.
+ *
+ * If `xs` is `NULL`, an array is allocated for the samples.
+ *
+ * @param[in] rng the generator
+ * @param[in] a   the lower bound
+ * @param[in] b   the upper bound
+ * @param[in] n   the number of samples
+ * @param[out] xs the array of samples
+ * @return the array of generated integers, or `NULL` if it could not be
+ *         allocated
+ */
+EXPORT int *inform_rng_ints(inform_rng *rng, int a, int b, size_t n, int *xs);
+
+/**
+ * Generate a base-`b` array of `n` pseudo-random integers.
+ *
+ * This function is just a convenience wrapper for
+ * `inform_rng_ints(rng, 0, b, n, xs)`.
+ *
+ * @param[in] rng the generator
+ * @param[in] n   the number of samples
+ * @param[in] b   the base of the samples
+ * @param[out] xs the array of samples
+ * @return the array of generated integers, or `NULL` if it could not be
+ *         allocated
+ */
+EXPORT int *inform_rng_series(inform_rng *rng, size_t n, int b, int *xs);
+
+/**
+ * Shuffle an array in place, uniformly over its permutations, with
+ * Durstenfeld's version of the Fisher-Yates shuffle.
+ *
+ * @param[in] rng    the generator
+ * @param[in,out] xs the array
+ * @param[in] n      the length of the array
+ */
+EXPORT void inform_rng_shuffle(inform_rng *rng, int *xs, size_t n);
+
 #ifdef __cplusplus
 }
 #endif
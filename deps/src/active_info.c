@@ -4,14 +4,89 @@
 #include <inform/active_info.h>
 #include <inform/shannon.h>
 #include <string.h>
+#include "counts.h"
+#include "parallel.h"
+#include "sparse.h"
+#include "xlogx.h"
 
-static void accumulate_observations(int const* series, size_t n, size_t m,
-    int b, size_t k, inform_dist *states, inform_dist *histories,
-    inform_dist *futures)
+#define DEFINE_ACCUMULATE(TYPE) \
+static void accumulate_##TYPE(int const *series, size_t m, int b, size_t k, \
+    size_t begin, size_t end, TYPE *states, TYPE *histories, TYPE *futures) \
+{ \
+    size_t const w = m - k; \
+    while (begin < end) \
+    { \
+        int const *trial = series + m * (begin / w); \
+        size_t const first = k + begin % w; \
+        size_t const last = (m - first < end - begin) ? m : first + (end - begin); \
+ \
+        int history = 0, q = 1, state, future; \
+        for (size_t j = first - k; j < first; ++j) \
+        { \
+            q *= b; \
+            history *= b; \
+            history += trial[j]; \
+        } \
+        for (size_t j = first; j < last; ++j) \
+        { \
+            future = trial[j]; \
+            state  = history * b + future; \
+ \
+            states[state]++; \
+            histories[history]++; \
+            futures[future]++; \
+ \
+            history = state - trial[j - k]*q; \
+        } \
+        begin += last - first; \
+    } \
+}
+
+DEFINE_ACCUMULATE(uint16_t)
+DEFINE_ACCUMULATE(uint32_t)
+DEFINE_ACCUMULATE(uint64_t)
+
+/**
+ * Count the observations numbered `[begin, end)` consecutively across the
+ * trials. A range may start part way through a trial, in which case its
+ * first history is read from the preceding time steps. The histograms hold
+ * counters of `width` bytes, as chosen by `inform_counts_width`.
+ */
+static void accumulate_observations(int const *series, size_t m, int b,
+    size_t k, size_t begin, size_t end, size_t width, void *states,
+    void *histories, void *futures)
 {
+    switch (width)
+    {
+        case sizeof(uint16_t):
+            accumulate_uint16_t(series, m, b, k, begin, end, states, histories,
+                futures);
+            break;
+        case sizeof(uint32_t):
+            accumulate_uint32_t(series, m, b, k, begin, end, states, histories,
+                futures);
+            break;
+        default:
+            accumulate_uint64_t(series, m, b, k, begin, end, states, histories,
+                futures);
+            break;
+    }
+}
+
+/**
+ * Compute the local active information of each observation from the
+ * complete histograms. The states are encoded again as they were during the
+ * accumulation rather than being stored, which would take several bytes of
+ * scratch memory per observation.
+ */
+static void local_values(int const *series, size_t n, size_t m, int b,
+    size_t k, uint32_t const *states, uint32_t const *histories,
+    uint32_t const *futures, double *ai)
+{
+    double const N = (double) (n * (m - k));
     for (size_t i = 0; i < n; ++i, series += m)
     {
-        int history = 0, q = 1, state, future;
+        int history = 0, q = 1, state;
         for (size_t j = 0; j < k; ++j)
         {
             q *= b;
@@ -20,49 +95,78 @@ static void accumulate_observations(int const* series, size_t n, size_t m,
         }
         for (size_t j = k; j < m; ++j)
         {
-            future = series[j];
-            state  = history * b + future;
+            state = history * b + series[j];
 
-            states->histogram[state]++;
-            histories->histogram[history]++;
-            futures->histogram[future]++;
+            double const r = states[state];
+            double const s = histories[history];
+            double const t = futures[series[j]];
+            *ai++ = log2((r * N) / (s * t));
 
             history = state - series[j - k]*q;
         }
     }
 }
 
-static void accumulate_local_observations(int const* series, size_t n, size_t m,
-    int b, size_t k, inform_dist *states, inform_dist *histories,
-    inform_dist *futures, int *state, int *history, int *future)
+static bool accumulate_sparse_observations(int const *series, size_t n,
+    size_t m, int b, size_t k, inform_sparse_dist *states,
+    inform_sparse_dist *histories, uint32_t *futures)
+{
+    for (size_t i = 0; i < n; ++i, series += m)
+    {
+        uint64_t h = 0, q = 1, s;
+        for (size_t j = 0; j < k; ++j)
+        {
+            q *= b;
+            h *= b;
+            h += series[j];
+        }
+        for (size_t j = k; j < m; ++j)
+        {
+            s = h * b + series[j];
+
+            if (!inform_sparse_tick(states, s) ||
+                !inform_sparse_tick(histories, h))
+            {
+                return false;
+            }
+            futures[series[j]]++;
+
+            h = s - series[j - k] * q;
+        }
+    }
+    return true;
+}
+
+/**
+ * Compute the local active information of each observation from the
+ * complete sparse histograms, encoding the states again as `local_values`
+ * does.
+ */
+static void sparse_local_values(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_sparse_dist const *states,
+    inform_sparse_dist const *histories, uint32_t const *futures, double *ai)
 {
-    for (size_t i = 0; i < n; ++i)
+    double const N = (double) (n * (m - k));
+    for (size_t i = 0; i < n; ++i, series += m)
     {
-        history[0] = 0;
-        int q = 1;
+        uint64_t h = 0, q = 1, s;
         for (size_t j = 0; j < k; ++j)
         {
             q *= b;
-            history[0] *= b;
-            history[0] += series[j];
+            h *= b;
+            h += series[j];
         }
         for (size_t j = k; j < m; ++j)
         {
-            size_t l = j - k;
-            future[l] = series[j];
-            state[l] = history[l] * b + future[l];
+            s = h * b + series[j];
 
-            states->histogram[state[l]]++;
-            histories->histogram[history[l]]++;
-            futures->histogram[future[l]]++;
+            double const r = inform_sparse_get(states, s);
+            double const u = inform_sparse_get(histories, h);
+            double const t = futures[series[j]];
+            *ai++ = log2((r * N) / (u * t));
 
-            if (j + 1 != m)
-                history[l + 1] = state[l] - series[l]*q;
+            h = s - series[j - k] * q;
         }
-        series += m;
-        state += (m - k);
-        history += (m - k);
-        future += (m - k);
     }
 }
 
@@ -107,6 +211,68 @@ static bool check_arguments(int const *series, size_t n, size_t m, int b,
     return false;
 }
 
+/**
+ * Compute the active information using sparse histograms. If `ai` is
+ * non-NULL, the local values are stored in it and zero is returned. On
+ * failure, `NAN` is returned.
+ */
+static double sparse_active_info(int const *series, size_t n, size_t m, int b,
+    size_t k, double *ai, inform_error *err)
+{
+    size_t const N = n * (m - k);
+
+    // the sparse histograms have 32-bit counters
+    if (N > UINT32_MAX)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESIZE, NAN);
+    }
+
+    if (!inform_sparse_encodable(b, k + 1))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, NAN);
+    }
+
+    uint32_t *futures = calloc(b, sizeof(uint32_t));
+    inform_sparse_dist states = INFORM_SPARSE_DIST_EMPTY;
+    inform_sparse_dist histories = INFORM_SPARSE_DIST_EMPTY;
+
+    double value = NAN;
+    if (futures == NULL || !inform_sparse_init(&states) ||
+        !inform_sparse_init(&histories))
+    {
+        INFORM_ERROR(err, INFORM_ENOMEM);
+    }
+    else if (!accumulate_sparse_observations(series, n, m, b, k, &states,
+        &histories, futures))
+    {
+        INFORM_ERROR(err, INFORM_ENOMEM);
+    }
+    else if (ai == NULL)
+    {
+        value = (inform_sparse_xlogx(&states) - inform_sparse_xlogx(&histories)
+            - inform_xlogx_sum(futures, b)) / N + log2((double) N);
+    }
+    else
+    {
+        sparse_local_values(series, n, m, b, k, &states, &histories, futures, ai);
+        value = 0.0;
+    }
+
+    inform_sparse_free(&histories);
+    inform_sparse_free(&states);
+    free(futures);
+
+    return value;
+}
+
+/**
+ * The total support of the dense histograms for the active information.
+ */
+inline static double dense_support(int b, size_t k)
+{
+    return pow((double) b, (double) k) * (b + 1) + b;
+}
+
 double inform_active_info(int const *series, size_t n, size_t m, int b,
     size_t k, inform_error *err)
 {
@@ -114,53 +280,48 @@ double inform_active_info(int const *series, size_t n, size_t m, int b,
 
     size_t const N = n * (m - k);
 
+    if (inform_sparse_preferred(dense_support(b, k), N))
+    {
+        return sparse_active_info(series, n, m, b, k, NULL, err);
+    }
+
     size_t const states_size = (size_t) (b * pow((double) b,(double) k));
     size_t const histories_size = states_size / b;
     size_t const futures_size = b;
     size_t const total_size = states_size + histories_size + futures_size;
+    size_t const chunks = inform_parallel_chunks(N, total_size);
+    size_t const width = inform_counts_width(N);
 
-    uint32_t *data = calloc(total_size, sizeof(uint32_t));
+    void *data = calloc(chunks * total_size, width);
     if (data == NULL)
     {
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
     }
 
-    inform_dist states    = { data, states_size, N };
-    inform_dist histories = { data + states_size, histories_size, N };
-    inform_dist futures   = { data + states_size + histories_size, futures_size, N };
-
-    accumulate_observations(series, n, m, b, k, &states, &histories, &futures);
-
-    double ai = 0.0;
-    int state;
-    double n_state, n_history, n_future;
-    for (int history = 0; history < (int) histories_size; ++history)
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
     {
-        n_history = histories.histogram[history];
-        if (n_history == 0)
-        {
-            continue;
-        }
-        for (int future = 0; future < b; ++future)
-        {
-            n_future = futures.histogram[future];
-            if (n_future == 0)
-            {
-                continue;
-            }
-            state = history * b + future;
-            n_state = states.histogram[state];
-            if (n_state == 0)
-            {
-                continue;
-            }
-            ai += n_state * log2((N * n_state) / (n_history * n_future));
-        }
+        void *chunk = inform_counts_at(data, width, c * total_size);
+        size_t begin, end;
+        inform_parallel_range(N, c, chunks, &begin, &end);
+        accumulate_observations(series, m, b, k, begin, end, width, chunk,
+            inform_counts_at(chunk, width, states_size),
+            inform_counts_at(chunk, width, states_size + histories_size));
     }
+    inform_counts_merge(data, width, total_size, chunks);
+
+    double const ai = (inform_counts_xlogx(data, width, states_size)
+        - inform_counts_xlogx(inform_counts_at(data, width, states_size), width,
+            histories_size)
+        - inform_counts_xlogx(inform_counts_at(data, width,
+            states_size + histories_size), width, futures_size))
+        / N + log2((double) N);
 
     free(data);
 
-    return ai / N;
+    return ai;
 }
 
 double *inform_local_active_info(int const *series, size_t n, size_t m, int b,
@@ -170,6 +331,12 @@ double *inform_local_active_info(int const *series, size_t n, size_t m, int b,
 
     size_t const N = n * (m - k);
 
+    // the local histograms have 32-bit counters
+    if (N > UINT32_MAX)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESIZE, NULL);
+    }
+
     bool allocate_ai = (ai == NULL);
     if (allocate_ai)
     {
@@ -180,6 +347,16 @@ double *inform_local_active_info(int const *series, size_t n, size_t m, int b,
         }
     }
 
+    if (inform_sparse_preferred(dense_support(b, k), N))
+    {
+        if (isnan(sparse_active_info(series, n, m, b, k, ai, err)))
+        {
+            if (allocate_ai) free(ai);
+            return NULL;
+        }
+        return ai;
+    }
+
     size_t const states_size = (size_t) (b*pow((double) b,(double) k));
     size_t const histories_size = states_size / b;
     size_t const futures_size = b;
@@ -191,34 +368,13 @@ double *inform_local_active_info(int const *series, size_t n, size_t m, int b,
         if (allocate_ai) free(ai);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
-    inform_dist states    = { histogram_data, states_size, N };
-    inform_dist histories = { histogram_data + states_size, histories_size, N };
-    inform_dist futures   = { histogram_data + states_size + histories_size, futures_size, N };
-
-    int *state_data = malloc(3 * N * sizeof(int));
-    if (state_data == NULL)
-    {
-        if (allocate_ai) free(ai);
-        free(histogram_data);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
-    }
-    int *state   = state_data;
-    int *history = state + N;
-    int *future  = history + N;
-
-    accumulate_local_observations(series, n, m, b, k, &states, &histories,
-        &futures, state, history, future);
+    uint32_t *states    = histogram_data;
+    uint32_t *histories = states + states_size;
+    uint32_t *futures   = histories + histories_size;
 
-    double r, s, t;
-    for (size_t i = 0; i < N; ++i)
-    {
-        r = states.histogram[state[i]];
-        s = histories.histogram[history[i]];
-        t = futures.histogram[future[i]];
-        ai[i] = log2((r * N) / (s * t));
-    }
+    accumulate_uint32_t(series, m, b, k, 0, N, states, histories, futures);
+    local_values(series, n, m, b, k, states, histories, futures, ai);
 
-    free(state_data);
     free(histogram_data);
 
     return ai;
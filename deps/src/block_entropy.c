@@ -3,10 +3,72 @@
 // license that can be found in the LICENSE file.
 #include <inform/block_entropy.h>
 #include <inform/shannon.h>
+#include "counts.h"
+#include "parallel.h"
+#include "sparse.h"
 
-static void accumulate_observations(int const* series, size_t n, size_t m,
-    int b, size_t k, inform_dist *states)
+#define DEFINE_ACCUMULATE(TYPE) \
+static void accumulate_##TYPE(int const *series, size_t m, int b, size_t k, \
+    size_t begin, size_t end, TYPE *states) \
+{ \
+    size_t const w = m - k + 1; \
+    while (begin < end) \
+    { \
+        int const *trial = series + m * (begin / w); \
+        size_t const first = begin % w; \
+        size_t const last = (w - first < end - begin) ? w : first + (end - begin); \
+ \
+        int history = 0, q = 1, state; \
+        for (size_t j = first; j + 1 < first + k; ++j) \
+        { \
+            q *= b; \
+            history *= b; \
+            history += trial[j]; \
+        } \
+        for (size_t p = first; p < last; ++p) \
+        { \
+            state = history * b + trial[p + k - 1]; \
+            states[state]++; \
+            history = state - trial[p]*q; \
+        } \
+        begin += last - first; \
+    } \
+}
+
+DEFINE_ACCUMULATE(uint16_t)
+DEFINE_ACCUMULATE(uint32_t)
+DEFINE_ACCUMULATE(uint64_t)
+
+/**
+ * Count the blocks numbered `[begin, end)` consecutively across the trials.
+ */
+static void accumulate_observations(int const *series, size_t m, int b,
+    size_t k, size_t begin, size_t end, size_t width, void *states)
+{
+    switch (width)
+    {
+        case sizeof(uint16_t):
+            accumulate_uint16_t(series, m, b, k, begin, end, states);
+            break;
+        case sizeof(uint32_t):
+            accumulate_uint32_t(series, m, b, k, begin, end, states);
+            break;
+        default:
+            accumulate_uint64_t(series, m, b, k, begin, end, states);
+            break;
+    }
+}
+
+/**
+ * Compute the local block entropy of each block from the complete histogram.
+ * The blocks are encoded again as they were during the accumulation rather
+ * than being stored, which would take several bytes of scratch memory per
+ * block.
+ */
+static void local_values(int const *series, size_t n, size_t m, int b,
+    size_t k, uint32_t const *states, double *be)
 {
+    double const N = (double) (n * (m - k + 1));
     k -= 1;
     for (size_t i = 0; i < n; ++i, series += m)
     {
@@ -19,20 +81,23 @@ static void accumulate_observations(int const* series, size_t n, size_t m,
         }
         for (size_t j = k; j < m; ++j)
         {
-            state  = history * b + series[j];
-            states->histogram[state]++;
+            state = history * b + series[j];
+
+            double const s = states[state];
+            *be++ = -log2(s/N);
+
             history = state - series[j - k]*q;
         }
     }
 }
 
-static void accumulate_local_observations(int const* series, size_t n, size_t m,
-    int b, size_t k, inform_dist *states, int *state)
+static bool accumulate_sparse_observations(int const *series, size_t n,
+    size_t m, int b, size_t k, inform_sparse_dist *states)
 {
     k -= 1;
-    for (size_t i = 0; i < n; ++i)
+    for (size_t i = 0; i < n; ++i, series += m)
     {
-        int history = 0, q = 1;
+        uint64_t history = 0, q = 1, s;
         for (size_t j = 0; j < k; ++j)
         {
             q *= b;
@@ -41,16 +106,46 @@ static void accumulate_local_observations(int const* series, size_t n, size_t m,
         }
         for (size_t j = k; j < m; ++j)
         {
-            size_t l = j - k;
-            state[l] = history * b + series[j];
+            s = history * b + series[j];
 
-            states->histogram[state[l]]++;
+            if (!inform_sparse_tick(states, s))
+            {
+                return false;
+            }
 
-            if (j + 1 != m)
-                history = state[l] - series[l]*q;
+            history = s - series[j - k] * q;
+        }
+    }
+    return true;
+}
+
+/**
+ * Compute the local block entropy of each block from the complete sparse
+ * histogram, encoding the blocks again as `local_values` does.
+ */
+static void sparse_local_values(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_sparse_dist const *states, double *be)
+{
+    double const N = (double) (n * (m - k + 1));
+    k -= 1;
+    for (size_t i = 0; i < n; ++i, series += m)
+    {
+        uint64_t history = 0, q = 1, s;
+        for (size_t j = 0; j < k; ++j)
+        {
+            q *= b;
+            history *= b;
+            history += series[j];
+        }
+        for (size_t j = k; j < m; ++j)
+        {
+            s = history * b + series[j];
+
+            double const r = inform_sparse_get(states, s);
+            *be++ = -log2(r/N);
+
+            history = s - series[j - k] * q;
         }
-        series += m;
-        state += (m - k);
     }
 }
 
@@ -95,26 +190,88 @@ static bool check_arguments(int const *series, size_t n, size_t m, int b,
     return false;
 }
 
+/**
+ * Compute the block entropy using a sparse histogram. If `be` is non-NULL,
+ * the local values are stored in it and zero is returned. On failure, `NAN`
+ * is returned.
+ */
+static double sparse_block_entropy(int const *series, size_t n, size_t m,
+    int b, size_t k, double *be, inform_error *err)
+{
+    size_t const N = n * (m - k + 1);
+
+    // the sparse histograms have 32-bit counters
+    if (N > UINT32_MAX)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESIZE, NAN);
+    }
+
+    if (!inform_sparse_encodable(b, k))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, NAN);
+    }
+
+    inform_sparse_dist states = INFORM_SPARSE_DIST_EMPTY;
+
+    double value = NAN;
+    if (!inform_sparse_init(&states))
+    {
+        INFORM_ERROR(err, INFORM_ENOMEM);
+    }
+    else if (!accumulate_sparse_observations(series, n, m, b, k, &states))
+    {
+        INFORM_ERROR(err, INFORM_ENOMEM);
+    }
+    else if (be == NULL)
+    {
+        value = log2((double) N) - inform_sparse_xlogx(&states) / N;
+    }
+    else
+    {
+        sparse_local_values(series, n, m, b, k, &states, be);
+        value = 0.0;
+    }
+
+    inform_sparse_free(&states);
+
+    return value;
+}
+
 double inform_block_entropy(int const *series, size_t n, size_t m, int b,
     size_t k, inform_error *err)
 {
     if (check_arguments(series, n, m, b, k, err)) return NAN;
 
+    if (inform_sparse_preferred(pow((double) b, (double) k), n * (m - k + 1)))
+    {
+        return sparse_block_entropy(series, n, m, b, k, NULL, err);
+    }
+
     size_t const states_size = (size_t) pow((double) b, (double) k);
+    size_t const N = n * (m - k + 1);
+    size_t const chunks = inform_parallel_chunks(N, states_size);
+    size_t const width = inform_counts_width(N);
 
-    uint32_t *data = calloc(states_size, sizeof(uint32_t));
+    void *data = calloc(chunks * states_size, width);
     if (data == NULL)
     {
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
     }
 
-    size_t const N = n * (m - k + 1);
-
-    inform_dist states = { data, states_size, N };
-
-    accumulate_observations(series, n, m, b, k, &states);
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        size_t begin, end;
+        inform_parallel_range(N, c, chunks, &begin, &end);
+        accumulate_observations(series, m, b, k, begin, end, width,
+            inform_counts_at(data, width, c * states_size));
+    }
+    inform_counts_merge(data, width, states_size, chunks);
 
-    double be = inform_shannon_entropy(&states, 2.0);
+    double const be = log2((double) N)
+        - inform_counts_xlogx(data, width, states_size) / N;
 
     free(data);
 
@@ -128,6 +285,12 @@ double *inform_local_block_entropy(int const *series, size_t n, size_t m, int b,
 
     size_t const N = n * (m - k + 1);
 
+    // the local histograms have 32-bit counters
+    if (N > UINT32_MAX)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESIZE, NULL);
+    }
+
     bool allocate_be = (be == NULL);
     if (allocate_be)
     {
@@ -138,35 +301,28 @@ double *inform_local_block_entropy(int const *series, size_t n, size_t m, int b,
         }
     }
 
-    size_t const states_size = (size_t) pow((double) b, (double) k);
-
-    uint32_t *data = calloc(states_size, sizeof(uint32_t));
-    if (data == NULL)
+    if (inform_sparse_preferred(pow((double) b, (double) k), N))
     {
-        if (allocate_be) free(be);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        if (isnan(sparse_block_entropy(series, n, m, b, k, be, err)))
+        {
+            if (allocate_be) free(be);
+            return NULL;
+        }
+        return be;
     }
 
-    inform_dist states = { data, states_size, N };
+    size_t const states_size = (size_t) pow((double) b, (double) k);
 
-    int *state = malloc(N * sizeof(int));
-    if (state == NULL)
+    uint32_t *data = calloc(states_size, sizeof(uint32_t));
+    if (data == NULL)
     {
         if (allocate_be) free(be);
-        free(data);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
 
-    accumulate_local_observations(series, n, m, b, k, &states, state);
-
-    double s;
-    for (size_t i = 0; i < N; ++i)
-    {
-        s = states.histogram[state[i]];
-        be[i] = -log2(s/N);
-    }
+    accumulate_uint32_t(series, m, b, k, 0, N, data);
+    local_values(series, n, m, b, k, data, be);
 
-    free(state);
     free(data);
 
     return be;
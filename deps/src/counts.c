@@ -0,0 +1,62 @@
+// Copyright 2016-2019 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "counts.h"
+#include "xlogx.h"
+
+#ifdef _OPENMP
+#define PARALLEL_FOR _Pragma("omp parallel for schedule(static)")
+#else
+#define PARALLEL_FOR
+#endif
+
+#define DEFINE_COUNTS(TYPE) \
+static double xlogx_##TYPE(TYPE const *counts, size_t size) \
+{ \
+    double sum = 0.0; \
+    for (size_t i = 0; i < size; ++i) \
+    { \
+        sum += inform_xlogx(counts[i]); \
+    } \
+    return sum; \
+} \
+ \
+static void merge_##TYPE(TYPE *counts, size_t size, size_t chunks) \
+{ \
+    PARALLEL_FOR \
+    for (size_t i = 0; i < size; ++i) \
+    { \
+        for (size_t c = 1; c < chunks; ++c) \
+        { \
+            counts[i] += counts[c * size + i]; \
+        } \
+    } \
+}
+
+DEFINE_COUNTS(uint16_t)
+DEFINE_COUNTS(uint32_t)
+DEFINE_COUNTS(uint64_t)
+
+double inform_counts_xlogx(void const *data, size_t width, size_t size)
+{
+    switch (width)
+    {
+        case sizeof(uint16_t): return xlogx_uint16_t(data, size);
+        case sizeof(uint32_t): return xlogx_uint32_t(data, size);
+        default:               return xlogx_uint64_t(data, size);
+    }
+}
+
+void inform_counts_merge(void *data, size_t width, size_t size, size_t chunks)
+{
+    if (chunks < 2)
+    {
+        return;
+    }
+    switch (width)
+    {
+        case sizeof(uint16_t): merge_uint16_t(data, size, chunks); break;
+        case sizeof(uint32_t): merge_uint32_t(data, size, chunks); break;
+        default:               merge_uint64_t(data, size, chunks); break;
+    }
+}
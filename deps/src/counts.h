@@ -0,0 +1,47 @@
+// Copyright 2016-2019 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Choose the width, in bytes, of the counters of a dense histogram of `N`
+ * observations: 16-bit counters for fewer than @f 2^{16} @f observations,
+ * e.g. short windows, 64-bit counters for @f 2^{32} @f or more, and 32-bit
+ * counters otherwise. No count can then overflow, and histograms over large
+ * supports take as little memory (and cache) as `N` allows.
+ */
+inline static size_t inform_counts_width(size_t N)
+{
+    if (N <= UINT16_MAX)
+    {
+        return sizeof(uint16_t);
+    }
+    else if (N <= UINT32_MAX)
+    {
+        return sizeof(uint32_t);
+    }
+    return sizeof(uint64_t);
+}
+
+/**
+ * The address of counter `i` of a histogram of `width`-byte counters.
+ */
+inline static void *inform_counts_at(void *data, size_t width, size_t i)
+{
+    return (char *) data + i * width;
+}
+
+/**
+ * Sum @f c \log_2{c} @f over a histogram of `size` counters of `width`
+ * bytes; see `inform_xlogx_sum`.
+ */
+double inform_counts_xlogx(void const *data, size_t width, size_t size);
+
+/**
+ * Sum `chunks` consecutive histograms of `size` counters of `width` bytes
+ * into the first, as counted by the chunks of `inform_parallel_chunks`.
+ */
+void inform_counts_merge(void *data, size_t width, size_t size, size_t chunks);
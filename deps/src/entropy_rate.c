@@ -3,13 +3,82 @@
 // license that can be found in the LICENSE file.
 #include <inform/entropy_rate.h>
 #include <inform/shannon.h>
+#include "counts.h"
+#include "parallel.h"
+#include "sparse.h"
 
-static void accumulate_observations(int const* series, size_t n, size_t m,
-    int b, size_t k, inform_dist *states, inform_dist *histories)
+#define DEFINE_ACCUMULATE(TYPE) \
+static void accumulate_##TYPE(int const *series, size_t m, int b, size_t k, \
+    size_t begin, size_t end, TYPE *states, TYPE *histories) \
+{ \
+    size_t const w = m - k; \
+    while (begin < end) \
+    { \
+        int const *trial = series + m * (begin / w); \
+        size_t const first = k + begin % w; \
+        size_t const last = (m - first < end - begin) ? m : first + (end - begin); \
+ \
+        int history = 0, q = 1, state, future; \
+        for (size_t j = first - k; j < first; ++j) \
+        { \
+            q *= b; \
+            history *= b; \
+            history += trial[j]; \
+        } \
+        for (size_t j = first; j < last; ++j) \
+        { \
+            future = trial[j]; \
+            state  = history * b + future; \
+ \
+            states[state]++; \
+            histories[history]++; \
+ \
+            history = state - trial[j - k]*q; \
+        } \
+        begin += last - first; \
+    } \
+}
+
+DEFINE_ACCUMULATE(uint16_t)
+DEFINE_ACCUMULATE(uint32_t)
+DEFINE_ACCUMULATE(uint64_t)
+
+/**
+ * Count the observations numbered `[begin, end)` consecutively across the
+ * trials. A range may start part way through a trial, in which case its
+ * first history is read from the preceding time steps. The histograms hold
+ * counters of `width` bytes, as chosen by `inform_counts_width`.
+ */
+static void accumulate_observations(int const *series, size_t m, int b,
+    size_t k, size_t begin, size_t end, size_t width, void *states,
+    void *histories)
+{
+    switch (width)
+    {
+        case sizeof(uint16_t):
+            accumulate_uint16_t(series, m, b, k, begin, end, states, histories);
+            break;
+        case sizeof(uint32_t):
+            accumulate_uint32_t(series, m, b, k, begin, end, states, histories);
+            break;
+        default:
+            accumulate_uint64_t(series, m, b, k, begin, end, states, histories);
+            break;
+    }
+}
+
+/**
+ * Compute the local entropy rate of each observation from the complete
+ * histograms. The states are encoded again as they were during the
+ * accumulation rather than being stored, which would take several bytes of
+ * scratch memory per observation.
+ */
+static void local_values(int const *series, size_t n, size_t m, int b,
+    size_t k, uint32_t const *states, uint32_t const *histories, double *er)
 {
     for (size_t i = 0; i < n; ++i, series += m)
     {
-        int history = 0, q = 1, state, future;
+        int history = 0, q = 1, state;
         for (size_t j = 0; j < k; ++j)
         {
             q *= b;
@@ -18,47 +87,73 @@ static void accumulate_observations(int const* series, size_t n, size_t m,
         }
         for (size_t j = k; j < m; ++j)
         {
-            future = series[j];
-            state  = history * b + future;
+            state = history * b + series[j];
 
-            states->histogram[state]++;
-            histories->histogram[history]++;
+            double const s = states[state];
+            double const h = histories[history];
+            *er++ = log2(h/s);
 
             history = state - series[j - k]*q;
         }
     }
 }
 
-static void accumulate_local_observations(int const* series, size_t n, size_t m,
-    int b, size_t k, inform_dist *states, inform_dist *histories,
-    int *state, int *history)
+static bool accumulate_sparse_observations(int const *series, size_t n,
+    size_t m, int b, size_t k, inform_sparse_dist *states,
+    inform_sparse_dist *histories)
 {
-    for (size_t i = 0; i < n; ++i)
+    for (size_t i = 0; i < n; ++i, series += m)
     {
-        int q = 1;
-        history[0] = 0;
+        uint64_t h = 0, q = 1, s;
         for (size_t j = 0; j < k; ++j)
         {
             q *= b;
-            history[0] *= b;
-            history[0] += series[j];
+            h *= b;
+            h += series[j];
         }
         for (size_t j = k; j < m; ++j)
         {
-            size_t l = j - k;
-            state[l]  = history[l] * b + series[j];
-
-            states->histogram[state[l]]++;
-            histories->histogram[history[l]]++;
+            s = h * b + series[j];
 
-            if (j + 1 != m)
+            if (!inform_sparse_tick(states, s) ||
+                !inform_sparse_tick(histories, h))
             {
-                history[l + 1] = state[l] - series[l]*q;
+                return false;
             }
+
+            h = s - series[j - k] * q;
+        }
+    }
+    return true;
+}
+
+/**
+ * Compute the local entropy rate of each observation from the complete
+ * sparse histograms, encoding the states again as `local_values` does.
+ */
+static void sparse_local_values(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_sparse_dist const *states,
+    inform_sparse_dist const *histories, double *er)
+{
+    for (size_t i = 0; i < n; ++i, series += m)
+    {
+        uint64_t h = 0, q = 1, s;
+        for (size_t j = 0; j < k; ++j)
+        {
+            q *= b;
+            h *= b;
+            h += series[j];
+        }
+        for (size_t j = k; j < m; ++j)
+        {
+            s = h * b + series[j];
+
+            double const r = inform_sparse_get(states, s);
+            double const t = inform_sparse_get(histories, h);
+            *er++ = log2(t/r);
+
+            h = s - series[j - k] * q;
         }
-        series += m;
-        state += (m - k);
-        history += (m - k);
     }
 }
 
@@ -102,6 +197,64 @@ static bool check_arguments(int const *series, size_t n, size_t m, int b, size_t
     return false;
 }
 
+/**
+ * Compute the entropy rate using sparse histograms. If `er` is non-NULL, the
+ * local values are stored in it and zero is returned. On failure, `NAN` is
+ * returned.
+ */
+static double sparse_entropy_rate(int const *series, size_t n, size_t m,
+    int b, size_t k, double *er, inform_error *err)
+{
+    size_t const N = n * (m - k);
+
+    // the sparse histograms have 32-bit counters
+    if (N > UINT32_MAX)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESIZE, NAN);
+    }
+
+    if (!inform_sparse_encodable(b, k + 1))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, NAN);
+    }
+
+    inform_sparse_dist states    = INFORM_SPARSE_DIST_EMPTY;
+    inform_sparse_dist histories = INFORM_SPARSE_DIST_EMPTY;
+
+    double value = NAN;
+    if (!inform_sparse_init(&states) || !inform_sparse_init(&histories))
+    {
+        INFORM_ERROR(err, INFORM_ENOMEM);
+    }
+    else if (!accumulate_sparse_observations(series, n, m, b, k, &states,
+        &histories))
+    {
+        INFORM_ERROR(err, INFORM_ENOMEM);
+    }
+    else if (er == NULL)
+    {
+        value = (inform_sparse_xlogx(&histories) - inform_sparse_xlogx(&states)) / N;
+    }
+    else
+    {
+        sparse_local_values(series, n, m, b, k, &states, &histories, er);
+        value = 0.0;
+    }
+
+    inform_sparse_free(&histories);
+    inform_sparse_free(&states);
+
+    return value;
+}
+
+/**
+ * The total support of the dense histograms for the entropy rate.
+ */
+inline static double dense_support(int b, size_t k)
+{
+    return pow((double) b, (double) k) * (b + 1);
+}
+
 double inform_entropy_rate(int const *series, size_t n, size_t m, int b,
     size_t k, inform_error *err)
 {
@@ -109,22 +262,39 @@ double inform_entropy_rate(int const *series, size_t n, size_t m, int b,
 
     size_t const N = n * (m - k);
 
+    if (inform_sparse_preferred(dense_support(b, k), N))
+    {
+        return sparse_entropy_rate(series, n, m, b, k, NULL, err);
+    }
+
     size_t const states_size = (size_t) (b * pow((double) b, (double) k));
     size_t const histories_size = states_size / b;
     size_t const total_size = states_size + histories_size;
+    size_t const chunks = inform_parallel_chunks(N, total_size);
+    size_t const width = inform_counts_width(N);
 
-    uint32_t *data = calloc(total_size, sizeof(uint32_t));
+    void *data = calloc(chunks * total_size, width);
     if (data == NULL)
     {
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
     }
 
-    inform_dist states    = { data, states_size, N };
-    inform_dist histories = { data + states_size, histories_size, N };
-
-    accumulate_observations(series, n, m, b, k, &states, &histories);
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        void *chunk = inform_counts_at(data, width, c * total_size);
+        size_t begin, end;
+        inform_parallel_range(N, c, chunks, &begin, &end);
+        accumulate_observations(series, m, b, k, begin, end, width, chunk,
+            inform_counts_at(chunk, width, states_size));
+    }
+    inform_counts_merge(data, width, total_size, chunks);
 
-    double er = inform_shannon_ce(&states, &histories, 2.0);
+    double const er = (inform_counts_xlogx(inform_counts_at(data, width,
+        states_size), width, histories_size)
+        - inform_counts_xlogx(data, width, states_size)) / N;
 
     free(data);
 
@@ -138,6 +308,12 @@ double *inform_local_entropy_rate(int const *series, size_t n, size_t m, int b,
 
     size_t const N = n * (m - k);
 
+    // the local histograms have 32-bit counters
+    if (N > UINT32_MAX)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESIZE, NULL);
+    }
+
     bool allocate_er = (er == NULL);
     if (allocate_er)
     {
@@ -148,6 +324,16 @@ double *inform_local_entropy_rate(int const *series, size_t n, size_t m, int b,
         }
     }
 
+    if (inform_sparse_preferred(dense_support(b, k), N))
+    {
+        if (isnan(sparse_entropy_rate(series, n, m, b, k, er, err)))
+        {
+            if (allocate_er) free(er);
+            return NULL;
+        }
+        return er;
+    }
+
     size_t const states_size = (size_t) (b * pow((double) b, (double) k));
     size_t const histories_size = states_size / b;
     size_t const total_size = states_size + histories_size;
@@ -159,32 +345,12 @@ double *inform_local_entropy_rate(int const *series, size_t n, size_t m, int b,
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
 
-    inform_dist states    = { histogram_data, states_size, N };
-    inform_dist histories = { histogram_data + states_size, histories_size, N };
+    uint32_t *states    = histogram_data;
+    uint32_t *histories = states + states_size;
 
+    accumulate_uint32_t(series, m, b, k, 0, N, states, histories);
+    local_values(series, n, m, b, k, states, histories, er);
 
-    int *state_data = malloc(2 * N * sizeof(uint64_t));
-    if (state_data == NULL)
-    {
-        if (allocate_er) free(er);
-        free(histogram_data);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
-    }
-    int *state = state_data;
-    int *history = state + N;
-
-    accumulate_local_observations(series, n, m, b, k, &states, &histories,
-        state, history);
-
-    double s, h;
-    for (size_t i = 0; i < N; ++i)
-    {
-        s = states.histogram[state[i]];
-        h = histories.histogram[history[i]];
-        er[i] = log2(h/s);
-    }
-
-    free(state_data);
     free(histogram_data);
 
     return er;
@@ -6,6 +6,7 @@
 #include <inform/mutual_info.h>
 #include <inform/utilities/black_boxing.h>
 #include <math.h>
+#include "xlogx.h"
 
 static void accumulate_observations(int const *src, int const *dst,
     int const *back, size_t l_src, size_t l_dst, size_t l_back,
@@ -197,44 +198,12 @@ double inform_information_flow(int const *src, int const *dst, int const *back,
     accumulate_observations(src, dst, back, l_src, l_dst, l_back, n, m, b,
         &joint, &as, &bs, &s);
 
-    double flow = 0.0;
-    int bs_state, as_state, joint_state;
-    double ns, nbs, nas, njoint;
-    for (int s_state = 0; s_state < (int) s_size; ++s_state)
-    {
-        ns = s.histogram[s_state];
-        if (ns == 0)
-        {
-            continue;
-        }
-        for (int b_state = 0; b_state < (int) b_size; ++b_state)
-        {
-            bs_state = b_state * s_size + s_state;
-            nbs = bs.histogram[bs_state];
-            if (nbs == 0)
-            {
-                continue;
-            }
-            for (int a_state = 0; a_state < (int) a_size; ++a_state)
-            {
-                as_state = a_state * s_size + s_state;
-                nas = as.histogram[as_state];
-                if (nas == 0)
-                {
-                    continue;
-                }
-                joint_state = a_state * bs_size + bs_state;
-                njoint = joint.histogram[joint_state];
-                if (njoint == 0)
-                {
-                    continue;
-                }
-                flow += njoint * log2((njoint * ns) / (nas * nbs));
-            }
-        }
-    }
+    double const flow = (inform_xlogx_sum(joint.histogram, joint.size)
+        + inform_xlogx_sum(s.histogram, s.size)
+        - inform_xlogx_sum(as.histogram, as.size)
+        - inform_xlogx_sum(bs.histogram, bs.size)) / N;
 
     free(data);
 
-    return flow / N;
+    return flow;
 }
@@ -5,6 +5,11 @@
 #include <inform/mutual_info.h>
 #include <inform/utilities.h>
 #include <math.h>
+#include <stdint.h>
+#include "parallel.h"
+
+/// the most memory given to the local entropies of the subsets of the series
+#define INFORM_INTEGRATION_CACHE_BYTES ((size_t) 1 << 31)
 
 static bool check_arguments(int const *series, size_t l, inform_error *err)
 {
@@ -21,37 +26,103 @@ static bool check_arguments(int const *series, size_t l, inform_error *err)
     return false;
 }
 
-double *inform_integration_evidence(int const *series, size_t l, size_t n,
-    int const *b, double *evidence, inform_error *err)
+/**
+ * Check the series, bases and states as `inform_black_box_parts` would.
+ */
+static bool check_series(int const *series, size_t l, size_t n, int const *b,
+    inform_error *err)
 {
-    if (check_arguments(series, l, err))
+    if (n == 0)
     {
-        return NULL;
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, true);
     }
-    int allocate = (evidence == NULL);
-    if (allocate)
+    else if (b == NULL)
     {
-        evidence = malloc(2 * n * sizeof(double));
-        if (evidence == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
+    }
+    double bits = 0.0;
+    for (size_t i = 0; i < l; ++i)
+    {
+        if (b[i] < 2)
         {
-            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+            INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
         }
+        bits += log2(b[i]);
     }
-    double *lmi = malloc(n * sizeof(double));
-    if (lmi == NULL)
+    if (bits > 30.0)
     {
-        if (allocate) free(evidence);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
     }
-    double *minimum = evidence;
-    double *maximum = minimum + n;
-    for (size_t i = 0; i < n; ++i)
+    for (size_t i = 0; i < l; ++i)
     {
-        minimum[i] = INFINITY;
-        maximum[i] = -INFINITY;
+        for (size_t j = 0; j < n; ++j)
+        {
+            if (series[n*i + j] < 0)
+            {
+                INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
+            }
+            else if (series[n*i + j] >= b[i])
+            {
+                INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Compute the local entropy of the joint state of the series whose bits are
+ * set in `mask` at each of the `n` time steps, using `state` as scratch.
+ *
+ * @return `false` if the histogram could not be allocated
+ */
+static bool local_block_entropy(int const *series, size_t l, size_t n,
+    int const *b, size_t mask, int *state, double *h)
+{
+    size_t size = 1;
+    for (size_t j = 0; j < n; ++j) state[j] = 0;
+    for (size_t i = 0; i < l; ++i)
+    {
+        if (mask & ((size_t) 1 << i))
+        {
+            for (size_t j = 0; j < n; ++j)
+            {
+                state[j] = state[j] * b[i] + series[n*i + j];
+            }
+            size *= b[i];
+        }
     }
 
+    uint32_t *counts = calloc(size, sizeof(uint32_t));
+    if (counts == NULL)
+    {
+        return false;
+    }
+    for (size_t j = 0; j < n; ++j) counts[state[j]]++;
+    for (size_t j = 0; j < n; ++j) h[j] = log2((double) n / counts[state[j]]);
+    free(counts);
+
+    return true;
+}
+
+/**
+ * Compute the evidence of integration for every partitioning by calling
+ * `inform_integration_evidence_part` on each in turn. This is used when the
+ * local entropies of every subset of the series would not fit in memory.
+ */
+static bool integration_evidence_by_parts(int const *series, size_t l,
+    size_t n, int const *b, double *minimum, double *maximum,
+    inform_error *err)
+{
+    double *lmi = malloc(n * sizeof(double));
     size_t *parts = inform_first_partitioning(l);
+    if (lmi == NULL || parts == NULL)
+    {
+        free(parts);
+        free(lmi);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, false);
+    }
+
     size_t nparts = 1;
     while ((nparts = inform_next_partitioning(parts, l)))
     {
@@ -68,7 +139,173 @@ double *inform_integration_evidence(int const *series, size_t l, size_t n,
     }
     free(parts);
     free(lmi);
-    
+
+    return inform_succeeded(err);
+}
+
+/**
+ * Compute the evidence of integration for every partitioning from the local
+ * entropies of its parts. The local mutual information of a partitioning is
+ * the sum of the local entropies of its parts less that of the whole, and a
+ * given part recurs across many partitionings, so the local entropy of every
+ * subset of the series is computed once, indexed by its bitmask, and the
+ * partitionings are then split by rank between the available threads.
+ *
+ * @return `false` if the local entropies would exceed
+ * `INFORM_INTEGRATION_CACHE_BYTES` or could not be allocated
+ */
+static bool integration_evidence_by_subsets(int const *series, size_t l,
+    size_t n, int const *b, double *minimum, double *maximum,
+    inform_error *err)
+{
+    size_t const subsets = (size_t) 1 << l;
+    size_t const partitionings = inform_count_partitionings(l, 0);
+    if (subsets > INFORM_INTEGRATION_CACHE_BYTES / sizeof(double) / n ||
+        partitionings == SIZE_MAX)
+    {
+        return false;
+    }
+    double *entropy = malloc(subsets * n * sizeof(double));
+    if (entropy == NULL)
+    {
+        return false;
+    }
+
+    size_t chunks = inform_parallel_chunks(subsets * n, 2 * n);
+    if (chunks > partitionings - 1)
+    {
+        chunks = partitionings - 1;
+    }
+    double *bounds = (chunks == 1) ? NULL
+        : malloc(2 * (chunks - 1) * n * sizeof(double));
+    int *state = malloc(chunks * n * sizeof(int));
+    if ((chunks > 1 && bounds == NULL) || state == NULL)
+    {
+        free(state);
+        free(bounds);
+        free(entropy);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+
+    bool failed = false;
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) num_threads(chunks) \
+        schedule(static) reduction(||:failed)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        size_t begin, end;
+        inform_parallel_range(subsets - 1, c, chunks, &begin, &end);
+        for (size_t mask = begin + 1; mask < end + 1 && !failed; ++mask)
+        {
+            failed = !local_block_entropy(series, l, n, b, mask, state + c*n,
+                entropy + mask*n);
+        }
+    }
+
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1 && !failed) num_threads(chunks) \
+        schedule(static) reduction(||:failed)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        double *lower = (c == 0) ? minimum : bounds + 2 * (c - 1) * n;
+        double *upper = (c == 0) ? maximum : lower + n;
+        for (size_t i = 0; i < n; ++i)
+        {
+            lower[i] = INFINITY;
+            upper[i] = -INFINITY;
+        }
+
+        // every partitioning but the first, which has a single part
+        size_t begin, end;
+        inform_parallel_range(partitionings - 1, c, chunks, &begin, &end);
+        size_t *parts = inform_unrank_partitioning(begin + 1, l, 0, NULL);
+        size_t *masks = malloc(l * sizeof(size_t));
+        failed = failed || parts == NULL || masks == NULL;
+
+        double const *whole = entropy + (subsets - 1) * n;
+        for (size_t p = begin; !failed && p < end; ++p)
+        {
+            size_t nparts = 0;
+            for (size_t i = 0; i < l; ++i) masks[i] = 0;
+            for (size_t i = 0; i < l; ++i)
+            {
+                masks[parts[i]] |= (size_t) 1 << i;
+                nparts = MAX(nparts, parts[i] + 1);
+            }
+
+            for (size_t j = 0; j < n; ++j)
+            {
+                double lmi = -whole[j];
+                for (size_t i = 0; i < nparts; ++i)
+                {
+                    lmi += entropy[masks[i] * n + j];
+                }
+                lower[j] = MIN(lower[j], lmi);
+                upper[j] = MAX(upper[j], lmi);
+            }
+            inform_next_partitioning(parts, l);
+        }
+
+        free(masks);
+        free(parts);
+    }
+
+    if (failed)
+    {
+        INFORM_ERROR(err, INFORM_ENOMEM);
+    }
+    else
+    {
+        for (size_t c = 1; c < chunks; ++c)
+        {
+            double const *lower = bounds + 2 * (c - 1) * n;
+            double const *upper = lower + n;
+            for (size_t i = 0; i < n; ++i)
+            {
+                minimum[i] = MIN(minimum[i], lower[i]);
+                maximum[i] = MAX(maximum[i], upper[i]);
+            }
+        }
+    }
+
+    free(state);
+    free(bounds);
+    free(entropy);
+
+    return true;
+}
+
+double *inform_integration_evidence(int const *series, size_t l, size_t n,
+    int const *b, double *evidence, inform_error *err)
+{
+    if (check_arguments(series, l, err) || check_series(series, l, n, b, err))
+    {
+        return NULL;
+    }
+    int allocate = (evidence == NULL);
+    if (allocate)
+    {
+        evidence = malloc(2 * n * sizeof(double));
+        if (evidence == NULL)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+    double *minimum = evidence;
+    double *maximum = minimum + n;
+    for (size_t i = 0; i < n; ++i)
+    {
+        minimum[i] = INFINITY;
+        maximum[i] = -INFINITY;
+    }
+
+    if (!integration_evidence_by_subsets(series, l, n, b, minimum, maximum, err))
+    {
+        integration_evidence_by_parts(series, l, n, b, minimum, maximum, err);
+    }
+
     if (inform_failed(err))
     {
         if (allocate)
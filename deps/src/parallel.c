@@ -0,0 +1,29 @@
+// Copyright 2016-2019 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "parallel.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/// the fewest observations for which a thread is worth starting
+#define INFORM_PARALLEL_GRAIN (1 << 16)
+
+size_t inform_parallel_chunks(size_t N, size_t size)
+{
+#ifdef _OPENMP
+    size_t chunks = (size_t) omp_get_max_threads();
+    if (chunks > N / INFORM_PARALLEL_GRAIN)
+    {
+        chunks = N / INFORM_PARALLEL_GRAIN;
+    }
+    if (size != 0 && chunks > N / size)
+    {
+        chunks = N / size;
+    }
+    return (chunks < 1) ? 1 : chunks;
+#else
+    return 1;
+#endif
+}
@@ -0,0 +1,31 @@
+// Copyright 2016-2019 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Determine how many chunks to split `N` observations into when counting
+ * them into histograms with a total of `size` bins. Each chunk is counted
+ * into its own copy of the histograms, on its own thread, and the copies are
+ * then merged with `inform_counts_merge`.
+ *
+ * This is always 1 unless Inform is built with OpenMP. Otherwise, it is
+ * bounded by the number of OpenMP threads, by the number of observations
+ * each thread should have to be worth starting, and by `N / size`, so that
+ * the copies never outweigh the series.
+ */
+size_t inform_parallel_chunks(size_t N, size_t size);
+
+/**
+ * The observations `[begin, end)` of chunk `c` of `chunks`, where the
+ * observations are numbered consecutively across `N` of them.
+ */
+inline static void inform_parallel_range(size_t N, size_t c, size_t chunks,
+    size_t *begin, size_t *end)
+{
+    *begin = (N / chunks) * c + ((c < N % chunks) ? c : N % chunks);
+    *end = *begin + N / chunks + ((c < N % chunks) ? 1 : 0);
+}
@@ -7,8 +7,18 @@
 #include <inform/utilities.h>
 #include <inform/utilities/black_boxing.h>
 #include <inform/utilities/encoding.h>
+#include <stdint.h>
 #include <string.h>
 #include <math.h>
+#include "counts.h"
+#include "parallel.h"
+
+/// the most memory given to the histograms of all subsets of the responses
+#define INFORM_PID_HISTOGRAM_BYTES ((size_t) 1 << 31)
+
+/// the most responses whose lattice can be built, as each node holds a set
+/// of the subsets of the responses in 64 bits
+#define INFORM_PID_MAX_RESPONSES 6
 
 #define FAILED(ERR) ((ERR) && *(ERR) != INFORM_SUCCESS)
 
@@ -36,247 +46,130 @@ static TYPE* NAME(TYPE* xs, TYPE x) \
 }
 
 MAKE_PUSH(push_value, size_t)
-MAKE_PUSH(push_source, inform_pid_source*)
 
-static void free_source(inform_pid_source *src)
+/**
+ * A growable array of the nodes of a lattice under construction. Each node
+ * is an antichain of subsets of the responses held as a bitset, so that
+ * subset `x` belongs to node `a` if bit `x` of `a` is set.
+ */
+typedef struct node_list
 {
-    if (src)
-    {
-        gvector_free(src->name);
-        gvector_free(src->above);
-        gvector_free(src->below);
-        free(src);
-    }
-}
+    uint64_t *nodes;
+    size_t size, capacity;
+} node_list;
 
-static void free_all_sources(inform_pid_source **srcs)
+static bool push_node(node_list *list, uint64_t node)
 {
-    if (srcs)
+    if (list->size == list->capacity)
     {
-        for (size_t i = 0; i < gvector_len(srcs); ++i)
+        size_t const capacity = (list->capacity) ? 2 * list->capacity : 64;
+        uint64_t *nodes = realloc(list->nodes, capacity * sizeof(uint64_t));
+        if (nodes == NULL)
         {
-            free_source(srcs[i]);
+            return false;
         }
-        gvector_free(srcs);
+        list->nodes = nodes;
+        list->capacity = capacity;
     }
+    list->nodes[list->size++] = node;
+    return true;
 }
 
-static inform_pid_source *alloc_source(size_t *name,
-        inform_error *err)
+/**
+ * Extend the antichain `c` with each subset from `i` to `m` that is not
+ * comparable to any of its elements, recording each antichain produced.
+ */
+static bool antichains_rec(size_t i, size_t m, uint64_t c,
+        uint64_t const *comparable, node_list *list)
 {
-    if (!name)
-    {
-        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
-    }
-
-    inform_pid_source *src = malloc(sizeof(inform_pid_source));
-    if (!src)
-    {
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
-    }
-
-    src->name = NULL;
-    src->above = src->below = NULL;
-
-    size_t *local_name = gvector_dup(name);
-    if (!local_name)
+    if (i < m && !antichains_rec(i + 1, m, c, comparable, list))
     {
-        free_source(src);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        return false;
     }
-    src->name = local_name;
-
-    local_name = gvector_shrink(src->name);
-    if (!local_name)
+    if (i <= m && (c & comparable[i]) == 0)
     {
-        free_source(src);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        c |= (uint64_t) 1 << i;
+        return push_node(list, c) &&
+            antichains_rec(i + 1, m, c, comparable, list);
     }
-    src->name = local_name;
-    src->size = gvector_len(src->name);
-
-    src->above = gvector_alloc(0, 0, sizeof(inform_pid_source*));
-    if (!src->above)
-    {
-        free_source(src);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
-    }
-    src->n_above = 0;
-
-    src->below = gvector_alloc(0, 0, sizeof(inform_pid_source*));
-    if (!src->below)
-    {
-        free_source(src);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
-    }
-    src->n_below = 0;
-
-    src->imin = src->pi = 0.0;
-
-    return src;
+    return true;
 }
 
-static inform_pid_source **sources_rec(size_t i, size_t m, size_t *c,
-        inform_pid_source **srcs, inform_error *err)
+/**
+ * Enumerate the nodes of the lattice of `l` responses, and for each the set
+ * of subsets which are supersets of one of its elements.
+ */
+static bool antichains(size_t l, node_list *list, uint64_t **upsets)
 {
-    if (!c || !srcs)
-    {
-        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
-    }
-
-    if (i < m)
-    {
-        size_t *d = gvector_dup(c);
-        if (!d)
-        {
-            gvector_free(c);
-            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, srcs);
-        }
-        srcs = sources_rec(i + 1, m, d, srcs, err);
-        if (FAILED(err))
-        {
-            gvector_free(c);
-            return srcs;
-        }
-    }
-
-    if (i <= m)
+    size_t const m = ((size_t) 1 << l) - 1;
+    uint64_t comparable[64] = {0}, up[64] = {0};
+    for (size_t x = 1; x <= m; ++x)
     {
-        size_t z = 0;
-        for (size_t j = 0; j < gvector_len(c); ++j)
+        for (size_t y = 1; y <= m; ++y)
         {
-            z = i & c[j];
-            if (z == i || z == c[j])
+            if ((x & y) == x || (x & y) == y)
             {
-                gvector_free(c);
-                return srcs;
+                comparable[x] |= (uint64_t) 1 << y;
+            }
+            if ((x & y) == x)
+            {
+                up[x] |= (uint64_t) 1 << y;
             }
         }
-
-        size_t *d = push_value(c, i);
-        if (!d)
-        {
-            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, srcs);
-        }
-        c = d;
-
-        inform_pid_source *src = alloc_source(c, err);
-        if (FAILED(err))
-        {
-            gvector_free(c);
-            return srcs;
-        }
-
-        inform_pid_source **ts = push_source(srcs, src);
-        if (!ts)
-        {
-            free_source(src);
-            gvector_free(c);
-            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, srcs);
-        }
-        srcs = ts;
-
-        return sources_rec(i + 1, m, c, srcs, err);
-    }
-    else
-    {
-        gvector_free(c);
     }
 
-    return srcs;
-}
-
-static inform_pid_source **sources(size_t n, inform_error *err)
-{
-    if (n < 1)
-    {
-        INFORM_ERROR_RETURN(err, INFORM_ENOSOURCES, NULL);
-    }
-    size_t const m = (1 << n) - 1;
-    inform_pid_source **srcs = gvector_alloc(0, 0, sizeof(inform_pid_source*));
-    if (!srcs)
-    {
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
-    }
     for (size_t i = 1; i <= m; ++i)
     {
-        size_t *c = gvector_alloc(1, 1, sizeof(size_t));
-        if (!c)
-        {
-            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
-        }
-        c[0] = i;
-
-        inform_pid_source *src = alloc_source(c, err);
-        if (FAILED(err))
-        {
-            gvector_free(c);
-            return NULL;
-        }
-
-        inform_pid_source **ts = push_source(srcs, src);
-        if (!ts)
-        {
-            free_source(src);
-            free_all_sources(srcs);
-            gvector_free(c);
-            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
-        }
-        srcs = ts;
-
-        srcs = sources_rec(i + 1, m, c, srcs, err);
-        if (FAILED(err))
+        uint64_t const c = (uint64_t) 1 << i;
+        if (!push_node(list, c) || !antichains_rec(i + 1, m, c, comparable,
+            list))
         {
-            free_all_sources(srcs);
-            return NULL;
+            return false;
         }
     }
 
-    inform_pid_source **ts = gvector_shrink(srcs);
-    if (!ts)
+    *upsets = malloc(list->size * sizeof(uint64_t));
+    if (*upsets == NULL)
     {
-        free_all_sources(srcs);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        return false;
     }
-    return ts;
-}
-
-static bool name_below(size_t const *xs, size_t const *ys)
-{
-    size_t const m = gvector_len(xs);
-    size_t const n = gvector_len(ys);
-
-    bool is_below = true;
-    for (size_t const *y = ys; y < ys + n && is_below; ++y)
+    for (size_t i = 0; i < list->size; ++i)
     {
-        bool is_valid = false;
-        for (size_t const *x = xs; x < xs + m && !is_valid; ++x)
+        (*upsets)[i] = 0;
+        for (size_t x = 1; x <= m; ++x)
         {
-            if ((*x & *y) == *x)
+            if (list->nodes[i] & ((uint64_t) 1 << x))
             {
-                is_valid = true;
+                (*upsets)[i] |= up[x];
             }
         }
-        if (!is_valid)
-        {
-            is_below = false;
-        }
     }
-    return is_below;
+    return true;
 }
 
-static bool below(inform_pid_source const *a, inform_pid_source const *b)
+/**
+ * Is node `a` below node `b`, i.e. does every element of `b` contain an
+ * element of `a`?
+ */
+inline static bool below(uint64_t const *nodes, uint64_t const *upsets,
+        size_t a, size_t b)
 {
-    return name_below(a->name, b->name);
+    return (nodes[b] & ~upsets[a]) == 0;
 }
 
-static void toposort(inform_pid_source **srcs, inform_error *err)
+inline static void swap_nodes(uint64_t *nodes, uint64_t *upsets, size_t i,
+        size_t j)
+{
+    uint64_t tmp = nodes[i];
+    nodes[i] = nodes[j];
+    nodes[j] = tmp;
+    tmp = upsets[i];
+    upsets[i] = upsets[j];
+    upsets[j] = tmp;
+}
+
+static void toposort(uint64_t *nodes, uint64_t *upsets, size_t n)
 {
-    if (!srcs)
-    {
-        INFORM_ERROR_RETURN_VOID(err, INFORM_EARG);
-    }
-    size_t const n = gvector_len(srcs);
     size_t u = 0, v = 0;
     while (v < n - 1)
     {
@@ -286,7 +179,7 @@ static void toposort(inform_pid_source **srcs, inform_error *err)
             bool is_bottom = true;
             for (size_t j = u; j < n; ++j)
             {
-                if (i != j && below(srcs[j], srcs[i]))
+                if (i != j && below(nodes, upsets, j, i))
                 {
                     is_bottom = false;
                     break;
@@ -294,75 +187,39 @@ static void toposort(inform_pid_source **srcs, inform_error *err)
             }
             if (is_bottom)
             {
-                inform_pid_source *tmp = srcs[v];
-                srcs[v] = srcs[i];
-                srcs[i] = tmp;
+                swap_nodes(nodes, upsets, v, i);
                 v += 1;
             }
         }
     }
 }
 
-static inform_pid_lattice *inform_pid_lattice_alloc(inform_error *err)
+/**
+ * Find the covering relations between the sorted nodes, as a flat array of
+ * (lower, upper) index pairs ordered by the lower node, counting the nodes
+ * above and below each node.
+ */
+static size_t *covers(uint64_t const *nodes, uint64_t const *upsets,
+        size_t n, size_t *n_above, size_t *n_below, size_t *n_edges)
 {
-    inform_pid_lattice *lattice = malloc(sizeof(inform_pid_lattice));
-    if (!lattice)
-    {
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
-    }
-
-    lattice->sources = NULL;
-    lattice->top = NULL;
-    lattice->bottom = NULL;
-
-    return lattice;
-}
-
-void inform_pid_lattice_free(inform_pid_lattice *lattice)
-{
-    if (lattice)
-    {
-        free_all_sources(lattice->sources);
-
-        lattice->sources = NULL;
-        lattice->top = NULL;
-        lattice->bottom = NULL;
-
-        free(lattice);
-    }
-}
-
-static inform_pid_lattice *build_hasse(inform_pid_source **srcs,
-        inform_error *err)
-{
-    if (!srcs)
-    {
-        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
-    }
-
-    size_t const n = gvector_len(srcs);
-    if (n == 0)
-    {
-        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
-    }
-
-    inform_pid_lattice *lattice = inform_pid_lattice_alloc(err);
-    if (FAILED(err))
+    size_t capacity = 2 * n;
+    size_t *edges = malloc(2 * capacity * sizeof(size_t));
+    if (edges == NULL)
     {
         return NULL;
     }
-
+    *n_edges = 0;
     for (size_t i = 0; i < n; ++i)
     {
+        size_t const first = *n_edges;
         for (size_t j = i + 1; j < n; ++j)
         {
-            if (below(srcs[i], srcs[j]))
+            if (below(nodes, upsets, i, j))
             {
                 bool stop = false;
-                for (size_t k = 0; k < gvector_len(srcs[i]->above); ++k)
+                for (size_t k = 0; k < n_above[i]; ++k)
                 {
-                    inform_pid_source *x = srcs[i]->above[k];
-                    if (below(x, srcs[j]))
+                    if (below(nodes, upsets, edges[2 * (first + k) + 1], j))
                     {
                         stop = true;
                         break;
@@ -372,62 +229,182 @@ static inform_pid_lattice *build_hasse(inform_pid_source **srcs,
                 {
                     break;
                 }
-                else
+                if (*n_edges == capacity)
                 {
-                    inform_pid_source **above, **below;
-
-                    above = push_source(srcs[i]->above, srcs[j]);
-                    if (!above)
-                    {
-                        free_all_sources(srcs);
-                        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
-                    }
-                    srcs[i]->above = above;
-                    srcs[i]->n_above++;
-
-                    below = push_source(srcs[j]->below, srcs[i]);
-                    if (!below)
+                    capacity *= 2;
+                    size_t *grown = realloc(edges,
+                        2 * capacity * sizeof(size_t));
+                    if (grown == NULL)
                     {
-                        free_all_sources(srcs);
-                        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+                        free(edges);
+                        return NULL;
                     }
-                    srcs[j]->below = below;
-                    srcs[j]->n_below++;
+                    edges = grown;
                 }
+                edges[2 * (*n_edges)] = i;
+                edges[2 * (*n_edges) + 1] = j;
+                *n_edges += 1;
+                n_above[i]++;
+                n_below[j]++;
             }
         }
     }
+    return edges;
+}
 
-    lattice->sources = srcs;
-    lattice->bottom = srcs[0];
-    lattice->top = srcs[n-1];
-    lattice->size = gvector_len(lattice->sources);
+/**
+ * Round a size up so that whatever follows it in an arena is aligned.
+ */
+inline static size_t arena_align(size_t size)
+{
+    size_t const a = (sizeof(double) > sizeof(void*)) ?
+        sizeof(double) : sizeof(void*);
+    return (size + a - 1) / a * a;
+}
 
-    return lattice;
+inline static size_t vector_bytes(size_t length, size_t size)
+{
+    return arena_align(sizeof(struct gvector_header) + length * size);
 }
 
-static inform_pid_lattice *hasse(size_t n, inform_error *err)
+/**
+ * Lay out a `gvector` of `length` elements of `size` bytes at `*cursor`,
+ * advancing the cursor past it.
+ */
+static void *arena_vector(char **cursor, size_t length, size_t size)
 {
-    inform_pid_source **srcs = sources(n, err);
-    if (FAILED(err))
+    struct gvector_header *header = (struct gvector_header*) *cursor;
+    header->capacity = header->length = length;
+    header->size = size;
+    *cursor += vector_bytes(length, size);
+    return header + 1;
+}
+
+/**
+ * Lay the lattice out in a single block: the lattice itself, the vector of
+ * its sources, the sources, and then the name, above and below vectors of
+ * each source.
+ */
+static inform_pid_lattice *layout(uint64_t const *nodes, size_t n,
+        size_t m, size_t const *edges, size_t n_edges, size_t const *n_above,
+        size_t const *n_below)
+{
+    size_t bytes = arena_align(sizeof(inform_pid_lattice))
+        + vector_bytes(n, sizeof(inform_pid_source*))
+        + arena_align(n * sizeof(inform_pid_source));
+    for (size_t i = 0; i < n; ++i)
     {
-        return NULL;
+        size_t size = 0;
+        for (size_t x = 1; x <= m; ++x)
+        {
+            size += (nodes[i] >> x) & 1;
+        }
+        bytes += vector_bytes(size, sizeof(size_t))
+            + vector_bytes(n_above[i], sizeof(inform_pid_source*))
+            + vector_bytes(n_below[i], sizeof(inform_pid_source*));
     }
 
-    toposort(srcs, err);
-    if (FAILED(err))
+    char *cursor = malloc(bytes);
+    if (cursor == NULL)
     {
         return NULL;
     }
+    inform_pid_lattice *lattice = (inform_pid_lattice*) cursor;
+    cursor += arena_align(sizeof(inform_pid_lattice));
+    lattice->sources = arena_vector(&cursor, n, sizeof(inform_pid_source*));
+    inform_pid_source *srcs = (inform_pid_source*) cursor;
+    cursor += arena_align(n * sizeof(inform_pid_source));
 
-    inform_pid_lattice *lattice = build_hasse(srcs, err);
-    if (FAILED(err))
+    for (size_t i = 0; i < n; ++i)
     {
-        return NULL;
+        inform_pid_source *src = lattice->sources[i] = srcs + i;
+        src->size = 0;
+        for (size_t x = 1; x <= m; ++x)
+        {
+            src->size += (nodes[i] >> x) & 1;
+        }
+        src->name = arena_vector(&cursor, src->size, sizeof(size_t));
+        for (size_t x = 1, k = 0; x <= m; ++x)
+        {
+            if ((nodes[i] >> x) & 1)
+            {
+                src->name[k++] = x;
+            }
+        }
+        src->n_above = n_above[i];
+        src->above = arena_vector(&cursor, n_above[i],
+            sizeof(inform_pid_source*));
+        gvector_len(src->above) = 0;
+        src->n_below = n_below[i];
+        src->below = arena_vector(&cursor, n_below[i],
+            sizeof(inform_pid_source*));
+        gvector_len(src->below) = 0;
+        src->imin = src->pi = 0.0;
     }
+    // the edges fill the above and below vectors back up to their capacity
+    for (size_t e = 0; e < n_edges; ++e)
+    {
+        inform_pid_source *lower = srcs + edges[2*e];
+        inform_pid_source *upper = srcs + edges[2*e + 1];
+        lower->above[gvector_len(lower->above)++] = upper;
+        upper->below[gvector_len(upper->below)++] = lower;
+    }
+
+    lattice->bottom = srcs;
+    lattice->top = srcs + (n - 1);
+    lattice->size = n;
+
     return lattice;
 }
 
+inform_pid_lattice *inform_pid_lattice_alloc(size_t l, inform_error *err)
+{
+    if (l < 1)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOSOURCES, NULL);
+    }
+    else if (l > INFORM_PID_MAX_RESPONSES)
+    {
+        // the lattice of 7 responses has over 10^12 nodes
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+
+    node_list list = { NULL, 0, 0 };
+    uint64_t *upsets = NULL;
+    if (!antichains(l, &list, &upsets))
+    {
+        free(upsets);
+        free(list.nodes);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    size_t const n = list.size;
+    toposort(list.nodes, upsets, n);
+
+    size_t n_edges = 0;
+    size_t *counts = calloc(2 * n, sizeof(size_t));
+    size_t *edges = (counts == NULL) ? NULL :
+        covers(list.nodes, upsets, n, counts, counts + n, &n_edges);
+    inform_pid_lattice *lattice = (edges == NULL) ? NULL :
+        layout(list.nodes, n, ((size_t) 1 << l) - 1, edges, n_edges, counts,
+            counts + n);
+
+    free(edges);
+    free(counts);
+    free(upsets);
+    free(list.nodes);
+
+    if (lattice == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    return lattice;
+}
+
+void inform_pid_lattice_free(inform_pid_lattice *lattice)
+{
+    free(lattice);
+}
+
 static size_t **subsets(size_t n, inform_error *err)
 {
     if (n < 1)
@@ -488,8 +465,72 @@ static size_t **subsets(size_t n, inform_error *err)
     return ss;
 }
 
+static void cleanup(size_t **subsets, inform_dist *s_dist, double **info)
+{
+    if (subsets)
+    {
+        for (size_t i = 0; i < gvector_len(subsets); ++i)
+        {
+            gvector_free(subsets[i]);
+        }
+        gvector_free(subsets);
+    }
+
+    if (s_dist)
+    {
+        inform_dist_free(s_dist);
+    }
+
+    if (info)
+    {
+        for (size_t i = 0; i < gvector_len(info); ++i)
+        {
+            gvector_free(info[i]);
+        }
+        gvector_free(info);
+    }
+}
+
+/**
+ * Compute the specific information of each stimulus from the joint
+ * histogram of the stimulus and a (black-boxed) response with `b` states,
+ * stored stimulus-first, and the histogram of that response.
+ */
+static void specific_info_from_counts(uint32_t const *joint,
+        uint32_t const *response, int b, size_t n, int bs,
+        inform_dist const *s_dist, double *si)
+{
+    int joint_state;
+    double n_stimulus, n_response, n_joint;
+    for (int s = 0; s < bs; ++s)
+    {
+        si[s] = 0.0;
+        n_stimulus = s_dist->histogram[s];
+        if (n_stimulus == 0)
+        {
+            continue;
+        }
+        for (int r = 0; r < b; ++r)
+        {
+            n_response = response[r];
+            if (n_response == 0)
+            {
+                continue;
+            }
+            joint_state = s + bs * r;
+            n_joint = joint[joint_state];
+            if (n_joint == 0)
+            {
+                continue;
+            }
+            si[s] += n_joint * log2((n * n_joint) / (n_stimulus * n_response));
+        }
+        si[s] /= n_stimulus;
+    }
+}
+
 static double *specific_info(int const *stimulus, int const *responses,
-        size_t l, size_t n, int bs, int const *br, size_t const *source,
+        size_t n, int bs, int const *br, size_t const *source,
         inform_dist const *s_dist, inform_error *err)
 {
     size_t const u = gvector_len(source);
@@ -540,64 +581,175 @@ static double *specific_info(int const *stimulus, int const *responses,
         gvector_free(box);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
+    specific_info_from_counts(j_dist.histogram, r_dist.histogram, b, n, bs,
+        s_dist, si);
 
-    int joint;
-    double n_stimulus, n_response, n_joint;
-    for (int s = 0; s < bs; ++s)
+    gvector_free(data);
+    gvector_free(box);
+    return si;
+}
+
+/**
+ * Compute the specific information of every subset of the responses, one
+ * subset at a time, by black-boxing each of them.
+ */
+static void specific_info_by_subset(int const *stimulus,
+        int const *responses, size_t l, size_t n, int bs, int const *br,
+        inform_dist const *s_dist, double **si, inform_error *err)
+{
+    size_t **ss = subsets(l, err);
+    if (FAILED(err))
     {
-        si[s] = 0.0;
-        n_stimulus = s_dist->histogram[s];
-        if (n_stimulus == 0)
+        return;
+    }
+    for (size_t i = 0; i < gvector_len(ss); ++i)
+    {
+        si[i] = specific_info(stimulus, responses, n, bs, br, ss[i], s_dist,
+            err);
+        if (FAILED(err))
         {
-            continue;
+            break;
         }
-        for (int r = 0; r < b; ++r)
+    }
+    cleanup(ss, NULL, NULL);
+}
+
+/**
+ * Determine whether the histograms of every subset of the responses can be
+ * counted together by `specific_info_by_histograms`. Otherwise, the subsets
+ * are black-boxed one at a time, which also reports states that cannot be
+ * encoded.
+ */
+static bool shared_histograms_apply(size_t l, size_t n, int bs,
+        int const *br)
+{
+    double bits = 0.0, support = 1.0;
+    for (size_t i = 0; i < l; ++i)
+    {
+        bits += log2(br[i]);
+        support *= br[i] + 1.0;
+    }
+    double const bytes = (bs + 1.0) * (support - 1.0) * sizeof(uint32_t);
+    return n <= UINT32_MAX && bits <= 30.0 &&
+        bytes <= (double) INFORM_PID_HISTOGRAM_BYTES;
+}
+
+/**
+ * Count the responses of every subset of the responses, and their joint
+ * states with the stimulus, over the time steps `[begin, end)`.
+ *
+ * The state of each subset is encoded from that of the subset without its
+ * last response, so each time step costs a single pass over the subsets
+ * using `code` as scratch. The histograms of subset `mask` start at
+ * `offset[mask]`: the `support[mask]` response counts, followed by the
+ * joint counts.
+ */
+static void accumulate_subsets(int const *stimulus, int const *responses,
+        size_t l, size_t n, int bs, int const *br, size_t const *support,
+        size_t const *offset, size_t begin, size_t end, size_t *code,
+        uint32_t *counts)
+{
+    size_t const m = (size_t) 1 << l;
+    code[0] = 0;
+    for (size_t i = begin; i < end; ++i)
+    {
+        for (size_t mask = 1, j = 0; mask < m; ++mask)
         {
-            n_response = r_dist.histogram[r];
-            if (n_response == 0)
-            {
-                continue;
-            }
-            joint = s + bs * r;
-            n_joint = j_dist.histogram[joint];
-            if (n_joint == 0)
+            if (mask == (size_t) 2 << j)
             {
-                continue;
+                ++j;
             }
-            si[s] += n_joint * log2((n * n_joint) / (n_stimulus * n_response));
+            size_t const r = code[mask ^ ((size_t) 1 << j)] * br[j]
+                + responses[j*n + i];
+            uint32_t *histogram = counts + offset[mask];
+            histogram[r]++;
+            histogram[support[mask] + stimulus[i] + bs * r]++;
+            code[mask] = r;
         }
-        si[s] /= n_stimulus;
     }
-
-    gvector_free(data);
-    gvector_free(box);
-    return si;
 }
 
-static void cleanup(size_t **subsets, inform_dist *s_dist, double **info)
+/**
+ * Compute the specific information of every subset of the responses from
+ * histograms counted in a single pass over the time steps, split between
+ * the available threads, which then split the subsets between them.
+ */
+static void specific_info_by_histograms(int const *stimulus,
+        int const *responses, size_t l, size_t n, int bs, int const *br,
+        inform_dist const *s_dist, double **si, inform_error *err)
 {
-    if (subsets)
+    size_t const m = (size_t) 1 << l;
+    size_t *support = malloc((2 * m + 1) * sizeof(size_t));
+    if (support == NULL)
     {
-        for (size_t i = 0; i < gvector_len(subsets); ++i)
+        INFORM_ERROR_RETURN_VOID(err, INFORM_ENOMEM);
+    }
+    size_t *offset = support + m;
+    support[0] = 1;
+    offset[0] = offset[1] = 0;
+    for (size_t mask = 1, j = 0; mask < m; ++mask)
+    {
+        if (mask == (size_t) 2 << j)
         {
-            gvector_free(subsets[i]);
+            ++j;
         }
-        gvector_free(subsets);
+        support[mask] = support[mask ^ ((size_t) 1 << j)] * br[j];
+        offset[mask + 1] = offset[mask] + (bs + 1) * support[mask];
     }
+    size_t const total_size = offset[m];
 
-    if (s_dist)
+    size_t const chunks = inform_parallel_chunks(n, total_size);
+    uint32_t *counts = calloc(chunks * total_size, sizeof(uint32_t));
+    size_t *code = malloc(chunks * m * sizeof(size_t));
+    if (counts == NULL || code == NULL)
     {
-        inform_dist_free(s_dist);
+        free(code);
+        free(counts);
+        free(support);
+        INFORM_ERROR_RETURN_VOID(err, INFORM_ENOMEM);
+    }
+    for (size_t mask = 1; mask < m; ++mask)
+    {
+        si[mask - 1] = gvector_alloc(bs, bs, sizeof(double));
+        if (si[mask - 1] == NULL)
+        {
+            free(code);
+            free(counts);
+            free(support);
+            INFORM_ERROR_RETURN_VOID(err, INFORM_ENOMEM);
+        }
     }
 
-    if (info)
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
     {
-        for (size_t i = 0; i < gvector_len(info); ++i)
+        size_t begin, end;
+        inform_parallel_range(n, c, chunks, &begin, &end);
+        accumulate_subsets(stimulus, responses, l, n, bs, br, support, offset,
+            begin, end, code + c * m, counts + c * total_size);
+    }
+    inform_counts_merge(counts, sizeof(uint32_t), total_size, chunks);
+
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        size_t begin, end;
+        inform_parallel_range(m - 1, c, chunks, &begin, &end);
+        for (size_t mask = begin + 1; mask < end + 1; ++mask)
         {
-            gvector_free(info[i]);
+            uint32_t const *response = counts + offset[mask];
+            specific_info_from_counts(response + support[mask], response,
+                (int) support[mask], n, bs, s_dist, si[mask - 1]);
         }
-        gvector_free(info);
     }
+
+    free(code);
+    free(counts);
+    free(support);
 }
 
 static bool check_arguments( int const *stimulus, int const *responses, size_t l, size_t n,
@@ -636,54 +788,68 @@ static bool check_arguments( int const *stimulus, int const *responses, size_t l
 
 inform_pid_lattice *inform_pid(int const *stimulus, int const *responses,
         size_t l, size_t n, int bs, int const *br, inform_error *err)
+{
+    return inform_pid_into(stimulus, responses, l, n, bs, br, NULL, err);
+}
+
+inform_pid_lattice *inform_pid_into(int const *stimulus,
+        int const *responses, size_t l, size_t n, int bs, int const *br,
+        inform_pid_lattice *lattice, inform_error *err)
 {
     if (check_arguments(stimulus, responses, l, n, bs, br, err))
     {
         return NULL;
     }
-    size_t **ss = subsets(l, err);
-    if (FAILED(err))
+    size_t const m = ((size_t) 1 << l) - 1;
+    if (lattice != NULL && (l > INFORM_PID_MAX_RESPONSES ||
+        lattice->top->size != 1 || lattice->top->name[0] != m))
     {
-        return NULL;
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
     }
 
-    size_t const m = gvector_len(ss);
-
     inform_dist *s_dist = inform_dist_infer(stimulus, n);
     if (s_dist == NULL)
     {
-        cleanup(ss, NULL, NULL);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
 
     double **si = gvector_alloc(m, m, sizeof(double*));
     if (si == NULL)
     {
-        cleanup(ss, s_dist, si);
+        cleanup(NULL, s_dist, si);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
     for (size_t i = 0; i < m; ++i) si[i] = NULL;
-    for (size_t i = 0; i < m; ++i)
+    if (shared_histograms_apply(l, n, bs, br))
     {
-        si[i] = specific_info(stimulus, responses, l, n, bs, br, ss[i], s_dist, err);
-        if (FAILED(err))
-        {
-            cleanup(ss, s_dist, si);
-            return NULL;
-        }
+        specific_info_by_histograms(stimulus, responses, l, n, bs, br, s_dist,
+            si, err);
+    }
+    else
+    {
+        specific_info_by_subset(stimulus, responses, l, n, bs, br, s_dist, si,
+            err);
     }
-
-    inform_pid_lattice *lattice = hasse(l, err);
     if (FAILED(err))
     {
-        cleanup(ss, s_dist, si);
+        cleanup(NULL, s_dist, si);
         return NULL;
     }
 
+    if (lattice == NULL)
+    {
+        lattice = inform_pid_lattice_alloc(l, err);
+        if (FAILED(err))
+        {
+            cleanup(NULL, s_dist, si);
+            return NULL;
+        }
+    }
+
     for (size_t i = 0; i < lattice->size; ++i)
     {
         inform_pid_source *alpha = lattice->sources[i];
-        alpha->imin = 0.0;
+        alpha->imin = alpha->pi = 0.0;
         for (size_t s = 0; s < (size_t)bs; ++s)
         {
             double x = si[alpha->name[0]-1][s];
@@ -721,7 +887,7 @@ inform_pid_lattice *inform_pid(int const *stimulus, int const *responses,
         alpha->pi = alpha->imin - alpha->pi / s_dist->counts;
     }
 
-    cleanup(ss, s_dist, si);
+    cleanup(NULL, s_dist, si);
 
     return lattice;
 }
@@ -3,21 +3,102 @@
 // license that can be found in the LICENSE file.
 #include <inform/predictive_info.h>
 #include <inform/shannon.h>
+#include "counts.h"
+#include "parallel.h"
+#include "sparse.h"
 
-static void accumulate_observations(int const* series, size_t n, size_t m,
-    int b, size_t kpast, size_t kfuture, inform_dist *states,
-    inform_dist *histories, inform_dist *futures)
+#define DEFINE_ACCUMULATE(TYPE) \
+static void accumulate_##TYPE(int const *series, size_t m, int b, \
+    size_t kpast, size_t kfuture, size_t begin, size_t end, TYPE *states, \
+    TYPE *histories, TYPE *futures) \
+{ \
+    size_t const w = m - kpast - kfuture + 1; \
+    while (begin < end) \
+    { \
+        int const *trial = series + m * (begin / w); \
+        size_t const first = begin % w; \
+        size_t const last = (w - first < end - begin) ? w : first + (end - begin); \
+ \
+        int history = 0, future = 0, q = 1, r = 1; \
+        for (size_t j = first; j < first + kpast; ++j) \
+        { \
+            q *= b; \
+            history *= b; \
+            history += trial[j]; \
+        } \
+        for (size_t j = first + kpast; j < first + kpast + kfuture; ++j) \
+        { \
+            r *= b; \
+            future *= b; \
+            future += trial[j]; \
+        } \
+ \
+        for (size_t p = first; p < last; ++p) \
+        { \
+            states[history * r + future]++; \
+            histories[history]++; \
+            futures[future]++; \
+ \
+            if (p + 1 < last) \
+            { \
+                history = history * b - trial[p]*q + trial[p + kpast]; \
+                future = future * b - trial[p + kpast]*r + trial[p + kpast + kfuture]; \
+            } \
+        } \
+        begin += last - first; \
+    } \
+}
+
+DEFINE_ACCUMULATE(uint16_t)
+DEFINE_ACCUMULATE(uint32_t)
+DEFINE_ACCUMULATE(uint64_t)
+
+/**
+ * Count the observations numbered `[begin, end)` consecutively across the
+ * trials. A range may start part way through a trial, in which case its
+ * first history and future are read from the time steps at that point.
+ */
+static void accumulate_observations(int const *series, size_t m, int b,
+    size_t kpast, size_t kfuture, size_t begin, size_t end, size_t width,
+    void *states, void *histories, void *futures)
+{
+    switch (width)
+    {
+        case sizeof(uint16_t):
+            accumulate_uint16_t(series, m, b, kpast, kfuture, begin, end,
+                states, histories, futures);
+            break;
+        case sizeof(uint32_t):
+            accumulate_uint32_t(series, m, b, kpast, kfuture, begin, end,
+                states, histories, futures);
+            break;
+        default:
+            accumulate_uint64_t(series, m, b, kpast, kfuture, begin, end,
+                states, histories, futures);
+            break;
+    }
+}
+
+/**
+ * Compute the local predictive information of each observation from the
+ * complete histograms. The states are encoded again as they were during the
+ * accumulation rather than being stored, which would take several bytes of
+ * scratch memory per observation.
+ */
+static void local_values(int const *series, size_t n, size_t m, int b,
+    size_t kpast, size_t kfuture, uint32_t const *states,
+    uint32_t const *histories, uint32_t const *futures, double *pi)
 {
+    double const N = (double) (n * (m - kpast - kfuture + 1));
     for (size_t i = 0; i < n; ++i, series += m)
     {
-        int history = 0, q = 1, r = 1, state, future = 0;
+        int history = 0, future = 0, q = 1, r = 1;
         for (size_t j = 0; j < kpast; ++j)
         {
             q *= b;
             history *= b;
             history += series[j];
         }
-
         for (size_t j = kpast; j < kpast + kfuture; ++j)
         {
             r *= b;
@@ -25,66 +106,105 @@ static void accumulate_observations(int const* series, size_t n, size_t m,
             future += series[j];
         }
 
-        size_t j = kpast + kfuture;
-        do
+        for (size_t j = kpast + kfuture; j <= m; ++j)
         {
-            state = history * r + future;
+            double const s = states[history * r + future];
+            double const h = histories[history];
+            double const f = futures[future];
+            *pi++ = log2((s * N) / (h * f));
 
-            states->histogram[state]++;
-            histories->histogram[history]++;
-            futures->histogram[future]++;
-
-            history = history * b - series[j - kpast - kfuture]*q + series[j - kfuture];
-            future = future * b - series[j - kfuture]*r + series[j];
-        } while (++j <= m);
+            if (j != m)
+            {
+                history = history * b - series[j - kpast - kfuture]*q + series[j - kfuture];
+                future = future * b - series[j - kfuture]*r + series[j];
+            }
+        }
     }
 }
 
-static void accumulate_local_observations(int const* series, size_t n, size_t m,
-    int b, size_t kpast, size_t kfuture, inform_dist *states,
-    inform_dist *histories, inform_dist *futures, int *state, int *history,
-    int *future)
+static bool accumulate_sparse_observations(int const *series, size_t n,
+    size_t m, int b, size_t kpast, size_t kfuture, inform_sparse_dist *states,
+    inform_sparse_dist *histories, inform_sparse_dist *futures)
 {
-    for (size_t i = 0; i < n; ++i)
+    for (size_t i = 0; i < n; ++i, series += m)
     {
-        history[0] = 0;
-        int q = 1;
+        uint64_t h = 0, f = 0, q = 1, r = 1, s;
         for (size_t j = 0; j < kpast; ++j)
         {
             q *= b;
-            history[0] *= b;
-            history[0] += series[j];
+            h *= b;
+            h += series[j];
         }
-        
-        future[0] = 0;
-        int r = 1;
+
         for (size_t j = kpast; j < kpast + kfuture; ++j)
         {
             r *= b;
-            future[0] *= b;
-            future[0] += series[j];
+            f *= b;
+            f += series[j];
         }
 
-        size_t j = kpast + kfuture;
-        do
+        for (size_t j = kpast + kfuture; j <= m; ++j)
         {
-            size_t l = j - kpast - kfuture;
-            state[l] = history[l] * r + future[l];
+            s = h * r + f;
 
-            states->histogram[state[l]]++;
-            histories->histogram[history[l]]++;
-            futures->histogram[future[l]]++;
+            if (!inform_sparse_tick(states, s) ||
+                !inform_sparse_tick(histories, h) ||
+                !inform_sparse_tick(futures, f))
+            {
+                return false;
+            }
 
             if (j != m)
             {
-                history[l + 1] = history[l] * b - series[l]*q + series[j - kfuture];
-                future[l + 1] = future[l] * b - series[j - kfuture]*r + series[j];
+                h = h * b - series[j - kpast - kfuture]*q + series[j - kfuture];
+                f = f * b - series[j - kfuture]*r + series[j];
             }
-        } while (++j <= m);
-        series += m;
-        state += (m - kpast - kfuture + 1);
-        history += (m - kpast - kfuture + 1);
-        future += (m - kpast - kfuture + 1);
+        }
+    }
+    return true;
+}
+
+/**
+ * Compute the local predictive information of each observation from the
+ * complete sparse histograms, encoding the states again as `local_values`
+ * does.
+ */
+static void sparse_local_values(int const *series, size_t n, size_t m, int b,
+    size_t kpast, size_t kfuture, inform_sparse_dist const *states,
+    inform_sparse_dist const *histories, inform_sparse_dist const *futures,
+    double *pi)
+{
+    double const N = (double) (n * (m - kpast - kfuture + 1));
+    for (size_t i = 0; i < n; ++i, series += m)
+    {
+        uint64_t h = 0, f = 0, q = 1, r = 1;
+        for (size_t j = 0; j < kpast; ++j)
+        {
+            q *= b;
+            h *= b;
+            h += series[j];
+        }
+
+        for (size_t j = kpast; j < kpast + kfuture; ++j)
+        {
+            r *= b;
+            f *= b;
+            f += series[j];
+        }
+
+        for (size_t j = kpast + kfuture; j <= m; ++j)
+        {
+            double const s = inform_sparse_get(states, h * r + f);
+            double const u = inform_sparse_get(histories, h);
+            double const v = inform_sparse_get(futures, f);
+            *pi++ = log2((s * N) / (u * v));
+
+            if (j != m)
+            {
+                h = h * b - series[j - kpast - kfuture]*q + series[j - kfuture];
+                f = f * b - series[j - kfuture]*r + series[j];
+            }
+        }
     }
 }
 
@@ -129,6 +249,71 @@ static bool check_arguments(int const *series, size_t n, size_t m, int b,
     return false;
 }
 
+/**
+ * Compute the predictive information using sparse histograms. If `pi` is
+ * non-NULL, the local values are stored in it and zero is returned. On
+ * failure, `NAN` is returned.
+ */
+static double sparse_predictive_info(int const *series, size_t n, size_t m,
+    int b, size_t kpast, size_t kfuture, double *pi, inform_error *err)
+{
+    size_t const N = n * (m - kpast - kfuture + 1);
+
+    // the sparse histograms have 32-bit counters
+    if (N > UINT32_MAX)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESIZE, NAN);
+    }
+
+    if (!inform_sparse_encodable(b, kpast + kfuture))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, NAN);
+    }
+
+    inform_sparse_dist states    = INFORM_SPARSE_DIST_EMPTY;
+    inform_sparse_dist histories = INFORM_SPARSE_DIST_EMPTY;
+    inform_sparse_dist futures   = INFORM_SPARSE_DIST_EMPTY;
+
+    double value = NAN;
+    if (!inform_sparse_init(&states) || !inform_sparse_init(&histories) ||
+        !inform_sparse_init(&futures))
+    {
+        INFORM_ERROR(err, INFORM_ENOMEM);
+    }
+    else if (!accumulate_sparse_observations(series, n, m, b, kpast, kfuture,
+        &states, &histories, &futures))
+    {
+        INFORM_ERROR(err, INFORM_ENOMEM);
+    }
+    else if (pi == NULL)
+    {
+        value = (inform_sparse_xlogx(&states) - inform_sparse_xlogx(&histories)
+            - inform_sparse_xlogx(&futures)) / N + log2((double) N);
+    }
+    else
+    {
+        sparse_local_values(series, n, m, b, kpast, kfuture, &states,
+            &histories, &futures, pi);
+        value = 0.0;
+    }
+
+    inform_sparse_free(&futures);
+    inform_sparse_free(&histories);
+    inform_sparse_free(&states);
+
+    return value;
+}
+
+/**
+ * The total support of the dense histograms for the predictive information.
+ */
+inline static double dense_support(int b, size_t kpast, size_t kfuture)
+{
+    double const histories = pow((double) b, (double) kpast);
+    double const futures = pow((double) b, (double) kfuture);
+    return histories * futures + histories + futures;
+}
+
 double inform_predictive_info(int const *series, size_t n, size_t m, int b,
     size_t kpast, size_t kfuture, inform_error *err)
 {
@@ -136,25 +321,44 @@ double inform_predictive_info(int const *series, size_t n, size_t m, int b,
 
     size_t const N = n * (m - kpast - kfuture + 1);
 
+    if (inform_sparse_preferred(dense_support(b, kpast, kfuture), N))
+    {
+        return sparse_predictive_info(series, n, m, b, kpast, kfuture, NULL, err);
+    }
+
     size_t const histories_size = (size_t) pow((double) b, (double) kpast);
     size_t const futures_size = (size_t) pow((double) b, (double) kfuture);
     size_t const states_size = histories_size * futures_size;
     size_t const total_size = states_size + histories_size + futures_size;
+    size_t const chunks = inform_parallel_chunks(N, total_size);
+    size_t const width = inform_counts_width(N);
 
-    uint32_t *data = calloc(total_size, sizeof(uint32_t));
+    void *data = calloc(chunks * total_size, width);
     if (data == NULL)
     {
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
     }
 
-    inform_dist states    = { data, states_size, N };
-    inform_dist histories = { data + states_size, histories_size, N };
-    inform_dist futures   = { data + states_size + histories_size, futures_size, N };
-
-    accumulate_observations(series, n, m, b, kpast, kfuture, &states,
-        &histories, &futures);
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        void *chunk = inform_counts_at(data, width, c * total_size);
+        size_t begin, end;
+        inform_parallel_range(N, c, chunks, &begin, &end);
+        accumulate_observations(series, m, b, kpast, kfuture, begin, end,
+            width, chunk, inform_counts_at(chunk, width, states_size),
+            inform_counts_at(chunk, width, states_size + histories_size));
+    }
+    inform_counts_merge(data, width, total_size, chunks);
 
-    double pi = inform_shannon_mi(&states, &histories, &futures, 2.0);
+    double const pi = (inform_counts_xlogx(data, width, states_size)
+        - inform_counts_xlogx(inform_counts_at(data, width, states_size), width,
+            histories_size)
+        - inform_counts_xlogx(inform_counts_at(data, width,
+            states_size + histories_size), width, futures_size))
+        / N + log2((double) N);
 
     free(data);
 
@@ -168,6 +372,12 @@ double *inform_local_predictive_info(int const *series, size_t n, size_t m,
 
     size_t const N = n * (m - kpast - kfuture + 1);
 
+    // the local histograms have 32-bit counters
+    if (N > UINT32_MAX)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESIZE, NULL);
+    }
+
     bool allocate_pi = (pi == NULL);
     if (allocate_pi)
     {
@@ -178,6 +388,16 @@ double *inform_local_predictive_info(int const *series, size_t n, size_t m,
         }
     }
 
+    if (inform_sparse_preferred(dense_support(b, kpast, kfuture), N))
+    {
+        if (isnan(sparse_predictive_info(series, n, m, b, kpast, kfuture, pi, err)))
+        {
+            if (allocate_pi) free(pi);
+            return NULL;
+        }
+        return pi;
+    }
+
     size_t const histories_size = (size_t) pow((double) b, (double) kpast);
     size_t const futures_size = (size_t) pow((double) b, (double) kfuture);
     size_t const states_size = histories_size * futures_size;
@@ -190,34 +410,15 @@ double *inform_local_predictive_info(int const *series, size_t n, size_t m,
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
 
-    inform_dist states    = { histogram_data, states_size, N };
-    inform_dist histories = { histogram_data + states_size, histories_size, N };
-    inform_dist futures   = { histogram_data + states_size + histories_size, futures_size, N };
+    uint32_t *states    = histogram_data;
+    uint32_t *histories = states + states_size;
+    uint32_t *futures   = histories + histories_size;
 
-    int *state_data = malloc(3 * N * sizeof(int));
-    if (state_data == NULL)
-    {
-        if (allocate_pi) free(pi);
-        free(histogram_data);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
-    }
-    int *state   = state_data;
-    int *history = state + N;
-    int *future  = history + N;
-
-    accumulate_local_observations(series, n, m, b, kpast, kfuture, &states,
-        &histories, &futures, state, history, future);
-
-    double s, h, f;
-    for (size_t i = 0; i < N; ++i)
-    {
-        s = states.histogram[state[i]];
-        h = histories.histogram[history[i]];
-        f = futures.histogram[future[i]];
-        pi[i] = log2((s * N) / (h * f));
-    }
+    accumulate_uint32_t(series, m, b, kpast, kfuture, 0, N, states, histories,
+        futures);
+    local_values(series, n, m, b, kpast, kfuture, states, histories, futures,
+        pi);
 
-    free(state_data);
     free(histogram_data);
 
     return pi;
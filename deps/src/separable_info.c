@@ -1,15 +1,145 @@
-// Copyright 2016-2018 ELIFE. All rights reserved.
+// Copyright 2016-2019 ELIFE. All rights reserved.
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include <inform/active_info.h>
+#include <inform/separable_info.h>
 #include <inform/transfer_entropy.h>
 #include <math.h>
+#include <string.h>
+#include "parallel.h"
+#include "sparse.h"
+#include "xlogx.h"
 
-double inform_separable_info(int const *srcs, int const *dest, size_t l,
+static bool check_arguments(int const *srcs, int const *dest, size_t l,
     size_t n, size_t m, int b, size_t k, inform_error *err)
 {
-    if (l < 1) INFORM_ERROR_RETURN(err, INFORM_ENOSOURCES, NAN);
+    if (l < 1)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOSOURCES, true);
+    }
+    else if (srcs == NULL || dest == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    else if (n < 1)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOINITS, true);
+    }
+    else if (m < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, true);
+    }
+    else if (b < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
+    }
+    else if (k == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKZERO, true);
+    }
+    else if (m <= k)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKLONG, true);
+    }
+    for (size_t i = 0; i < n * m; ++i)
+    {
+        if (dest[i] < 0)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
+        }
+        else if (b <= dest[i])
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
+        }
+    }
+    for (size_t i = 0; i < l * n * m; ++i)
+    {
+        if (srcs[i] < 0)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
+        }
+        else if (b <= srcs[i])
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
+        }
+    }
+    return false;
+}
 
+/**
+ * The total support of the dense histograms of the destination and of a
+ * single source.
+ */
+inline static double dense_support(int b, size_t k)
+{
+    return pow((double) b, (double) k) * (b*b + 2*b + 1) + b;
+}
+
+/**
+ * Determine whether the shared kernel applies. Otherwise, the separable
+ * information is computed from the active information and the transfer
+ * entropies, which handle sparse supports and very long series.
+ */
+static bool shared_kernel_applies(int b, size_t k, size_t N)
+{
+    return N <= UINT32_MAX && !inform_sparse_preferred(dense_support(b, k), N);
+}
+
+/**
+ * Encode the length-`k` history of the destination before each of its
+ * observations, and count the histories, the predicates (a history followed
+ * by the next state) and the futures.
+ */
+static void encode_destination(int const *dest, size_t n, size_t m, int b,
+    size_t k, int *history, uint32_t *histories, uint32_t *predicates,
+    uint32_t *futures)
+{
+    for (size_t i = 0; i < n; ++i, dest += m)
+    {
+        int h = 0, q = 1, p;
+        for (size_t j = 0; j < k; ++j)
+        {
+            q *= b;
+            h *= b;
+            h += dest[j];
+        }
+        for (size_t j = k; j < m; ++j)
+        {
+            p = h * b + dest[j];
+
+            *history++ = h;
+            histories[h]++;
+            predicates[p]++;
+            futures[dest[j]]++;
+
+            h = p - dest[j - k]*q;
+        }
+    }
+}
+
+/**
+ * Count the previous state of a source together with the destination's
+ * history (`sources`), and together with its history and next state
+ * (`states`), reading the histories encoded by `encode_destination`.
+ */
+static void accumulate_source(int const *src, int const *dest,
+    int const *history, size_t n, size_t m, int b, size_t k,
+    uint32_t *sources, uint32_t *states)
+{
+    for (size_t i = 0; i < n; ++i, src += m, dest += m)
+    {
+        for (size_t j = k; j < m; ++j)
+        {
+            int const h = *history++;
+            sources[h * b + src[j-1]]++;
+            states[(h * b + dest[j]) * b + src[j-1]]++;
+        }
+    }
+}
+
+static double separable_info_by_parts(int const *srcs, int const *dest,
+    size_t l, size_t n, size_t m, int b, size_t k, inform_error *err)
+{
     double si = inform_active_info(dest, n, m, b, k, err);
     if (inform_failed(err)) return NAN;
 
@@ -22,12 +152,91 @@ double inform_separable_info(int const *srcs, int const *dest, size_t l,
     return si;
 }
 
-double *inform_local_separable_info(int const *srcs, int const *dest,
-    size_t l, size_t n, size_t m, int b, size_t k, double *si,
-    inform_error *err)
+double inform_separable_info(int const *srcs, int const *dest, size_t l,
+    size_t n, size_t m, int b, size_t k, inform_error *err)
 {
-    if (l < 1) INFORM_ERROR_RETURN(err, INFORM_ENOSOURCES, NULL);
+    if (check_arguments(srcs, dest, l, n, m, b, k, err)) return NAN;
+
+    size_t const N = n * (m - k);
 
+    if (!shared_kernel_applies(b, k, N))
+    {
+        return separable_info_by_parts(srcs, dest, l, n, m, b, k, err);
+    }
+
+    size_t const q = (size_t) pow((double) b, (double) k);
+    size_t const dest_size = q + b*q + b;
+    size_t const source_size = b*q + b*b*q;
+    size_t chunks = inform_parallel_chunks(l * N, source_size);
+    if (chunks > l)
+    {
+        chunks = l;
+    }
+
+    int *history = malloc(N * sizeof(int));
+    uint32_t *dest_data = calloc(dest_size, sizeof(uint32_t));
+    uint32_t *source_data = malloc(chunks * source_size * sizeof(uint32_t));
+    double *terms = malloc(l * sizeof(double));
+    if (history == NULL || dest_data == NULL || source_data == NULL ||
+        terms == NULL)
+    {
+        free(terms);
+        free(source_data);
+        free(dest_data);
+        free(history);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+
+    uint32_t *histories  = dest_data;
+    uint32_t *predicates = histories + q;
+    uint32_t *futures    = predicates + b*q;
+    encode_destination(dest, n, m, b, k, history, histories, predicates,
+        futures);
+
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        uint32_t *sources = source_data + c * source_size;
+        uint32_t *states = sources + b*q;
+        size_t begin, end;
+        inform_parallel_range(l, c, chunks, &begin, &end);
+        for (size_t s = begin; s < end; ++s)
+        {
+            memset(sources, 0, source_size * sizeof(uint32_t));
+            accumulate_source(srcs + s*n*m, dest, history, n, m, b, k, sources,
+                states);
+            terms[s] = inform_xlogx_sum(states, b*b*q)
+                - inform_xlogx_sum(sources, b*q);
+        }
+    }
+
+    // The active information contributes S(predicates) - S(histories) and
+    // each transfer entropy S(histories) - S(predicates), where S sums
+    // c log2 c over the counts; the remaining terms are summed in order so
+    // that the result does not depend on the number of threads.
+    double total = (l - 1.0) * (inform_xlogx_sum(histories, q)
+        - inform_xlogx_sum(predicates, b*q));
+    for (size_t s = 0; s < l; ++s)
+    {
+        total += terms[s];
+    }
+    double const si = log2((double) N)
+        + (total - inform_xlogx_sum(futures, b)) / N;
+
+    free(terms);
+    free(source_data);
+    free(dest_data);
+    free(history);
+
+    return si;
+}
+
+static double *local_separable_info_by_parts(int const *srcs,
+    int const *dest, size_t l, size_t n, size_t m, int b, size_t k, double *si,
+    inform_error *err)
+{
     bool allocated_si = (si == NULL);
 
     si = inform_local_active_info(dest, n, m, b, k, si, err);
@@ -61,3 +270,87 @@ double *inform_local_separable_info(int const *srcs, int const *dest,
 
     return si;
 }
+
+double *inform_local_separable_info(int const *srcs, int const *dest,
+    size_t l, size_t n, size_t m, int b, size_t k, double *si,
+    inform_error *err)
+{
+    if (check_arguments(srcs, dest, l, n, m, b, k, err)) return NULL;
+
+    size_t const N = n * (m - k);
+
+    if (!shared_kernel_applies(b, k, N))
+    {
+        return local_separable_info_by_parts(srcs, dest, l, n, m, b, k, si,
+            err);
+    }
+
+    size_t const q = (size_t) pow((double) b, (double) k);
+    size_t const dest_size = q + b*q + b;
+    size_t const source_size = b*q + b*b*q;
+
+    bool allocated_si = (si == NULL);
+    if (allocated_si)
+    {
+        si = malloc(N * sizeof(double));
+    }
+    int *history = malloc(N * sizeof(int));
+    uint32_t *data = calloc(dest_size + source_size, sizeof(uint32_t));
+    if (si == NULL || history == NULL || data == NULL)
+    {
+        free(data);
+        free(history);
+        if (allocated_si) free(si);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+
+    uint32_t *histories  = data;
+    uint32_t *predicates = histories + q;
+    uint32_t *futures    = predicates + b*q;
+    uint32_t *sources    = futures + b;
+    uint32_t *states     = sources + b*q;
+    encode_destination(dest, n, m, b, k, history, histories, predicates,
+        futures);
+
+    int const *x = dest;
+    for (size_t i = 0, z = 0; i < n; ++i, x += m)
+    {
+        for (size_t j = k; j < m; ++j, ++z)
+        {
+            int const h = history[z];
+            double const r = predicates[h * b + x[j]];
+            double const s = histories[h];
+            double const t = futures[x[j]];
+            si[z] = log2((r * N) / (s * t));
+        }
+    }
+
+    // The sources all add into the same local values, so they are counted
+    // one after the other into a single pair of histograms.
+    for (size_t c = 0; c < l; ++c, srcs += n*m)
+    {
+        memset(sources, 0, source_size * sizeof(uint32_t));
+        accumulate_source(srcs, dest, history, n, m, b, k, sources, states);
+
+        int const *y = srcs;
+        x = dest;
+        for (size_t i = 0, z = 0; i < n; ++i, x += m, y += m)
+        {
+            for (size_t j = k; j < m; ++j, ++z)
+            {
+                int const h = history[z];
+                int const p = h * b + x[j];
+                double const s = states[p * b + y[j-1]];
+                double const t = sources[h * b + y[j-1]];
+                double const u = predicates[p];
+                double const v = histories[h];
+                si[z] += log2((s*v)/(t*u));
+            }
+        }
+    }
+
+    free(data);
+    free(history);
+
+    return si;
+}
@@ -0,0 +1,276 @@
+// Copyright 2016-2019 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <inform/series_profile.h>
+#include <math.h>
+#include "sparse.h"
+#include "xlogx.h"
+
+/**
+ * A histogram which is either dense, indexed directly by the encoded state,
+ * or sparse, depending on how its support compares to the number of
+ * observations.
+ */
+typedef struct counter
+{
+    uint32_t *dense;
+    size_t size;
+    inform_sparse_dist sparse;
+} counter;
+
+#define COUNTER_EMPTY { NULL, 0, INFORM_SPARSE_DIST_EMPTY }
+
+static bool counter_init(counter *c, double support, size_t N)
+{
+    if (inform_sparse_preferred(support, N))
+    {
+        return inform_sparse_init(&c->sparse);
+    }
+    c->size = (size_t) support;
+    c->dense = calloc(c->size, sizeof(uint32_t));
+    return c->dense != NULL;
+}
+
+static void counter_free(counter *c)
+{
+    free(c->dense);
+    c->dense = NULL;
+    inform_sparse_free(&c->sparse);
+}
+
+inline static bool counter_tick(counter *c, uint64_t event)
+{
+    if (c->dense != NULL)
+    {
+        c->dense[event]++;
+        return true;
+    }
+    return inform_sparse_tick(&c->sparse, event);
+}
+
+static double counter_xlogx(counter const *c)
+{
+    if (c->dense == NULL)
+    {
+        return inform_sparse_xlogx(&c->sparse);
+    }
+    return inform_xlogx_sum(c->dense, c->size);
+}
+
+static bool check_arguments(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_error *err)
+{
+    if (series == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    else if (n < 1)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOINITS, true);
+    }
+    else if (m < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, true);
+    }
+    else if (b < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
+    }
+    else if (k == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKZERO, true);
+    }
+    else if (m <= k)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKLONG, true);
+    }
+    else if (!inform_sparse_encodable(b, k + 1))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
+    }
+    for (size_t i = 0; i < n * m; ++i)
+    {
+        if (series[i] < 0)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
+        }
+        else if (b <= series[i])
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
+        }
+    }
+    return false;
+}
+
+/**
+ * The histograms filled by a single scan of the series.
+ *
+ * Every measure counts length-`k` blocks, but over different ranges of each
+ * series: the predictive information counts the blocks starting at
+ * `p <= m - 2k`, the active information and entropy rate those at
+ * `p <= m - k - 1`, and the block entropy all of them. The blocks are
+ * counted once into `blocks`; those beyond the predictive information's
+ * range are set aside in `middle` and `last`, and are added to `blocks`
+ * only after the smaller ranges have been summed.
+ */
+typedef struct histograms
+{
+    counter blocks, states, futures, pairs;
+    uint32_t *symbols;
+    uint64_t *middle, *last;
+    size_t nmiddle;
+} histograms;
+
+static bool accumulate(int const *series, size_t n, size_t m, int b,
+    size_t k, bool predict, histograms *h)
+{
+    uint64_t q = 1, r = 1;
+    for (size_t j = 0; j < k; ++j)
+    {
+        q *= b;
+    }
+    if (predict)
+    {
+        r = q * q;
+    }
+
+    size_t nmiddle = 0;
+    for (size_t i = 0; i < n; ++i, series += m)
+    {
+        uint64_t block = 0, pair = 0;
+        for (size_t j = 0; j < k; ++j)
+        {
+            block = block * b + series[j];
+        }
+        if (predict)
+        {
+            for (size_t j = 0; j < 2 * k; ++j)
+            {
+                pair = pair * b + series[j];
+            }
+        }
+
+        for (size_t p = 0; p + k < m; ++p)
+        {
+            int const future = series[p + k];
+            uint64_t const state = block * b + future;
+
+            if (!counter_tick(&h->states, state))
+            {
+                return false;
+            }
+            h->symbols[future]++;
+
+            if (predict && p + 2 * k <= m)
+            {
+                if (!counter_tick(&h->blocks, block) ||
+                    !counter_tick(&h->pairs, pair) ||
+                    !counter_tick(&h->futures, pair % q))
+                {
+                    return false;
+                }
+                if (p + 2 * k < m)
+                {
+                    pair = pair * b + series[p + 2 * k] - series[p] * r;
+                }
+            }
+            else if (predict)
+            {
+                h->middle[nmiddle++] = block;
+            }
+            else if (!counter_tick(&h->blocks, block))
+            {
+                return false;
+            }
+
+            block = state - series[p] * q;
+        }
+        h->last[i] = block;
+    }
+    h->nmiddle = nmiddle;
+    return true;
+}
+
+inform_series_profile inform_profile_series(int const *series, size_t n,
+    size_t m, int b, size_t k, inform_error *err)
+{
+    inform_series_profile profile = { NAN, NAN, NAN, NAN };
+    if (check_arguments(series, n, m, b, k, err)) return profile;
+
+    bool const predict = (m > 2 * k) && inform_sparse_encodable(b, 2 * k);
+
+    size_t const N = n * (m - k);
+    size_t const Nb = n * (m - k + 1);
+    size_t const Np = predict ? n * (m - 2 * k + 1) : 0;
+
+    // the histograms have 32-bit counters
+    if (Nb > UINT32_MAX)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESIZE, profile);
+    }
+
+    double const q = pow((double) b, (double) k);
+
+    histograms h = { COUNTER_EMPTY, COUNTER_EMPTY, COUNTER_EMPTY,
+        COUNTER_EMPTY, NULL, NULL, NULL, 0 };
+
+    h.symbols = calloc(b, sizeof(uint32_t));
+    h.last = malloc(n * sizeof(uint64_t));
+    if (predict)
+    {
+        h.middle = malloc(n * k * sizeof(uint64_t));
+    }
+
+    bool ok = h.symbols != NULL && h.last != NULL &&
+        (!predict || h.middle != NULL) &&
+        counter_init(&h.blocks, q, Nb) &&
+        counter_init(&h.states, q * b, N) &&
+        (!predict || counter_init(&h.futures, q, Np)) &&
+        (!predict || counter_init(&h.pairs, q * q, Np)) &&
+        accumulate(series, n, m, b, k, predict, &h);
+
+    if (ok && predict)
+    {
+        double const pairs = counter_xlogx(&h.pairs);
+        double const histories = counter_xlogx(&h.blocks);
+        double const futures = counter_xlogx(&h.futures);
+        profile.predictive_info = (pairs - histories - futures) / Np + log2((double) Np);
+
+        for (size_t i = 0; ok && i < h.nmiddle; ++i)
+        {
+            ok = counter_tick(&h.blocks, h.middle[i]);
+        }
+    }
+
+    if (ok)
+    {
+        double const symbols = inform_xlogx_sum(h.symbols, b);
+
+        double const states = counter_xlogx(&h.states);
+        double const histories = counter_xlogx(&h.blocks);
+        profile.active_info = (states - histories - symbols) / N + log2((double) N);
+        profile.entropy_rate = (histories - states) / N;
+
+        for (size_t i = 0; ok && i < n; ++i)
+        {
+            ok = counter_tick(&h.blocks, h.last[i]);
+        }
+        profile.block_entropy = log2((double) Nb) - counter_xlogx(&h.blocks) / Nb;
+    }
+
+    if (!ok)
+    {
+        profile = (inform_series_profile) { NAN, NAN, NAN, NAN };
+        INFORM_ERROR(err, INFORM_ENOMEM);
+    }
+
+    counter_free(&h.pairs);
+    counter_free(&h.futures);
+    counter_free(&h.states);
+    counter_free(&h.blocks);
+    free(h.middle);
+    free(h.last);
+    free(h.symbols);
+
+    return profile;
+}
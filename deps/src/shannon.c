@@ -3,6 +3,7 @@
 // license that can be found in the LICENSE file.
 #include <inform/shannon.h>
 #include <inform/error.h>
+#include "xlogx.h"
 
 double inform_shannon_si(inform_dist const *dist, size_t event, double base)
 {
@@ -18,21 +19,10 @@ double inform_shannon_entropy(inform_dist const *dist, double base)
     // ensure that the distribution is valid
     if (inform_dist_is_valid(dist))
     {
-        // get the size of the distribution's support
-        size_t const n = inform_dist_size(dist);
-        double h = 0.;
-        // for each element of the distribution's support
-        for (size_t i = 0; i < n; ++i)
-        {
-            // the observation_count is non-zero
-            if (dist->histogram[i] != 0)
-            {
-                // get the probability
-                double const p = (double) dist->histogram[i] / dist->counts;
-                // accumulate the weighted self-information of the event
-                h -= p * log2(p);
-            }
-        }
+        // reduce the histogram directly, as
+        //     H = -sum (c/N) log2(c/N) = log2(N) - sum c log2(c) / N
+        double const N = dist->counts;
+        double const h = log2(N) - inform_xlogx_sum(dist->histogram, dist->size) / N;
         // return the entropy
         return h / log2(base);
     }
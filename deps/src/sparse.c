@@ -0,0 +1,155 @@
+// Copyright 2016-2019 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "sparse.h"
+#include "xlogx.h"
+#include <limits.h>
+#include <math.h>
+
+/// the smallest total support for which sparse histograms are considered
+#define INFORM_SPARSE_MIN_SUPPORT 65536
+/// the ratio of support to observations beyond which sparse histograms are used
+#define INFORM_SPARSE_RATIO 16
+/// the initial number of slots of a sparse histogram
+#define INFORM_SPARSE_INIT_CAPACITY 64
+
+bool inform_sparse_preferred(double support, size_t N)
+{
+    // The dense histograms are indexed by `int`-encoded states, so beyond
+    // INT_MAX the sparse histograms are the only correct option.
+    return support > INT_MAX || (support > INFORM_SPARSE_MIN_SUPPORT &&
+        support > INFORM_SPARSE_RATIO * (double) N);
+}
+
+bool inform_sparse_encodable(int b, size_t digits)
+{
+    return pow((double) b, (double) digits) < ldexp(1.0, 64);
+}
+
+inline static size_t slot(uint64_t event, size_t capacity)
+{
+    uint64_t hash = event * UINT64_C(0x9E3779B97F4A7C15);
+    return (size_t) (hash ^ (hash >> 32)) & (capacity - 1);
+}
+
+static bool allocate(inform_sparse_dist *dist, size_t capacity)
+{
+    dist->keys = malloc(capacity * sizeof(uint64_t));
+    dist->histogram = calloc(capacity, sizeof(uint32_t));
+    if (dist->keys == NULL || dist->histogram == NULL)
+    {
+        inform_sparse_free(dist);
+        return false;
+    }
+    dist->capacity = capacity;
+    dist->size = 0;
+    return true;
+}
+
+bool inform_sparse_init(inform_sparse_dist *dist)
+{
+    return allocate(dist, INFORM_SPARSE_INIT_CAPACITY);
+}
+
+void inform_sparse_free(inform_sparse_dist *dist)
+{
+    free(dist->keys);
+    free(dist->histogram);
+    dist->keys = NULL;
+    dist->histogram = NULL;
+    dist->capacity = 0;
+    dist->size = 0;
+}
+
+static bool grow(inform_sparse_dist *dist)
+{
+    inform_sparse_dist old = *dist;
+    if (!allocate(dist, 2 * old.capacity))
+    {
+        *dist = old;
+        return false;
+    }
+
+    for (size_t i = 0; i < old.capacity; ++i)
+    {
+        if (old.histogram[i] != 0)
+        {
+            size_t j = slot(old.keys[i], dist->capacity);
+            while (dist->histogram[j] != 0)
+            {
+                j = (j + 1) & (dist->capacity - 1);
+            }
+            dist->keys[j] = old.keys[i];
+            dist->histogram[j] = old.histogram[i];
+        }
+    }
+    dist->size = old.size;
+
+    inform_sparse_free(&old);
+    return true;
+}
+
+uint32_t *inform_sparse_insert(inform_sparse_dist *dist, uint64_t event,
+    uint32_t count)
+{
+    size_t i = slot(event, dist->capacity);
+    while (dist->histogram[i] != 0)
+    {
+        if (dist->keys[i] == event)
+        {
+            return dist->histogram + i;
+        }
+        i = (i + 1) & (dist->capacity - 1);
+    }
+
+    // Keep the load factor at most one half so that probe sequences stay
+    // short; the event is inserted into the grown table instead.
+    if (2 * (dist->size + 1) > dist->capacity)
+    {
+        if (!grow(dist))
+        {
+            return NULL;
+        }
+        return inform_sparse_insert(dist, event, count);
+    }
+
+    dist->keys[i] = event;
+    dist->histogram[i] = count;
+    dist->size++;
+    return dist->histogram + i;
+}
+
+bool inform_sparse_tick(inform_sparse_dist *dist, uint64_t event)
+{
+    size_t const size = dist->size;
+    uint32_t *count = inform_sparse_insert(dist, event, 1);
+    if (count == NULL)
+    {
+        return false;
+    }
+    if (dist->size == size)
+    {
+        (*count)++;
+    }
+    return true;
+}
+
+uint32_t inform_sparse_get(inform_sparse_dist const *dist, uint64_t event)
+{
+    size_t i = slot(event, dist->capacity);
+    while (dist->histogram[i] != 0)
+    {
+        if (dist->keys[i] == event)
+        {
+            return dist->histogram[i];
+        }
+        i = (i + 1) & (dist->capacity - 1);
+    }
+    return 0;
+}
+
+double inform_sparse_xlogx(inform_sparse_dist const *dist)
+{
+    // empty slots have a count of zero, and so contribute nothing
+    return inform_xlogx_sum(dist->histogram, dist->capacity);
+}
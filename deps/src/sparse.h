@@ -0,0 +1,90 @@
+// Copyright 2016-2019 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * A histogram over a sparse support
+ *
+ * The time series measures encode each observed state as an integer and
+ * count the states in a dense histogram whose support is some power of the
+ * base, e.g. @f b^{k+2} @f for transfer entropy, regardless of how many
+ * states are actually observed. When that support greatly exceeds the number
+ * of observations, the measures count the states in one of these instead: an
+ * open-addressing hash table keyed by the encoded state, whose size scales
+ * with the number of distinct states observed.
+ *
+ * A slot is empty if and only if its count is zero.
+ */
+typedef struct inform_sparse_distribution
+{
+    /// the encoded state held in each slot
+    uint64_t *keys;
+    /// the number of observations of the state held in each slot
+    uint32_t *histogram;
+    /// the number of slots, always a power of two
+    size_t capacity;
+    /// the number of occupied slots
+    size_t size;
+} inform_sparse_dist;
+
+/// An empty sparse distribution; pass it to `inform_sparse_init` before use.
+#define INFORM_SPARSE_DIST_EMPTY { NULL, NULL, 0, 0 }
+
+/**
+ * Determine whether the sparse histograms should be used rather than dense
+ * ones with a total `support`, given `N` observations. This is always the
+ * case if the states cannot be encoded as an `int`.
+ */
+bool inform_sparse_preferred(double support, size_t N);
+
+/**
+ * Determine whether states with `digits` base-`b` digits can be encoded as
+ * 64-bit keys.
+ */
+bool inform_sparse_encodable(int b, size_t digits);
+
+/**
+ * Allocate the initial slots of a sparse distribution.
+ *
+ * @return `false` if the allocation failed
+ */
+bool inform_sparse_init(inform_sparse_dist *dist);
+
+/**
+ * Free the slots of a sparse distribution. It is safe to free a distribution
+ * which was never (or unsuccessfully) initialized.
+ */
+void inform_sparse_free(inform_sparse_dist *dist);
+
+/**
+ * Observe an event, growing the table if needed.
+ *
+ * @return `false` if the table could not be grown
+ */
+bool inform_sparse_tick(inform_sparse_dist *dist, uint64_t event);
+
+/**
+ * Get the address of the count of an event, first inserting it with a
+ * nonzero `count` if it has not been observed, growing the table if needed.
+ * This lets the table map each event to a (nonzero) value of the caller's
+ * choosing rather than count it.
+ *
+ * @return `NULL` if the table could not be grown
+ */
+uint32_t *inform_sparse_insert(inform_sparse_dist *dist, uint64_t event,
+    uint32_t count);
+
+/**
+ * Get the number of times an event has been observed.
+ */
+uint32_t inform_sparse_get(inform_sparse_dist const *dist, uint64_t event);
+
+/**
+ * Sum @f n \log_2{n} @f over the counts of the distribution.
+ */
+double inform_sparse_xlogx(inform_sparse_dist const *dist);
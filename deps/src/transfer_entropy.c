@@ -4,16 +4,105 @@
 #include <inform/shannon.h>
 #include <inform/transfer_entropy.h>
 #include <string.h>
+#include "counts.h"
+#include "parallel.h"
+#include "sparse.h"
+#include "xlogx.h"
 
+#define DEFINE_ACCUMULATE(TYPE) \
+static void accumulate_##TYPE(int const *src, int const *dst, int const *back, \
+    size_t l, size_t n, size_t m, int b, size_t k, size_t begin, size_t end, \
+    TYPE *states, TYPE *histories, TYPE *sources, TYPE *predicates) \
+{ \
+    size_t const w = m - k; \
+    while (begin < end) \
+    { \
+        size_t const i = begin / w; \
+        int const *source_trial = src + m * i; \
+        int const *target_trial = dst + m * i; \
+        size_t const first = k + begin % w; \
+        size_t const last = (m - first < end - begin) ? m : first + (end - begin); \
+ \
+        int src_state, future, state, source, predicate, back_state; \
+        int history = 0, q = 1; \
+        for (size_t j = first - k; j < first; ++j) \
+        { \
+            q *= b; \
+            history *= b; \
+            history += target_trial[j]; \
+        } \
+        for (size_t j = first; j < last; ++j) \
+        { \
+            back_state = 0; \
+            for (size_t u = 0; u < l; ++u) \
+            { \
+                back_state = b * back_state + back[j+n*(i+m*u)-1]; \
+            } \
+            history += back_state * q; \
+ \
+            src_state = source_trial[j-1]; \
+            future    = target_trial[j]; \
+            source    = history * b + src_state; \
+            predicate = history * b + future; \
+            state     = predicate * b + src_state; \
+ \
+            states[state]++; \
+            histories[history]++; \
+            sources[source]++; \
+            predicates[predicate]++; \
+ \
+            history = predicate - (target_trial[j - k] + back_state * b) * q; \
+        } \
+        begin += last - first; \
+    } \
+}
+
+DEFINE_ACCUMULATE(uint16_t)
+DEFINE_ACCUMULATE(uint32_t)
+DEFINE_ACCUMULATE(uint64_t)
+
+/**
+ * Count the observations numbered `[begin, end)` consecutively across the
+ * trials. A range may start part way through a trial, in which case its
+ * first history is read from the preceding time steps. The histograms hold
+ * counters of `width` bytes, as chosen by `inform_counts_width`.
+ */
 static void accumulate_observations(int const *src, int const *dst,
     int const *back, size_t l, size_t n, size_t m, int b, size_t k,
-    inform_dist *states, inform_dist *histories, inform_dist *sources,
-    inform_dist *predicates)
+    size_t begin, size_t end, size_t width, void *states, void *histories,
+    void *sources, void *predicates)
+{
+    switch (width)
+    {
+        case sizeof(uint16_t):
+            accumulate_uint16_t(src, dst, back, l, n, m, b, k, begin, end,
+                states, histories, sources, predicates);
+            break;
+        case sizeof(uint32_t):
+            accumulate_uint32_t(src, dst, back, l, n, m, b, k, begin, end,
+                states, histories, sources, predicates);
+            break;
+        default:
+            accumulate_uint64_t(src, dst, back, l, n, m, b, k, begin, end,
+                states, histories, sources, predicates);
+            break;
+    }
+}
+
+/**
+ * Compute the local transfer entropy of each observation from the complete
+ * histograms. The states are encoded again as they were during the
+ * accumulation rather than being stored, which would take several bytes of
+ * scratch memory per observation.
+ */
+static void local_values(int const *src, int const *dst, int const *back,
+    size_t l, size_t n, size_t m, int b, size_t k, uint32_t const *states,
+    uint32_t const *histories, uint32_t const *sources,
+    uint32_t const *predicates, double *te)
 {
     for (size_t i = 0; i < n; ++i, src += m, dst += m)
     {
-        int src_state, future, state, source, predicate, back_state;
-        int history = 0, q = 1;
+        int history = 0, q = 1, back_state, source, predicate, state;
         for (size_t j = 0; j < k; ++j)
         {
             q *= b;
@@ -29,69 +118,102 @@ static void accumulate_observations(int const *src, int const *dst,
             }
             history += back_state * q;
 
-            src_state = src[j-1];
-            future    = dst[j];
-            source    = history * b + src_state;
-            predicate = history * b + future;
-            state     = predicate * b + src_state;
+            source    = history * b + src[j-1];
+            predicate = history * b + dst[j];
+            state     = predicate * b + src[j-1];
 
-            states->histogram[state]++;
-            histories->histogram[history]++;
-            sources->histogram[source]++;
-            predicates->histogram[predicate]++;
+            double const s = states[state];
+            double const t = sources[source];
+            double const u = predicates[predicate];
+            double const v = histories[history];
+            *te++ = log2((s*v)/(t*u));
 
             history = predicate - (dst[j - k] + back_state * b) * q;
         }
     }
 }
 
-static void accumulate_local_observations(int const *src, int const *dst,
+static bool accumulate_sparse_observations(int const *src, int const *dst,
     int const *back, size_t l, size_t n, size_t m, int b, size_t k,
-    inform_dist *states, inform_dist *histories, inform_dist *sources,
-    inform_dist *predicates, int *state, int *history, int *source,
-    int *predicate)
+    inform_sparse_dist *states, inform_sparse_dist *histories,
+    inform_sparse_dist *sources, inform_sparse_dist *predicates)
 {
-    for (size_t i = 0; i < n; ++i)
+    for (size_t i = 0; i < n; ++i, src += m, dst += m)
     {
-        history[0] = 0;
-        int q = 1;
+        uint64_t h = 0, q = 1, back_state, s, x, p;
         for (size_t j = 0; j < k; ++j)
         {
             q *= b;
-            history[0] *= b;
-            history[0] += dst[j];
+            h *= b;
+            h += dst[j];
         }
         for (size_t j = k; j < m; ++j)
         {
-            size_t z = j - k;
-            int back_state = 0;
+            back_state = 0;
             for (size_t u = 0; u < l; ++u)
             {
                 back_state = b * back_state + back[j+n*(i+m*u)-1];
             }
-            history[z] += back_state * q;
-            int src_state = src[j-1];
-            int future    = dst[j];
-            predicate[z]  = history[z] * b + future;
-            state[z]      = predicate[z] * b + src_state;
-            source[z]     = history[z] * b + src_state;
-
-            states->histogram[state[z]]++;
-            histories->histogram[history[z]]++;
-            sources->histogram[source[z]]++;
-            predicates->histogram[predicate[z]]++;
-
-            if (j + 1 != m)
+            h += back_state * q;
+
+            x = h * b + src[j-1];
+            p = h * b + dst[j];
+            s = p * b + src[j-1];
+
+            if (!inform_sparse_tick(states, s) ||
+                !inform_sparse_tick(histories, h) ||
+                !inform_sparse_tick(sources, x) ||
+                !inform_sparse_tick(predicates, p))
             {
-                history[z + 1] = predicate[z] - (dst[z] + back_state * b) * q;
+                return false;
             }
+
+            h = p - (dst[j - k] + back_state * b) * q;
+        }
+    }
+    return true;
+}
+
+/**
+ * Compute the local transfer entropy of each observation from the complete
+ * sparse histograms, encoding the states again as `local_values` does.
+ */
+static void sparse_local_values(int const *src, int const *dst,
+    int const *back, size_t l, size_t n, size_t m, int b, size_t k,
+    inform_sparse_dist const *states, inform_sparse_dist const *histories,
+    inform_sparse_dist const *sources, inform_sparse_dist const *predicates,
+    double *te)
+{
+    for (size_t i = 0; i < n; ++i, src += m, dst += m)
+    {
+        uint64_t h = 0, q = 1, back_state, s, x, p;
+        for (size_t j = 0; j < k; ++j)
+        {
+            q *= b;
+            h *= b;
+            h += dst[j];
+        }
+        for (size_t j = k; j < m; ++j)
+        {
+            back_state = 0;
+            for (size_t u = 0; u < l; ++u)
+            {
+                back_state = b * back_state + back[j+n*(i+m*u)-1];
+            }
+            h += back_state * q;
+
+            x = h * b + src[j-1];
+            p = h * b + dst[j];
+            s = p * b + src[j-1];
+
+            double const r = inform_sparse_get(states, s);
+            double const t = inform_sparse_get(sources, x);
+            double const u = inform_sparse_get(predicates, p);
+            double const v = inform_sparse_get(histories, h);
+            *te++ = log2((r*v)/(t*u));
+
+            h = p - (dst[j - k] + back_state * b) * q;
         }
-        src += m;
-        dst += m;
-        state += (m - k);
-        history += (m - k);
-        source += (m - k);
-        predicate += (m - k);
     }
 }
 
@@ -161,6 +283,72 @@ static bool check_arguments(int const *src, int const *dst, int const *back,
     return false;
 }
 
+/**
+ * Compute the transfer entropy using sparse histograms. If `te` is non-NULL,
+ * the local values are stored in it and zero is returned. On failure, `NAN`
+ * is returned.
+ */
+static double sparse_transfer_entropy(int const *src, int const *dst,
+    int const *back, size_t l, size_t n, size_t m, int b, size_t k, double *te,
+    inform_error *err)
+{
+    size_t const N = n * (m - k);
+
+    // the sparse histograms have 32-bit counters
+    if (N > UINT32_MAX)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESIZE, NAN);
+    }
+
+    if (!inform_sparse_encodable(b, k + l + 2))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, NAN);
+    }
+
+    inform_sparse_dist states     = INFORM_SPARSE_DIST_EMPTY;
+    inform_sparse_dist histories  = INFORM_SPARSE_DIST_EMPTY;
+    inform_sparse_dist sources    = INFORM_SPARSE_DIST_EMPTY;
+    inform_sparse_dist predicates = INFORM_SPARSE_DIST_EMPTY;
+
+    double value = NAN;
+    if (!inform_sparse_init(&states) || !inform_sparse_init(&histories) ||
+        !inform_sparse_init(&sources) || !inform_sparse_init(&predicates))
+    {
+        INFORM_ERROR(err, INFORM_ENOMEM);
+    }
+    else if (!accumulate_sparse_observations(src, dst, back, l, n, m, b, k,
+        &states, &histories, &sources, &predicates))
+    {
+        INFORM_ERROR(err, INFORM_ENOMEM);
+    }
+    else if (te == NULL)
+    {
+        value = (inform_sparse_xlogx(&states) + inform_sparse_xlogx(&histories)
+            - inform_sparse_xlogx(&sources) - inform_sparse_xlogx(&predicates)) / N;
+    }
+    else
+    {
+        sparse_local_values(src, dst, back, l, n, m, b, k, &states, &histories,
+            &sources, &predicates, te);
+        value = 0.0;
+    }
+
+    inform_sparse_free(&predicates);
+    inform_sparse_free(&sources);
+    inform_sparse_free(&histories);
+    inform_sparse_free(&states);
+
+    return value;
+}
+
+/**
+ * The total support of the dense histograms for the transfer entropy.
+ */
+inline static double dense_support(int b, size_t k, size_t l)
+{
+    return pow((double) b, (double) (k + l)) * (b*b + 2*b + 1);
+}
+
 double inform_transfer_entropy(int const *src, int const *dst, int const *back,
     size_t l, size_t n, size_t m, int b, size_t k, inform_error *err)
 {
@@ -168,6 +356,11 @@ double inform_transfer_entropy(int const *src, int const *dst, int const *back,
 
     size_t const N = n * (m - k);
 
+    if (inform_sparse_preferred(dense_support(b, k, l), N))
+    {
+        return sparse_transfer_entropy(src, dst, back, l, n, m, b, k, NULL, err);
+    }
+
     size_t const q = (size_t) pow((double) b, (double) k);
     size_t const r = (size_t) pow((double) b, (double) l);
     size_t const states_size     = b*b*q*r;
@@ -175,62 +368,43 @@ double inform_transfer_entropy(int const *src, int const *dst, int const *back,
     size_t const sources_size    = b*q*r;
     size_t const predicates_size = b*q*r;
     size_t const total_size = states_size + histories_size + sources_size + predicates_size;
+    size_t const chunks = inform_parallel_chunks(N, total_size);
+    size_t const width = inform_counts_width(N);
 
-    uint32_t *data = calloc(total_size, sizeof(uint32_t));
+    void *data = calloc(chunks * total_size, width);
     if (data == NULL)
     {
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
     }
 
-    inform_dist states     = { data, states_size, N };
-    inform_dist histories  = { data + states_size, histories_size, N };
-    inform_dist sources    = { data + states_size + histories_size, sources_size, N };
-    inform_dist predicates = { data + states_size + histories_size + sources_size, predicates_size, N };
-
-    accumulate_observations(src, dst, back, l, n, m, b, k, &states, &histories,
-        &sources, &predicates);
-
-
-    double te = 0.0;
-    int predicate, source, state;
-    double n_state, n_source, n_predicate, n_history;
-    for (int history = 0; history < (int) histories_size; ++history)
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
     {
-        n_history = histories.histogram[history];
-        if (n_history == 0)
-        {
-            continue;
-        }
-        for (int future = 0; future < b; ++future)
-        {
-            predicate = history * b + future;
-            n_predicate = predicates.histogram[predicate];
-            if (n_predicate == 0)
-            {
-                continue;
-            }
-            for (int src_state = 0; src_state < b; ++src_state)
-            {
-                source = history * b + src_state;
-                n_source = sources.histogram[source];
-                if (n_source == 0)
-                {
-                    continue;
-                }
-                state = predicate * b + src_state;
-                n_state = states.histogram[state];
-                if (n_state == 0)
-                {
-                    continue;
-                }
-                te += n_state * log2((n_state * n_history) / (n_source * n_predicate));
-            }
-        }
+        void *chunk = inform_counts_at(data, width, c * total_size);
+        size_t begin, end;
+        inform_parallel_range(N, c, chunks, &begin, &end);
+        accumulate_observations(src, dst, back, l, n, m, b, k, begin, end,
+            width, chunk, inform_counts_at(chunk, width, states_size),
+            inform_counts_at(chunk, width, states_size + histories_size),
+            inform_counts_at(chunk, width,
+                states_size + histories_size + sources_size));
     }
+    inform_counts_merge(data, width, total_size, chunks);
+
+    double const te = (inform_counts_xlogx(data, width, states_size)
+        + inform_counts_xlogx(inform_counts_at(data, width, states_size), width,
+            histories_size)
+        - inform_counts_xlogx(inform_counts_at(data, width,
+            states_size + histories_size), width, sources_size)
+        - inform_counts_xlogx(inform_counts_at(data, width,
+            states_size + histories_size + sources_size), width, predicates_size))
+        / N;
 
     free(data);
 
-    return te / N;
+    return te;
 }
 
 double *inform_local_transfer_entropy(int const *src, int const *dst,
@@ -241,6 +415,12 @@ double *inform_local_transfer_entropy(int const *src, int const *dst,
 
     size_t const N = n * (m - k);
 
+    // the local histograms have 32-bit counters
+    if (N > UINT32_MAX)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESIZE, NULL);
+    }
+
     bool allocate = (te == NULL);
     if (allocate)
     {
@@ -251,6 +431,16 @@ double *inform_local_transfer_entropy(int const *src, int const *dst,
         }
     }
 
+    if (inform_sparse_preferred(dense_support(b, k, l), N))
+    {
+        if (isnan(sparse_transfer_entropy(src, dst, back, l, n, m, b, k, te, err)))
+        {
+            if (allocate) free(te);
+            return NULL;
+        }
+        return te;
+    }
+
     size_t const q = (size_t) pow((double) b, (double) k);
     size_t const r = (size_t) pow((double) b, (double) l);
     size_t const states_size     = b*b*q*r;
@@ -261,41 +451,20 @@ double *inform_local_transfer_entropy(int const *src, int const *dst,
 
     uint32_t *histogram_data = calloc(total_size, sizeof(uint32_t));
     if (histogram_data == NULL)
-    {
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
-    }
-
-    inform_dist states     = { histogram_data, states_size, N };
-    inform_dist histories  = { histogram_data + states_size, histories_size, N };
-    inform_dist sources    = { histogram_data + states_size + histories_size, sources_size, N };
-    inform_dist predicates = { histogram_data + states_size + histories_size + sources_size, predicates_size, N };
-
-    int *state_data = malloc(4 * N * sizeof(int));
-    if (state_data == NULL)
     {
         if (allocate) free(te);
-        free(histogram_data);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
-    int *state     = state_data;
-    int *history   = state + N;
-    int *source    = history + N;
-    int *predicate = source + N;
+    uint32_t *states     = histogram_data;
+    uint32_t *histories  = states + states_size;
+    uint32_t *sources    = histories + histories_size;
+    uint32_t *predicates = sources + sources_size;
 
-    accumulate_local_observations(src, dst, back, l, n, m, b, k, &states,
-        &histories, &sources, &predicates, state, history, source, predicate);
-
-    double s, t, u, v;
-    for (size_t i = 0; i < N; ++i)
-    {
-        s = states.histogram[state[i]];
-        t = sources.histogram[source[i]];
-        u = predicates.histogram[predicate[i]];
-        v = histories.histogram[history[i]];
-        te[i] = log2((s*v)/(t*u));
-    }
+    accumulate_uint32_t(src, dst, back, l, n, m, b, k, 0, N, states, histories,
+        sources, predicates);
+    local_values(src, dst, back, l, n, m, b, k, states, histories, sources,
+        predicates, te);
 
-    free(state_data);
     free(histogram_data);
 
     return te;
@@ -6,6 +6,76 @@
 #include <inform/utilities/binning.h>
 #include <math.h>
 #include <string.h>
+#include "../parallel.h"
+
+/// the leading mantissa bits which distinguish the buckets of a quantile
+/// sketch, so that its quantiles are within a relative 2^-7 of the truth
+#define INFORM_QUANTILE_PRECISION 7
+/// the number of buckets of a quantile sketch, one for each sign, exponent
+/// and leading mantissa bits of a double
+#define INFORM_QUANTILE_BUCKETS ((size_t) 1 << (12 + INFORM_QUANTILE_PRECISION))
+
+struct inform_quantile_sketch
+{
+    /// the number of values added to each bucket
+    uint64_t *counts;
+    /// the number of values added
+    uint64_t n;
+    /// the least and greatest values added
+    double min, max;
+};
+
+/**
+ * Allocate scratch space for each of `*chunks` chunks, or else reduce
+ * `*chunks` to 1 and use `local`, so that running out of memory only costs
+ * parallelism.
+ */
+static void *chunk_scratch(size_t *chunks, size_t size, void *local)
+{
+    void *data = (*chunks > 1) ? malloc(*chunks * size) : NULL;
+    if (data == NULL)
+    {
+        *chunks = 1;
+        return local;
+    }
+    return data;
+}
+
+/**
+ * Find the least and greatest values of a series, each thread scanning one
+ * of `chunks` chunks of it.
+ */
+static void range(double const *series, size_t n, size_t chunks, double *min,
+    double *max)
+{
+    double local[2];
+    double *bounds = chunk_scratch(&chunks, 2 * sizeof(double), local);
+
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        size_t begin, end;
+        inform_parallel_range(n, c, chunks, &begin, &end);
+        double a = series[begin], b = series[begin];
+        for (size_t i = begin + 1; i < end; ++i)
+        {
+            if (series[i] < a) a = series[i];
+            if (b < series[i]) b = series[i];
+        }
+        bounds[2*c] = a;
+        bounds[2*c + 1] = b;
+    }
+
+    *min = *max = series[0];
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        if (bounds[2*c] < *min) *min = bounds[2*c];
+        if (*max < bounds[2*c + 1]) *max = bounds[2*c + 1];
+    }
+    if (bounds != local) free(bounds);
+}
 
 double inform_range(double const *series, size_t n, double *min, double *max,
     inform_error *err)
@@ -15,12 +85,8 @@ double inform_range(double const *series, size_t n, double *min, double *max,
     else if (n == 0)
         INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, 0.0);
 
-    double a = series[0], b = series[0];
-    for (size_t i = 1; i < n; ++i)
-    {
-        if (series[i] < a) a = series[i];
-        if (b < series[i]) b = series[i];
-    }
+    double a, b;
+    range(series, n, inform_parallel_chunks(n, 0), &a, &b);
     if (min != NULL) *min = a;
     if (max != NULL) *max = b;
     return (b - a);
@@ -38,9 +104,13 @@ double inform_bin(double const *series, size_t n, int b, int *binned,
     else if (binned == NULL)
         INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0.0);
 
+    // The bins depend on the range of the whole series, so it cannot be
+    // binned as it is scanned; instead each thread bins the same chunk that
+    // it scanned for the range.
+    size_t const chunks = inform_parallel_chunks(n, 0);
     double min, max;
-    double range = inform_range(series, n, &min, &max, err);
-    double step = range / b;
+    range(series, n, chunks, &min, &max);
+    double step = (max - min) / b;
 
     if (step <= 10.*DBL_EPSILON)
     {
@@ -48,10 +118,19 @@ double inform_bin(double const *series, size_t n, int b, int *binned,
         INFORM_ERROR_RETURN(err, INFORM_EBIN, step);
     }
 
-    for (size_t i = 0; i < n; ++i)
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
     {
-        binned[i] = (int) floor((series[i] - min) / step) - (series[i] == max);
-        assert(0 <= binned[i] && binned[i] < b);
+        size_t begin, end;
+        inform_parallel_range(n, c, chunks, &begin, &end);
+        for (size_t i = begin; i < end; ++i)
+        {
+            binned[i] = (int) floor((series[i] - min) / step)
+                - (series[i] == max);
+            assert(0 <= binned[i] && binned[i] < b);
+        }
     }
 
     return step;
@@ -69,21 +148,106 @@ int inform_bin_step(double const *series, size_t n, double step, int *binned,
     else if (binned == NULL)
         INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0);
 
+    size_t const chunks = inform_parallel_chunks(n, 0);
     double min, max;
-    double range = inform_range(series, n, &min, &max, err);
+    range(series, n, chunks, &min, &max);
+    double const range = max - min;
     int b = (int) ceil(range / step);
 
     if (fmod(range,step) == 0.0) ++b;
 
-    for (size_t i = 0; i < n; ++i)
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
     {
-        binned[i] = (int) floor((series[i] - min) / step);
-        assert(0 <= binned[i] && binned[i] < b);
+        size_t begin, end;
+        inform_parallel_range(n, c, chunks, &begin, &end);
+        for (size_t i = begin; i < end; ++i)
+        {
+            binned[i] = (int) floor((series[i] - min) / step);
+            assert(0 <= binned[i] && binned[i] < b);
+        }
     }
 
     return b;
 }
 
+/**
+ * The index of the first of the `m` bounds which exceeds `x`, or `m` if
+ * none do, for bounds in ascending order. The search halves the bounds
+ * without branching on them, so its cost does not depend on the data.
+ */
+inline static int search_bounds(double x, double const *bounds, size_t m)
+{
+    size_t base = 0;
+    for (size_t len = m; len > 1; len -= len / 2)
+    {
+        base += (x < bounds[base + len / 2]) ? 0 : len / 2;
+    }
+    return (int) (base + !(x < bounds[base]));
+}
+
+/**
+ * The index of the first of the `m` bounds which exceeds `x`, or `m` if
+ * none do, for bounds in any order.
+ */
+inline static int scan_bounds(double x, double const *bounds, size_t m)
+{
+    for (size_t i = 0; i < m; ++i)
+    {
+        if (x < bounds[i])
+        {
+            return (int) i;
+        }
+    }
+    return (int) m;
+}
+
+/**
+ * Bin a series by its bounds, searching them if they are sorted, and
+ * return the number of bins used.
+ */
+static int bin_bounds(double const *series, size_t n, double const *bounds,
+    size_t m, int *binned)
+{
+    bool sorted = true;
+    for (size_t i = 1; i < m && sorted; ++i)
+    {
+        // NaN bounds can only be scanned
+        sorted = (bounds[i-1] <= bounds[i]);
+    }
+
+    int local;
+    size_t chunks = inform_parallel_chunks(n, 0);
+    int *top = chunk_scratch(&chunks, sizeof(int), &local);
+
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        size_t begin, end;
+        inform_parallel_range(n, c, chunks, &begin, &end);
+        int b = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            binned[i] = sorted ? search_bounds(series[i], bounds, m)
+                : scan_bounds(series[i], bounds, m);
+            b = (b < binned[i]) ? binned[i] : b;
+        }
+        top[c] = b;
+    }
+
+    int b = 0;
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        b = (b < top[c]) ? top[c] : b;
+    }
+    if (top != &local) free(top);
+    return b + 1;
+}
+
 int inform_bin_bounds(double const *series, size_t n, double const *bounds,
     size_t m, int *binned, inform_error *err)
 {
@@ -96,20 +260,258 @@ int inform_bin_bounds(double const *series, size_t n, double const *bounds,
     else if (binned == NULL)
         INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0);
 
-    int b = 0;
-    for (size_t i = 0; i < n; ++i)
+    return bin_bounds(series, n, bounds, m, binned);
+}
+
+/**
+ * The bucket of a quantile sketch which holds a value: the leading bits of
+ * the value, ordered as the values are by flipping the negative ones.
+ */
+inline static size_t bucket_of(double x)
+{
+    uint64_t u;
+    memcpy(&u, &x, sizeof(u));
+    u = (u >> 63) ? ~u : (u | ((uint64_t) 1 << 63));
+    return (size_t) (u >> (52 - INFORM_QUANTILE_PRECISION));
+}
+
+/**
+ * The least value which falls in a bucket of a quantile sketch.
+ */
+inline static double bucket_floor(size_t bucket)
+{
+    uint64_t u = (uint64_t) bucket << (52 - INFORM_QUANTILE_PRECISION);
+    u = (u >> 63) ? (u & ~((uint64_t) 1 << 63)) : ~u;
+    double x;
+    memcpy(&x, &u, sizeof(x));
+    return x;
+}
+
+inform_quantile_sketch *inform_quantile_sketch_alloc(inform_error *err)
+{
+    inform_quantile_sketch *sketch = malloc(sizeof(inform_quantile_sketch));
+    if (sketch == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    sketch->counts = calloc(INFORM_QUANTILE_BUCKETS, sizeof(uint64_t));
+    if (sketch->counts == NULL)
+    {
+        free(sketch);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    sketch->n = 0;
+    sketch->min = INFINITY;
+    sketch->max = -INFINITY;
+    return sketch;
+}
+
+void inform_quantile_sketch_free(inform_quantile_sketch *sketch)
+{
+    if (sketch)
+    {
+        free(sketch->counts);
+        free(sketch);
+    }
+}
+
+void inform_quantile_sketch_add(inform_quantile_sketch *sketch,
+    double const *series, size_t n, inform_error *err)
+{
+    if (sketch == NULL)
+        INFORM_ERROR_RETURN_VOID(err, INFORM_EARG);
+    else if (series == NULL)
+        INFORM_ERROR_RETURN_VOID(err, INFORM_ETIMESERIES);
+    else if (n == 0)
+        return;
+
+    // Every chunk but the first counts into its own buckets, which are then
+    // added to the sketch's.
+    size_t chunks = inform_parallel_chunks(n, INFORM_QUANTILE_BUCKETS);
+    uint64_t *copies = (chunks > 1) ?
+        calloc((chunks - 1) * INFORM_QUANTILE_BUCKETS, sizeof(uint64_t)) : NULL;
+    if (copies == NULL)
     {
-        binned[i] = (int)m;
-        for (int x = 0; x < (int)m; ++x)
+        chunks = 1;
+    }
+    double min, max;
+    range(series, n, chunks, &min, &max);
+
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        uint64_t *counts = (c == 0) ? sketch->counts
+            : copies + (c - 1) * INFORM_QUANTILE_BUCKETS;
+        size_t begin, end;
+        inform_parallel_range(n, c, chunks, &begin, &end);
+        for (size_t i = begin; i < end; ++i)
         {
-            if (series[i] < bounds[x])
+            counts[bucket_of(series[i])]++;
+        }
+    }
+
+    if (copies != NULL)
+    {
+#ifdef _OPENMP
+        #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+        for (size_t i = 0; i < INFORM_QUANTILE_BUCKETS; ++i)
+        {
+            for (size_t c = 1; c < chunks; ++c)
             {
-                binned[i] = x;
-                break;
+                sketch->counts[i] += copies[(c - 1) * INFORM_QUANTILE_BUCKETS + i];
             }
         }
-        b = (b < binned[i]) ? binned[i] : b;
+        free(copies);
     }
 
-    return b + 1;
+    sketch->n += n;
+    if (min < sketch->min) sketch->min = min;
+    if (sketch->max < max) sketch->max = max;
+}
+
+/**
+ * Estimate the values of ascending (zero-based) ranks from a sketch: the
+ * least value of the bucket which holds each rank, within the values added,
+ * except that the last rank is the greatest value. Ranks beyond the values
+ * added, e.g. any rank of an empty sketch, are NaN.
+ */
+static void sketch_values(inform_quantile_sketch const *sketch,
+    uint64_t const *ranks, size_t m, double *values)
+{
+    for (size_t j = 0; j < m; ++j)
+    {
+        values[j] = NAN;
+    }
+    uint64_t seen = 0;
+    for (size_t bucket = 0, j = 0; bucket < INFORM_QUANTILE_BUCKETS && j < m;
+        ++bucket)
+    {
+        seen += sketch->counts[bucket];
+        for (; j < m && ranks[j] < seen; ++j)
+        {
+            double x = bucket_floor(bucket);
+            if (!(sketch->min <= x)) x = sketch->min;
+            if (sketch->max < x || ranks[j] + 1 == sketch->n) x = sketch->max;
+            values[j] = x;
+        }
+    }
+}
+
+double inform_quantile_sketch_query(inform_quantile_sketch const *sketch,
+    double q, inform_error *err)
+{
+    if (sketch == NULL || !(0.0 <= q && q <= 1.0))
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NAN);
+    else if (sketch->n == 0)
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, NAN);
+
+    uint64_t const rank = (uint64_t) (q * (sketch->n - 1));
+    double value;
+    sketch_values(sketch, &rank, 1, &value);
+    return value;
+}
+
+static int compare_doubles(void const *a, void const *b)
+{
+    double x = *(double const*)a;
+    double y = *(double const*)b;
+    if (x < y) return -1;
+    if (y < x) return  1;
+    return 0;
+}
+
+/**
+ * Find the value of rank `i * n / b` for each `0 < i < b`, exactly by
+ * sorting a copy of the series if it is no larger than a sketch, and
+ * otherwise from a sketch of it.
+ */
+static bool quantile_bounds(double const *series, size_t n, int b,
+    double *bounds, inform_error *err)
+{
+    if (n <= INFORM_QUANTILE_BUCKETS)
+    {
+        double *sorted = malloc(n * sizeof(double));
+        if (sorted == NULL)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, false);
+        }
+        memcpy(sorted, series, n * sizeof(double));
+        qsort(sorted, n, sizeof(double), compare_doubles);
+        for (int i = 1; i < b; ++i)
+        {
+            bounds[i-1] = sorted[(uint64_t) i * n / b];
+        }
+        free(sorted);
+        return true;
+    }
+
+    uint64_t *ranks = malloc((b - 1) * sizeof(uint64_t));
+    inform_quantile_sketch *sketch = (ranks == NULL) ? NULL :
+        inform_quantile_sketch_alloc(err);
+    if (sketch == NULL)
+    {
+        free(ranks);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, false);
+    }
+    inform_quantile_sketch_add(sketch, series, n, err);
+    for (int i = 1; i < b; ++i)
+    {
+        ranks[i-1] = (uint64_t) i * n / b;
+    }
+    sketch_values(sketch, ranks, b - 1, bounds);
+    inform_quantile_sketch_free(sketch);
+    free(ranks);
+    return true;
+}
+
+int inform_bin_quantiles(double const *series, size_t n, int b, int *binned,
+    inform_error *err)
+{
+    if (series == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0);
+    else if (n == 0)
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, 0);
+    else if (b < 2)
+        INFORM_ERROR_RETURN(err, INFORM_EBIN, 0);
+    else if (binned == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0);
+
+    double *bounds = malloc((b - 1) * sizeof(double));
+    if (bounds == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, 0);
+    }
+    if (!quantile_bounds(series, n, b, bounds, err))
+    {
+        free(bounds);
+        return 0;
+    }
+
+    // Values tied across a quantile share a bin, so repeated bounds are
+    // dropped, as is a bound at the least value, which no value is below.
+    double min, max;
+    range(series, n, inform_parallel_chunks(n, 0), &min, &max);
+    size_t m = 0;
+    for (int i = 0; i < b - 1; ++i)
+    {
+        if (min < bounds[i] && (m == 0 || bounds[m-1] < bounds[i]))
+        {
+            bounds[m++] = bounds[i];
+        }
+    }
+
+    int bins = 1;
+    if (m == 0)
+    {
+        memset(binned, 0, n * sizeof(int));
+    }
+    else
+    {
+        bins = bin_bounds(series, n, bounds, m, binned);
+    }
+    free(bounds);
+    return bins;
 }
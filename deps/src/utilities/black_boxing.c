@@ -1,14 +1,15 @@
 // Copyright 2016-2018 ELIFE. All rights reserved.
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
-#include <inform/error.h>
+#include <inform/utilities/black_boxing.h>
 #include <string.h>
 #include <math.h>
 
 #include <stdio.h>
 
 static bool check_arguments(int const *series, size_t l, size_t n, size_t m,
-    int const *b, size_t const *r, size_t const *s, inform_error *err)
+    int const *b, size_t const *r, size_t const *s, double max_bits,
+    inform_error *err)
 {
 
     if (series == NULL)
@@ -84,7 +85,7 @@ static bool check_arguments(int const *series, size_t l, size_t n, size_t m,
             bits += s[i] * log2(b[i]);
         }
     }
-    if (bits > 30.0)
+    if (bits > max_bits)
     {
         INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
     }
@@ -133,50 +134,89 @@ static void compute_lengths(size_t const *r, size_t const *s, size_t l,
     }
 }
 
-static void accumulate(int const *series, size_t l, size_t n, size_t m,
-    int const *b, size_t const *r, size_t const *s, size_t max_r, size_t max_s,
-    int *box, inform_error *err)
+/**
+ * Define a function `accumulate_TYPE` which black boxes the series into an
+ * array of TYPE, so that 32- and 64-bit boxes share one implementation.
+ */
+#define DEFINE_ACCUMULATE(TYPE) \
+static void accumulate_##TYPE(int const *series, size_t l, size_t n, size_t m, \
+    int const *b, size_t const *r, size_t const *s, size_t max_r, size_t max_s, \
+    TYPE *box, inform_error *err) \
+{ \
+    TYPE *data = malloc(2 * l * sizeof(TYPE)); \
+    if (data == NULL) INFORM_ERROR_RETURN_VOID(err, INFORM_ENOMEM); \
+ \
+    TYPE *qs = data, *states = qs + l; \
+    size_t const w = m - max_r - max_s + 1; \
+    for (size_t i = 0; i < n * w; ++i) box[i] = 0; \
+ \
+    for (size_t i = 0; i < l; ++i) \
+    { \
+        for (size_t j = 0; j < n; ++j) \
+        { \
+            qs[i] = 1; \
+            states[i] = 0; \
+            for (size_t k = max_r - r[i]; k < max_r + s[i]; ++k) \
+            { \
+                qs[i] *= b[i]; \
+                states[i] *= b[i]; \
+                states[i] += series[k + m * (j + n * i)]; \
+            } \
+            box[w * j] *= qs[i]; \
+            box[w * j] += states[i]; \
+ \
+            for (size_t k = max_r; k < m - max_s; ++k) \
+            { \
+                states[i] *= b[i]; \
+                states[i] -= series[k - r[i] + m * (j + n * i)] * qs[i]; \
+                states[i] += series[k + s[i] + m * (j + n * i)]; \
+                box[k - max_r + 1 + w * j] *= qs[i]; \
+                box[k - max_r + 1 + w * j] += states[i]; \
+            } \
+        } \
+    } \
+ \
+    free(data); \
+}
+
+DEFINE_ACCUMULATE(int)
+DEFINE_ACCUMULATE(int64_t)
+
+/**
+ * Fill `history` and `future` with the history and future length of each
+ * series, substituting the defaults for NULL `r` and `s`.
+ */
+static size_t *lengths(size_t const *r, size_t const *s, size_t l)
 {
-    int *data = malloc(2 * l * sizeof(int));
-    if (data == NULL) INFORM_ERROR_RETURN_VOID(err, INFORM_ENOMEM);
+    size_t *data = calloc(2 * l, sizeof(size_t));
+    if (data == NULL)
+    {
+        return NULL;
+    }
 
-    int *qs = data, *states = qs + l;
-    size_t const w = m - max_r - max_s + 1;
-    for (size_t i = 0; i < n * w; ++i) box[i] = 0;
-    
-    for (size_t i = 0; i < l; ++i)
+    size_t *history = data;
+    if (r == NULL)
     {
-        for (size_t j = 0; j < n; ++j)
-        {
-            qs[i] = 1;
-            states[i] = 0;
-            for (size_t k = max_r - r[i]; k < max_r + s[i]; ++k)
-            {
-                qs[i] *= b[i];
-                states[i] *= b[i];
-                states[i] += series[k + m * (j + n * i)];
-            }
-            box[w * j] *= qs[i];
-            box[w * j] += states[i];
+        for (size_t i = 0; i < l; ++i) history[i] = 1;
+    }
+    else
+    {
+        memcpy(history, r, l * sizeof(size_t));
+    }
 
-            for (size_t k = max_r; k < m - max_s; ++k)
-            {
-                states[i] *= b[i];
-                states[i] -= series[k - r[i] + m * (j + n * i)] * qs[i];
-                states[i] += series[k + s[i] + m * (j + n * i)];
-                box[k - max_r + 1 + w * j] *= qs[i];
-                box[k - max_r + 1 + w * j] += states[i];
-            }
-        }
+    size_t *future = data + l;
+    if (s != NULL)
+    {
+        memcpy(future, s, l * sizeof(size_t));
     }
-        
-    free(data);
+
+    return data;
 }
 
 int* inform_black_box(int const *series, size_t l, size_t n, size_t m,
     int const *b, size_t const *r, size_t const *s, int *box, inform_error *err)
 {
-    if (check_arguments(series, l, n, m, b, r, s, err))
+    if (check_arguments(series, l, n, m, b, r, s, 30.0, err))
     {
         return NULL;
     }
@@ -193,30 +233,54 @@ int* inform_black_box(int const *series, size_t l, size_t n, size_t m,
         }
     }
 
-    size_t *data = calloc(2 * l, sizeof(size_t));
+    size_t *data = lengths(r, s, l);
     if (data == NULL)
     {
         if (allocate) free(box);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
 
-    size_t *history = data;
-    if (r == NULL)
+    accumulate_int(series, l, n, m, b, data, data + l, max_r, max_s, box, err);
+
+    if (inform_failed(err))
     {
-        for (size_t i = 0; i < l; ++i) history[i] = 1;
+        if (allocate) free(box);
+        box = NULL;
     }
-    else
+    free(data);
+    return box;
+}
+
+int64_t *inform_black_box64(int const *series, size_t l, size_t n, size_t m,
+    int const *b, size_t const *r, size_t const *s, int64_t *box,
+    inform_error *err)
+{
+    if (check_arguments(series, l, n, m, b, r, s, 63.0, err))
     {
-        memcpy(history, r, l * sizeof(size_t));
+        return NULL;
     }
+    size_t max_r, max_s;
+    compute_lengths(r, s, l, &max_r, &max_s);
 
-    size_t *future = data + l;
-    if (s != NULL)
+    bool allocate = (box == NULL);
+    if (allocate)
     {
-        memcpy(future, s, l * sizeof(size_t));
+        box = calloc(n * (m - max_r - max_s + 1), sizeof(int64_t));
+        if (box == NULL)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+
+    size_t *data = lengths(r, s, l);
+    if (data == NULL)
+    {
+        if (allocate) free(box);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
 
-    accumulate(series, l, n, m, b, history, future, max_r, max_s, box, err);
+    accumulate_int64_t(series, l, n, m, b, data, data + l, max_r, max_s, box,
+        err);
 
     if (inform_failed(err))
     {
@@ -237,7 +301,7 @@ static int compare_ints(void const *x, void const *y)
 int *inform_black_box_parts(int const *series, size_t l, size_t n, int const *b,
     size_t const *parts, size_t nparts, int *box, inform_error *err)
 {
-    if (check_arguments(series, l, 1, n, b, NULL, NULL, err))
+    if (check_arguments(series, l, 1, n, b, NULL, NULL, 30.0, err))
     {
         return NULL;
     }
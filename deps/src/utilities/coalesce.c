@@ -2,63 +2,339 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include <inform/utilities/coalesce.h>
+#include <limits.h>
 #include <string.h>
+#include "../parallel.h"
+#include "../sparse.h"
 
-static int compare_ints(void const *a, void const *b)
+/// the widest range of states, relative to the length of the series, which
+/// is coalesced through a table indexed by state rather than a hash table
+#define INFORM_COALESCE_DENSE_RATIO 4
+
+struct inform_coalescer
+{
+    /// the symbol of each state observed so far, plus one, keyed by the state
+    inform_sparse_dist symbols;
+    /// the state of each symbol
+    int64_t *states;
+    /// the number of states that fit in `states`
+    size_t capacity;
+};
+
+static int compare_int64s(void const *a, void const *b)
 {
-    int x = *(int const*)a;
-    int y = *(int const*)b;
+    int64_t x = *(int64_t const*)a;
+    int64_t y = *(int64_t const*)b;
     if (x < y) return -1;
     if (y < x) return  1;
     return 0;
 }
 
-int inform_coalesce(int const *series, size_t n, int *coal, inform_error *err)
+static bool check_arguments(void const *series, size_t n, int const *coal,
+    inform_error *err)
 {
     if (series == NULL)
-        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0);
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
     else if (n == 0)
-        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, 0);
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, true);
     else if (coal == NULL)
-        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0);
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    return false;
+}
 
-    int *tmp = malloc(n * sizeof(int));
-    if (tmp == NULL)
+/**
+ * The state at index `i` of a series of `int64_t` if `wide`, and of `int`
+ * otherwise, so that both kinds of series share one implementation.
+ */
+inline static int64_t state_at(void const *series, bool wide, size_t i)
+{
+    return wide ? ((int64_t const*) series)[i] : ((int const*) series)[i];
+}
+
+static bool bounds(void const *series, bool wide, size_t n, int64_t *min,
+    int64_t *max)
+{
+    size_t const chunks = inform_parallel_chunks(n, 0);
+    int64_t *data = malloc(2 * chunks * sizeof(int64_t));
+    if (data == NULL)
     {
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, 0);
+        return false;
+    }
+
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        size_t begin, end;
+        inform_parallel_range(n, c, chunks, &begin, &end);
+        int64_t lo = state_at(series, wide, begin), hi = lo;
+        for (size_t i = begin + 1; i < end; ++i)
+        {
+            int64_t const x = state_at(series, wide, i);
+            if (x < lo) lo = x;
+            if (hi < x) hi = x;
+        }
+        data[2*c] = lo;
+        data[2*c + 1] = hi;
     }
-    memcpy(tmp, series, n * sizeof(int));
-    qsort(tmp, n, sizeof(int), compare_ints);
-    int b = 1;
-    for (size_t i = 1; i < n; ++i)
+
+    *min = *max = state_at(series, wide, 0);
+    for (size_t c = 0; c < chunks; ++c)
     {
-        if (tmp[i] != tmp[i-1]) ++b;
+        if (data[2*c] < *min) *min = data[2*c];
+        if (*max < data[2*c + 1]) *max = data[2*c + 1];
     }
+    free(data);
+    return true;
+}
 
-    int *map = malloc(b * sizeof(int));
-    if (map == NULL)
+/**
+ * Number the states through a table indexed by state, for states which
+ * span `width` values from `min`.
+ */
+static int dense_coalesce(void const *series, bool wide, size_t n,
+    int64_t min, size_t width, int *coal, inform_error *err)
+{
+    int *symbol = calloc(width, sizeof(int));
+    if (symbol == NULL)
     {
-        free(tmp);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, 0);
     }
-    map[0] = tmp[0];
-    for (size_t i = 1, j = 1; i < n; ++i)
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        symbol[(uint64_t) state_at(series, wide, i) - (uint64_t) min] = 1;
+    }
+    size_t b = 0;
+    for (size_t x = 0; x < width; ++x)
+    {
+        if (symbol[x]) symbol[x] = (int) b++;
+    }
+    if (b > INT_MAX)
+    {
+        free(symbol);
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, 0);
+    }
+
+    size_t const chunks = inform_parallel_chunks(n, 0);
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
     {
-        if (tmp[i] != tmp[i-1]) map[j++] = tmp[i];
+        size_t begin, end;
+        inform_parallel_range(n, c, chunks, &begin, &end);
+        for (size_t i = begin; i < end; ++i)
+        {
+            coal[i] = symbol[(uint64_t) state_at(series, wide, i)
+                - (uint64_t) min];
+        }
     }
-    free(tmp);
 
+    free(symbol);
+    return (int) b;
+}
+
+/**
+ * Number the states by collecting the distinct ones in a hash table,
+ * sorting only those, and looking each observation up in the table.
+ */
+static int sparse_coalesce(void const *series, bool wide, size_t n,
+    int *coal, inform_error *err)
+{
+    inform_sparse_dist table = INFORM_SPARSE_DIST_EMPTY;
+    if (!inform_sparse_init(&table))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, 0);
+    }
     for (size_t i = 0; i < n; ++i)
     {
-        int *x = bsearch(series + i, map, b, sizeof(int), compare_ints);
-        if (x == NULL)
+        uint64_t const key = (uint64_t) state_at(series, wide, i);
+        if (inform_sparse_insert(&table, key, 1) == NULL)
+        {
+            inform_sparse_free(&table);
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, 0);
+        }
+    }
+
+    size_t const b = table.size;
+    if (b > INT_MAX)
+    {
+        inform_sparse_free(&table);
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, 0);
+    }
+    int64_t *states = malloc(b * sizeof(int64_t));
+    if (states == NULL)
+    {
+        inform_sparse_free(&table);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, 0);
+    }
+    for (size_t i = 0, j = 0; i < table.capacity; ++i)
+    {
+        if (table.histogram[i] != 0) states[j++] = (int64_t) table.keys[i];
+    }
+    qsort(states, b, sizeof(int64_t), compare_int64s);
+    // every state is already in the table, so this only relabels them
+    for (size_t j = 0; j < b; ++j)
+    {
+        *inform_sparse_insert(&table, (uint64_t) states[j], 1) =
+            (uint32_t) j + 1;
+    }
+    free(states);
+
+    size_t const chunks = inform_parallel_chunks(n, 0);
+#ifdef _OPENMP
+    #pragma omp parallel for if (chunks > 1) schedule(static)
+#endif
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        size_t begin, end;
+        inform_parallel_range(n, c, chunks, &begin, &end);
+        for (size_t i = begin; i < end; ++i)
         {
-            free(map);
-            INFORM_ERROR_RETURN(err, INFORM_EBIN, 0);
+            uint64_t const key = (uint64_t) state_at(series, wide, i);
+            coal[i] = (int) inform_sparse_get(&table, key) - 1;
         }
-        coal[i] = (int) (x - map);
     }
 
-    free(map);
-    return b;
-}
\ No newline at end of file
+    inform_sparse_free(&table);
+    return (int) b;
+}
+
+/**
+ * Coalesce a series through a table indexed by state when its states span
+ * at most `INFORM_COALESCE_DENSE_RATIO` times as many values as there are
+ * observations, and through a hash table otherwise. Either way the states
+ * keep their order, and the observations are looked up in parallel.
+ */
+static int coalesce(void const *series, bool wide, size_t n, int *coal,
+    inform_error *err)
+{
+    int64_t min, max;
+    if (!bounds(series, wide, n, &min, &max))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, 0);
+    }
+    uint64_t const span = (uint64_t) max - (uint64_t) min;
+    if (span / INFORM_COALESCE_DENSE_RATIO < n && span < SIZE_MAX)
+    {
+        return dense_coalesce(series, wide, n, min, (size_t) span + 1, coal,
+            err);
+    }
+    return sparse_coalesce(series, wide, n, coal, err);
+}
+
+int inform_coalesce(int const *series, size_t n, int *coal, inform_error *err)
+{
+    if (check_arguments(series, n, coal, err)) return 0;
+    return coalesce(series, false, n, coal, err);
+}
+
+int inform_coalesce64(int64_t const *series, size_t n, int *coal,
+    inform_error *err)
+{
+    if (check_arguments(series, n, coal, err)) return 0;
+    return coalesce(series, true, n, coal, err);
+}
+
+inform_coalescer *inform_coalescer_alloc(inform_error *err)
+{
+    inform_coalescer *coalescer = malloc(sizeof(inform_coalescer));
+    if (coalescer == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    coalescer->symbols = (inform_sparse_dist) INFORM_SPARSE_DIST_EMPTY;
+    coalescer->states = NULL;
+    coalescer->capacity = 0;
+    if (!inform_sparse_init(&coalescer->symbols))
+    {
+        free(coalescer);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    return coalescer;
+}
+
+void inform_coalescer_free(inform_coalescer *coalescer)
+{
+    if (coalescer)
+    {
+        inform_sparse_free(&coalescer->symbols);
+        free(coalescer->states);
+        free(coalescer);
+    }
+}
+
+int64_t const *inform_coalescer_states(inform_coalescer const *coalescer)
+{
+    return (coalescer == NULL) ? NULL : coalescer->states;
+}
+
+/**
+ * Get the symbol of a state, giving it the next symbol if it has not been
+ * observed before.
+ */
+static int symbol_of(inform_coalescer *coalescer, int64_t state,
+    inform_error *err)
+{
+    size_t const b = coalescer->symbols.size;
+    uint32_t const known = inform_sparse_get(&coalescer->symbols,
+        (uint64_t) state);
+    if (known != 0)
+    {
+        return (int) known - 1;
+    }
+    else if (b == INT_MAX)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, -1);
+    }
+
+    if (b == coalescer->capacity)
+    {
+        size_t const capacity = (b) ? 2 * b : 64;
+        int64_t *states = realloc(coalescer->states,
+            capacity * sizeof(int64_t));
+        if (states == NULL)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, -1);
+        }
+        coalescer->states = states;
+        coalescer->capacity = capacity;
+    }
+    if (inform_sparse_insert(&coalescer->symbols, (uint64_t) state,
+        (uint32_t) b + 1) == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, -1);
+    }
+    coalescer->states[b] = state;
+    return (int) b;
+}
+
+static int push(inform_coalescer *coalescer, void const *series, bool wide,
+    size_t n, int *coal, inform_error *err)
+{
+    if (coalescer == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_EARG, 0);
+    else if (series == NULL || coal == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        coal[i] = symbol_of(coalescer, state_at(series, wide, i), err);
+        if (coal[i] < 0) return 0;
+    }
+    return (int) coalescer->symbols.size;
+}
+
+int inform_coalescer_push(inform_coalescer *coalescer, int const *series,
+    size_t n, int *coal, inform_error *err)
+{
+    return push(coalescer, series, false, n, coal, err);
+}
+
+int inform_coalescer_push64(inform_coalescer *coalescer,
+    int64_t const *series, size_t n, int *coal, inform_error *err)
+{
+    return push(coalescer, series, true, n, coal, err);
+}
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 
+#include <stdbool.h>
 #include <stdlib.h>
 #include <inform/utilities/partitions.h>
 
@@ -41,4 +42,227 @@ size_t inform_next_partitioning(size_t *xs, size_t size)
         }
     }
     return n;
-}
\ No newline at end of file
+}
+/**
+ * Add or multiply, saturating at `SIZE_MAX`.
+ */
+inline static size_t saturating_add(size_t a, size_t b)
+{
+    return (a > SIZE_MAX - b) ? SIZE_MAX : a + b;
+}
+
+inline static size_t saturating_mul(size_t a, size_t b)
+{
+    return (b != 0 && a > SIZE_MAX / b) ? SIZE_MAX : a * b;
+}
+
+/**
+ * Tabulate the number of ways that `r` more elements can be assigned to
+ * partitions once `m` partitions have been used, so that exactly `blocks`
+ * (or any number if `blocks` is zero) are used in the end. The count for
+ * `(r, m)` is at `r * (size + 2) + m`, for `r < size` and `m <= size + 1`.
+ */
+static size_t *completions(size_t size, size_t blocks)
+{
+    size_t const w = size + 2;
+    size_t *table = calloc(size * w, sizeof(size_t));
+    if (table == NULL)
+    {
+        return NULL;
+    }
+    for (size_t m = 1; m < w; ++m)
+    {
+        table[m] = (blocks == 0 || m == blocks) ? 1 : 0;
+    }
+    for (size_t r = 1; r < size; ++r)
+    {
+        for (size_t m = 1; m + 1 < w; ++m)
+        {
+            if (blocks == 0 || m <= blocks)
+            {
+                table[r*w + m] = saturating_add(
+                    saturating_mul(m, table[(r-1)*w + m]),
+                    table[(r-1)*w + m + 1]);
+            }
+        }
+    }
+    return table;
+}
+
+size_t inform_count_partitionings(size_t size, size_t blocks)
+{
+    if (size == 0 || blocks > size)
+    {
+        return 0;
+    }
+    size_t *table = completions(size, blocks);
+    if (table == NULL)
+    {
+        return 0;
+    }
+    size_t const count = table[(size - 1) * (size + 2) + 1];
+    free(table);
+    return count;
+}
+
+size_t *inform_first_partitioning_into(size_t size, size_t blocks)
+{
+    if (blocks > size)
+    {
+        return NULL;
+    }
+    size_t *xs = inform_first_partitioning(size);
+    if (xs != NULL && blocks != 0)
+    {
+        for (size_t i = 1; i < blocks; ++i)
+        {
+            xs[size - blocks + i] = i;
+        }
+    }
+    return xs;
+}
+
+size_t inform_next_partitioning_into(size_t *xs, size_t size, size_t blocks)
+{
+    if (blocks == 0)
+    {
+        return inform_next_partitioning(xs, size);
+    }
+    if (size < 2 || blocks > size)
+    {
+        return 0;
+    }
+
+    // find the last element which can be moved to a later partition while
+    // leaving enough elements after it to fill out the remaining partitions
+    size_t used = 1;
+    size_t last = 0, last_used = 0, last_value = 0;
+    for (size_t i = 1; i < size; ++i)
+    {
+        size_t const limit = (used < blocks - 1) ? used : blocks - 1;
+        for (size_t v = xs[i] + 1; v <= limit; ++v)
+        {
+            size_t const u = (v + 1 > used) ? v + 1 : used;
+            if (u + (size - 1 - i) >= blocks)
+            {
+                last = i;
+                last_used = u;
+                last_value = v;
+                break;
+            }
+        }
+        used = (xs[i] + 1 > used) ? xs[i] + 1 : used;
+    }
+    if (last == 0)
+    {
+        return 0;
+    }
+
+    // and fill in the elements after it as early in the sequence as possible
+    xs[last] = last_value;
+    for (size_t i = last + 1; i < size; ++i)
+    {
+        xs[i] = 0;
+    }
+    for (size_t i = 0; i < blocks - last_used; ++i)
+    {
+        xs[size - blocks + last_used + i] = last_used + i;
+    }
+    return blocks;
+}
+
+size_t inform_rank_partitioning(size_t const *xs, size_t size, size_t blocks)
+{
+    if (xs == NULL || size == 0 || blocks > size || xs[0] != 0)
+    {
+        return SIZE_MAX;
+    }
+    size_t *table = completions(size, blocks);
+    if (table == NULL)
+    {
+        return SIZE_MAX;
+    }
+    size_t const w = size + 2;
+
+    size_t rank = 0, used = 1;
+    for (size_t i = 1; i < size && rank != SIZE_MAX; ++i)
+    {
+        if (xs[i] > used)
+        {
+            rank = SIZE_MAX;
+            break;
+        }
+        size_t const r = size - 1 - i;
+        for (size_t v = 0; v < xs[i]; ++v)
+        {
+            size_t const u = (v + 1 > used) ? v + 1 : used;
+            rank = saturating_add(rank, table[r*w + u]);
+        }
+        used = (xs[i] + 1 > used) ? xs[i] + 1 : used;
+    }
+    if (blocks != 0 && used != blocks)
+    {
+        rank = SIZE_MAX;
+    }
+    if (table[(size - 1) * w + 1] == SIZE_MAX)
+    {
+        rank = SIZE_MAX;
+    }
+
+    free(table);
+    return rank;
+}
+
+size_t *inform_unrank_partitioning(size_t rank, size_t size, size_t blocks,
+    size_t *xs)
+{
+    if (size == 0 || blocks > size)
+    {
+        return NULL;
+    }
+    size_t *table = completions(size, blocks);
+    if (table == NULL)
+    {
+        return NULL;
+    }
+    size_t const w = size + 2;
+    size_t const count = table[(size - 1) * w + 1];
+    if (count == SIZE_MAX || rank >= count)
+    {
+        free(table);
+        return NULL;
+    }
+
+    bool allocate = (xs == NULL);
+    if (allocate)
+    {
+        xs = malloc(size * sizeof(size_t));
+        if (xs == NULL)
+        {
+            free(table);
+            return NULL;
+        }
+    }
+
+    xs[0] = 0;
+    size_t used = 1;
+    for (size_t i = 1; i < size; ++i)
+    {
+        size_t const r = size - 1 - i;
+        for (size_t v = 0; v <= used; ++v)
+        {
+            size_t const u = (v + 1 > used) ? v + 1 : used;
+            size_t const c = table[r*w + u];
+            if (rank < c)
+            {
+                xs[i] = v;
+                used = u;
+                break;
+            }
+            rank -= c;
+        }
+    }
+
+    free(table);
+    return xs;
+}
@@ -28,4 +28,163 @@ int *inform_random_ints(int a, int b, size_t n)
 int *inform_random_series(size_t n, int b)
 {
     return inform_random_ints(0, b, n);
-}
\ No newline at end of file
+}
+
+inline static uint64_t rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+void inform_rng_seed(inform_rng *rng, uint64_t seed)
+{
+    // splitmix64, so that nearby seeds give unrelated states
+    for (size_t i = 0; i < 4; ++i)
+    {
+        seed += 0x9e3779b97f4a7c15;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        rng->state[i] = z ^ (z >> 31);
+    }
+}
+
+uint64_t inform_rng_next(inform_rng *rng)
+{
+    uint64_t *s = rng->state;
+    uint64_t const result = rotl(s[1] * 5, 7) * 9;
+    uint64_t const t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+void inform_rng_jump(inform_rng *rng)
+{
+    static uint64_t const polynomial[4] = {
+        0x180ec6d33cfd0aba, 0xd5a61266f0c9392c,
+        0xa9582618e03fc9aa, 0x39abdc4529b1661c
+    };
+    uint64_t jumped[4] = {0, 0, 0, 0};
+    for (size_t w = 0; w < 4; ++w)
+    {
+        for (int bit = 0; bit < 64; ++bit)
+        {
+            if (polynomial[w] & ((uint64_t) 1 << bit))
+            {
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    jumped[i] ^= rng->state[i];
+                }
+            }
+            inform_rng_next(rng);
+        }
+    }
+    for (size_t i = 0; i < 4; ++i)
+    {
+        rng->state[i] = jumped[i];
+    }
+}
+
+/**
+ * Draw uniformly from [0, n) for n < 2^32 by Lemire's multiply-and-reject
+ * method, which needs a division only on the rare rejections.
+ */
+inline static uint32_t bounded32(inform_rng *rng, uint32_t n)
+{
+    uint64_t m = (inform_rng_next(rng) >> 32) * n;
+    uint32_t l = (uint32_t) m;
+    if (l < n)
+    {
+        uint32_t const threshold = (uint32_t) -n % n;
+        while (l < threshold)
+        {
+            m = (inform_rng_next(rng) >> 32) * n;
+            l = (uint32_t) m;
+        }
+    }
+    return (uint32_t) (m >> 32);
+}
+
+uint64_t inform_rng_bounded(inform_rng *rng, uint64_t n)
+{
+    if (n <= UINT32_MAX)
+    {
+        return bounded32(rng, (uint32_t) n);
+    }
+    // wider ranges reject draws beyond the least power of two above n
+    uint64_t mask = n - 1;
+    mask |= mask >> 1;
+    mask |= mask >> 2;
+    mask |= mask >> 4;
+    mask |= mask >> 8;
+    mask |= mask >> 16;
+    mask |= mask >> 32;
+    uint64_t x;
+    do
+    {
+        x = inform_rng_next(rng) & mask;
+    } while (x >= n);
+    return x;
+}
+
+/**
+ * Sample `[a, b)`, computing in 64 bits since the width of the range and
+ * the sum `a + x` can both exceed the range of `int`.
+ */
+inline static int sample_int(inform_rng *rng, int a, uint32_t width)
+{
+    return (int) ((int64_t) a + bounded32(rng, width));
+}
+
+int inform_rng_int(inform_rng *rng, int a, int b)
+{
+    if (b <= a)
+    {
+        return a;
+    }
+    return sample_int(rng, a, (uint32_t) ((int64_t) b - a));
+}
+
+int *inform_rng_ints(inform_rng *rng, int a, int b, size_t n, int *xs)
+{
+    if (xs == NULL)
+    {
+        xs = malloc(n * sizeof(int));
+        if (xs == NULL)
+            return NULL;
+    }
+    if (b <= a)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            xs[i] = a;
+        }
+        return xs;
+    }
+    uint32_t const width = (uint32_t) ((int64_t) b - a);
+    for (size_t i = 0; i < n; ++i)
+    {
+        xs[i] = sample_int(rng, a, width);
+    }
+    return xs;
+}
+
+int *inform_rng_series(inform_rng *rng, size_t n, int b, int *xs)
+{
+    return inform_rng_ints(rng, 0, b, n, xs);
+}
+
+void inform_rng_shuffle(inform_rng *rng, int *xs, size_t n)
+{
+    for (size_t i = n; i > 1; --i)
+    {
+        size_t const j = (size_t) inform_rng_bounded(rng, i);
+        int const x = xs[i - 1];
+        xs[i - 1] = xs[j];
+        xs[j] = x;
+    }
+}
@@ -0,0 +1,147 @@
+// Copyright 2016-2019 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "xlogx.h"
+
+// Generated with Python:
+//   [0.0] + [c * math.log2(c) for c in range(1, 512)]
+double const inform_xlogx_table[INFORM_XLOGX_TABLE_SIZE] = {
+    0.0, 0.0, 2, 4.7548875021634682,
+    8, 11.60964047443681, 15.509775004326936, 19.651484454403228,
+    24, 28.529325012980809, 33.219280948873624, 38.053747805010268,
+    43.019550008653873, 48.105716335834195, 53.302968908806456, 58.603358934127783,
+    64, 69.486868301255768, 75.058650025961612, 80.710622755428119,
+    86.438561897747249, 92.23866587835397, 98.107495610020536, 104.0419249893113,
+    110.03910001730775, 116.09640474436812, 122.21143267166839, 128.38196255841365,
+    134.6059378176129, 140.88144885869957, 147.20671786825557, 153.58008562199313,
+    160, 166.46500593882897, 172.97373660251154, 179.52490559307381,
+    186.11730005192322, 192.74977452827116, 199.42124551085624, 206.13068653562769,
+    212.8771237954945, 219.65963218934144, 226.47733175670794, 233.3293844521902,
+    240.21499122004107, 247.13338933483536, 254.0838499786226, 261.06567602884894,
+    268.07820003461552, 275.12078236164518, 282.1928094887362, 289.29369244054624,
+    296.42286534333675, 303.57978409184955, 310.76392511682729, 317.97478424385628,
+    325.21187563522579, 332.47473080739024, 339.76289771739914, 347.07593991234864,
+    354.41343573651113, 361.7749775913361, 369.16017124398627, 376.56863518049477,
+    384, 391.45390784684952, 398.93001187765793, 406.42797576067073,
+    413.94747320502307, 421.48818751769369, 429.04981118614762, 436.63204548483242,
+    444.23460010384645, 451.85719279824127, 459.49954905654232, 467.16140178719104,
+    474.84249102171248, 482.54256363350737, 490.26137307125538, 497.99867910599113,
+    505.754247590989, 513.52785023365459, 521.31926437868287, 529.12827280179476,
+    536.95466351341588, 544.79822957170461, 552.65876890438039, 560.53608413883933,
+    568.4299824400822, 576.34027535600944, 584.26677866967077, 592.20931225808135,
+    600.16769995724519, 608.14176943304687, 616.13135205769788, 624.13628279144007,
+    632.15640006923104, 640.19154569215141, 648.24156472329037, 656.30630538788137,
+    664.3856189774724, 672.47935975793121, 680.58738488109248, 688.70955429987146,
+    696.84573068667351, 704.9957793549429, 713.15956818369909, 721.3369675449228,
+    729.52785023365459, 737.73209140068491, 745.94956848771255, 754.18016116486183,
+    762.42375127045159, 770.68022275291628, 778.94946161478049, 787.23135585860314,
+    795.52579543479828, 803.83267219125833, 812.15187982469729, 820.4833138336453,
+    828.82687147302227, 837.18245171022591, 845.54995518267219, 853.92928415672645,
+    862.32034248797254, 870.72303558276087, 879.13727036098953, 887.56295522006496,
+    896, 904.44831594959976, 912.90781569369904, 921.37841320140592,
+    929.86002375531586, 938.3525639216582, 946.85595152134147, 955.37010560186218,
+    963.89494641004615, 972.43039536559206, 980.97637503538738, 989.53280910856756,
+    998.09962237229524, 1006.6767406882299, 1015.2640909696648, 1023.8616011593097,
+    1032.4692002076929, 1041.0868180521654, 1049.7143855964825, 1058.3518346909457,
+    1066.9990981130845, 1075.6561095488621, 1084.3228035743821, 1092.9991156380868,
+    1101.684982043425, 1110.3803399319759, 1119.0851272670147, 1127.7992828175068,
+    1136.5227461425109, 1145.2554575759855, 1153.9973582119824, 1162.7483898902126,
+    1171.5084951819781, 1180.2776173764532, 1189.0557004673092, 1197.8426891396655,
+    1206.6385287573657, 1215.4431653505596, 1224.2565456035895, 1233.0786168431666,
+    1241.9093270268318, 1250.7486247316892, 1259.5964591434092, 1268.4527800454887,
+    1277.3175378087608, 1286.1906833811533, 1295.0721682776787, 1303.9619445706576,
+    1312.8599648801644, 1321.7661823646906, 1330.6805507120189, 1339.6030241303019,
+    1348.5335573393415, 1357.4721055620603, 1366.4186245161627, 1375.3730704059799,
+    1384.3353999144904, 1393.3055701955177, 1402.2835388660937, 1411.269263998988,
+    1420.2627041153958, 1429.2638181777827, 1438.2725655828801, 1447.2889061548281,
+    1456.3128001384621, 1465.3442081927396, 1474.3830913843028, 1483.4294111811741,
+    1492.4831294465807, 1501.5442084329061, 1510.6126107757627, 1519.6882994881862,
+    1528.7712379549448, 1537.8613899269646, 1546.9587195158624, 1556.0631911885907,
+    1565.174769762185, 1574.2934203986165, 1583.4191085997429, 1592.5518002023603,
+    1601.691461373347, 1610.8380586049045, 1619.9915587098858, 1629.151928817216,
+    1638.3191363673982, 1647.4931491081036, 1656.6739350898456, 1665.8614626617341,
+    1675.0557004673092, 1684.2566174404521, 1693.4641828013698, 1702.6783660526571,
+    1711.8991369754251, 1721.1264656255064, 1730.3603223297237, 1739.600677682228,
+    1748.8475025409032, 1758.1007680238333, 1767.3604455058326, 1776.6265066150377,
+    1785.898923229561, 1795.1776674742, 1804.4627117172063, 1813.7540285671091,
+    1823.0515908695966, 1832.3553717044474, 1841.6653443825167, 1850.9814824427749,
+    1860.3037596493946, 1869.6321499888875, 1878.9666276672906, 1888.307167107399,
+    1897.6537429460445, 1907.0063300314209, 1916.3649034204518, 1925.7294383762048,
+    1935.0999103653444, 1944.4762950556299, 1953.8585683134529, 1963.2467062014155,
+    1972.6406849759451, 1982.040481084952, 1991.4460711655217, 2000.8574320416437,
+    2010.2745407219791, 2019.6973743976605, 2029.1259104401299, 2038.5601263990088,
+    2048, 2057.4455091428267, 2066.8966318991997, 2076.3533465108176,
+    2085.8156313873983, 2095.2834651047401, 2104.7568264028118, 2114.2356941838752,
+    2123.720047510632, 2133.2098656043991, 2142.7051278433164, 2152.2058137605773,
+    2161.7119030426829, 2171.2233755277316, 2180.7402112037244, 2190.262390206899,
+    2199.7898928200921, 2209.3226994711199, 2218.8607907311844, 2228.4041473133061,
+    2237.9527500707745, 2247.5065799956251, 2257.0656182171347, 2266.6298460003432,
+    2276.1992447445909, 2285.7737959820802, 2295.35348137646, 2304.9382827214226,
+    2314.5281819393294, 2324.12316107985, 2333.7232023186193, 2343.3282879559224,
+    2352.9384004153858, 2362.5535222426961, 2372.1736361043309, 2381.7987247863102,
+    2391.4287711929651, 2401.0637583457187, 2410.7036693818909, 2420.348487553515,
+    2429.9981962261691, 2439.6527788778276, 2449.3122190977242, 2458.9765005852332,
+    2468.6456071487646, 2478.3195227046704, 2487.9982312761736, 2497.6817169923042,
+    2507.3699640868499, 2517.0629568973259, 2526.7606798639513, 2536.4631175286449,
+    2546.1702545340299, 2555.8820756224518, 2565.598565635014, 2575.3197095106175,
+    2585.0454922850217, 2594.7758990899097, 2604.5109151519705, 2614.2505257919929,
+    2623.9947164239643, 2633.7434725541921, 2643.4967797804247, 2653.2546237909933,
+    2663.0169903639558, 2672.7838653662593, 2682.5552347529069, 2692.3310845661376,
+    2702.1114009346184, 2711.8961700726404, 2721.685378279331, 2731.4790119378731,
+    2741.2770575147315, 2751.0795015588942, 2760.8863307011193, 2770.6975316531889,
+    2780.5130912071791, 2790.3329962347302, 2800.1572336863333, 2809.9857905906206,
+    2819.8186540536635, 2829.6558112582866, 2839.497249463378, 2849.3429560032205,
+    2859.1929182868189, 2869.0471237972429, 2878.9055600909769, 2888.768214797275,
+    2898.6350756175216, 2908.5061303246084, 2918.3813667623072, 2928.2607728446565,
+    2938.1443365553578, 2948.0320459471691, 2957.9238891413152, 2967.8198543269009,
+    2977.7199297603283, 2987.6241037647269, 2997.5323647293808, 3007.4447011091761,
+    3017.3611014240378, 3027.2815542583885, 3037.2060482606039, 3047.1345721424755,
+    3057.0671146786826, 3067.0036647062684, 3076.9442111241206, 3086.8887428924577,
+    3096.8372490323254, 3106.7897186250934, 3116.7461408119598, 3126.7065047934593,
+    3136.6707998289803, 3146.639015236286, 3156.6111403910359, 3166.5871647263175,
+    3176.5670777321875, 3186.5508689552034, 3196.5385279979764, 3206.5300445187163,
+    3216.5254082307915, 3226.5246089022862, 3236.5276363555654, 3246.5344804668439,
+    3256.5451311657607, 3266.5595784349557, 3276.5778123096561, 3286.5998228772587,
+    3296.6256002769242, 3306.6551346991714, 3316.6884163854788, 3326.7254356278868,
+    3336.7661827686052, 3346.8106481996288, 3356.8588223623483, 3366.9106957471749,
+    3376.9662588931615, 3387.0255023876321, 3397.0884168658122, 3407.1549930104638,
+    3417.2252215515259, 3427.299093265754, 3437.3765989763724, 3447.4577295527156,
+    3457.5424759098901, 3467.630829008423, 3477.7227798539293, 3487.818319496771,
+    3497.9174390317253, 3508.0201295976549, 3518.1263823771815, 3528.2361885963628,
+    3538.3495395243699, 3548.4664264731755, 3558.5868407972325, 3568.7107738931718,
+    3578.8382171994858, 3588.9691621962311, 3599.103600404721, 3609.2415233872293,
+    3619.3829227466945, 3629.5277901264244, 3639.6761172098095, 3649.8278957200282,
+    3659.9831174197716, 3670.1417741109526, 3680.3038576344325, 3690.4693598697386,
+    3700.6382727347964, 3710.8105881856523, 3720.9862982162067, 3731.1653948579492,
+    3741.3478701796907, 3751.5337162873047, 3761.7229253234677, 3771.9154894674016,
+    3782.1114009346184, 3792.3106519766716, 3802.5132348809038, 3812.7191419701994,
+    3822.9283656027401, 3833.1408981717618, 3843.3567321053142, 3853.5758598660223,
+    3863.7982739508502, 3874.0239668908671, 3884.2529312510128, 3894.4851596298731,
+    3904.7206446594469, 3914.9593790049234, 3925.201355364456, 3935.4465664689433,
+    3945.6950050818064, 3955.9466639987745, 3966.2015360476667, 3976.4596140881763,
+    3986.7208910116651, 3996.9853597409442, 4007.2530132300749, 4017.5238444641564,
+    4027.797846459122, 4038.0750122615382, 4048.3553349484, 4058.6388076269377,
+    4068.925423434413, 4079.215175537925, 4089.5080571342187, 4099.8040614494894,
+    4110.103181739194, 4120.4054112878584, 4130.7107434088948, 4141.0191714444118,
+    4151.3306887650333, 4161.6452887697114, 4171.9629648855498, 4182.2837105676217,
+    4192.6075192987892, 4202.9343845895337, 4213.2642999777745, 4223.5972590286974,
+    4233.9332553345812, 4244.2722825146284, 4254.6143342147971, 4264.9594041076298,
+    4275.3074858920882, 4285.65857329339, 4296.012660062841, 4306.3697399776784,
+    4316.7298068409036, 4327.0928544811277, 4337.4588767524092, 4347.8278675341007,
+    4358.1998207306888, 4368.5747302716418, 4378.9525901112602, 4389.3333942285144,
+    4399.7171366269058, 4410.1038113343102, 4420.4934124028305, 4430.8859339086512,
+    4441.2813699518902, 4451.6797146564568, 4462.0809621699045, 4472.4851066632928,
+    4482.8921423310439, 4493.302063390799, 4503.7148640832875, 4514.1305386721797,
+    4524.5490814439572, 4534.9704867077744, 4545.394748795321, 4555.821862060694,
+    4566.2518208802603, 4576.6846196525294, 4587.1202527980176, 4597.5587147591241
+};
+
+double inform_xlogx_sum(uint32_t const *counts, size_t n)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        sum += inform_xlogx(counts[i]);
+    }
+    return sum;
+}
@@ -0,0 +1,35 @@
+// Copyright 2016-2019 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// the number of counts @f c @f whose @f c \log_2{c} @f is tabulated
+#define INFORM_XLOGX_TABLE_SIZE 512
+
+/// @f c \log_2{c} @f for each count @f 0 \leq c < @f INFORM_XLOGX_TABLE_SIZE
+extern double const inform_xlogx_table[INFORM_XLOGX_TABLE_SIZE];
+
+/**
+ * Compute @f c \log_2{c} @f for a count, taking @f 0 \log_2{0} = 0 @f.
+ */
+inline static double inform_xlogx(uint64_t c)
+{
+    return (c < INFORM_XLOGX_TABLE_SIZE) ? inform_xlogx_table[c] : c * log2((double) c);
+}
+
+/**
+ * Sum @f c \log_2{c} @f over the counts of a histogram.
+ *
+ * Every measure over a histogram of @f N @f observations can be written in
+ * terms of such sums, e.g. the entropy is @f \log_2{N} - S/N @f, and the
+ * mutual information between @f X @f and @f Y @f is
+ * @f (S_{XY} - S_X - S_Y)/N + \log_2{N} @f. This reduces a histogram with
+ * integer arithmetic and table lookups alone; only counts beyond the table,
+ * of which there are at most @f N / @f INFORM_XLOGX_TABLE_SIZE, require a
+ * logarithm.
+ */
+double inform_xlogx_sum(uint32_t const *counts, size_t n);
@@ -385,6 +385,58 @@ UNIT(LocalActiveInfoEnsemble_Base4)
     }
 }
 
+UNIT(ActiveInfoSparse)
+{
+    static int xs[5000], ys[5000];
+    coupled_series(xs, ys, 5000);
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(1.795459450283476,
+        inform_active_info(ys, 1, 5000, 4, 7, &err), 1e-10);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    ASSERT_DBL_NEAR_TOL(1.795551955622965,
+        inform_active_info(ys, 2, 2500, 4, 7, &err), 1e-10);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+}
+
+UNIT(LocalActiveInfoSparse)
+{
+    static int xs[5000], ys[5000];
+    static double ai[4993];
+    coupled_series(xs, ys, 5000);
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NOT_NULL(inform_local_active_info(ys, 1, 5000, 4, 7, ai, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_DBL_NEAR_TOL(1.795459450283476, AVERAGE(ai), 1e-10);
+}
+
+UNIT(ActiveInfoLongSeries)
+{
+    // The histograms are accumulated in parallel when built with OpenMP,
+    // which must not change the value, however many threads there are.
+    int *xs = malloc(2 * LONG_SERIES * sizeof(int));
+    ASSERT_NOT_NULL(xs);
+    int *ys = xs + LONG_SERIES;
+    coupled_series(xs, ys, LONG_SERIES);
+
+    int const threads = use_threads(1);
+    for (int const *t = test_threads; *t != 0; ++t)
+    {
+        use_threads(*t);
+        inform_error err = INFORM_SUCCESS;
+        ASSERT_DBL_NEAR_TOL(1.2020951298552518e-4,
+            inform_active_info(ys, 1, LONG_SERIES, 4, 3, &err), 1e-12);
+        ASSERT_DBL_NEAR_TOL(1.2020394249745436e-4,
+            inform_active_info(ys, 3, LONG_SERIES / 3, 4, 3, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+    }
+    use_threads(threads);
+
+    free(xs);
+}
+
 BEGIN_SUITE(ActiveInformation)
     ADD_UNIT(ActiveInfoSeriesNULLSeries)
     ADD_UNIT(ActiveInfoSeriesNoInits)
@@ -412,4 +464,7 @@ BEGIN_SUITE(ActiveInformation)
     ADD_UNIT(LocalActiveInfoSingleSeries_Base4)
     ADD_UNIT(LocalActiveInfoEnsemble)
     ADD_UNIT(LocalActiveInfoEnsemble_Base4)
+    ADD_UNIT(ActiveInfoSparse)
+    ADD_UNIT(LocalActiveInfoSparse)
+    ADD_UNIT(ActiveInfoLongSeries)
 END_SUITE
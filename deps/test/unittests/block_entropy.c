@@ -385,6 +385,91 @@ UNIT(LocalBlockEntropyEnsemble_Base4)
     }
 }
 
+UNIT(BlockEntropySparse)
+{
+    static int xs[5000], ys[5000];
+    coupled_series(xs, ys, 5000);
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(12.262414460948476,
+        inform_block_entropy(ys, 1, 5000, 4, 9, &err), 1e-10);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+}
+
+UNIT(LocalBlockEntropySparse)
+{
+    static int xs[5000], ys[5000];
+    static double be[4992];
+    coupled_series(xs, ys, 5000);
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NOT_NULL(inform_local_block_entropy(ys, 1, 5000, 4, 9, be, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_DBL_NEAR_TOL(12.262414460948476, AVERAGE(be), 1e-10);
+}
+
+UNIT(BlockEntropyLongHistory)
+{
+    // Each phase of a period-7 binary series is a distinct block.
+    int series[7039];
+    for (size_t i = 0; i < 7039; ++i) series[i] = (0x5A >> (i % 7)) & 1;
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(log2(7), inform_block_entropy(series, 1, 7039, 2, 40, &err), 1e-10);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    ASSERT_NAN(inform_block_entropy(series, 1, 7039, 2, 70, &err));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+}
+
+UNIT(BlockEntropyLongSeries)
+{
+    // The histograms are accumulated in parallel when built with OpenMP,
+    // which must not change the value, however many threads there are.
+    int *xs = malloc(2 * LONG_SERIES * sizeof(int));
+    ASSERT_NOT_NULL(xs);
+    int *ys = xs + LONG_SERIES;
+    coupled_series(xs, ys, LONG_SERIES);
+
+    int const threads = use_threads(1);
+    for (int const *t = test_threads; *t != 0; ++t)
+    {
+        use_threads(*t);
+        inform_error err = INFORM_SUCCESS;
+        ASSERT_DBL_NEAR_TOL(5.9999623917236793,
+            inform_block_entropy(ys, 1, LONG_SERIES, 4, 3, &err), 1e-12);
+        ASSERT_DBL_NEAR_TOL(5.9999623523195087,
+            inform_block_entropy(ys, 3, LONG_SERIES / 3, 4, 3, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+    }
+    use_threads(threads);
+
+    free(xs);
+}
+
+UNIT(BlockEntropyCounterWidth)
+{
+    // A single zero followed by ones, so that one count is N - 1 for
+    // series either side of the largest 16-bit count.
+    size_t const lengths[3] = { 65535, 65536, 65537 };
+    int *xs = malloc(lengths[2] * sizeof(int));
+    ASSERT_NOT_NULL(xs);
+    xs[0] = 0;
+    for (size_t i = 1; i < lengths[2]; ++i) xs[i] = 1;
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        double const N = lengths[i];
+        double const expected = log2(N) - (N - 1) * log2(N - 1) / N;
+
+        inform_error err = INFORM_SUCCESS;
+        ASSERT_DBL_NEAR_TOL(expected, inform_block_entropy(xs, 1, lengths[i], 2, 1, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+    }
+
+    free(xs);
+}
+
 BEGIN_SUITE(BlockEntropy)
     ADD_UNIT(BlockEntropyNULLSeries)
     ADD_UNIT(BlockEntropyNoInits)
@@ -411,4 +496,9 @@ BEGIN_SUITE(BlockEntropy)
     ADD_UNIT(LocalBlockEntropySingleSeries_Base4)
     ADD_UNIT(LocalBlockEntropyEnsemble)
     ADD_UNIT(LocalBlockEntropyEnsemble_Base4)
+    ADD_UNIT(BlockEntropySparse)
+    ADD_UNIT(LocalBlockEntropySparse)
+    ADD_UNIT(BlockEntropyLongHistory)
+    ADD_UNIT(BlockEntropyLongSeries)
+    ADD_UNIT(BlockEntropyCounterWidth)
 END_SUITE
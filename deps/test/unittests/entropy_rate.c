@@ -388,6 +388,72 @@ UNIT(LocalEntropyRateEnsemble_Base4)
     }
 }
 
+UNIT(EntropyRateSparse)
+{
+    static int xs[5000], ys[5000];
+    coupled_series(xs, ys, 5000);
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(0.204038438837793,
+        inform_entropy_rate(ys, 1, 5000, 4, 7, &err), 1e-10);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    ASSERT_DBL_NEAR_TOL(0.203923771583664,
+        inform_entropy_rate(ys, 2, 2500, 4, 7, &err), 1e-10);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+}
+
+UNIT(LocalEntropyRateSparse)
+{
+    static int xs[5000], ys[5000];
+    static double er[4993];
+    coupled_series(xs, ys, 5000);
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NOT_NULL(inform_local_entropy_rate(ys, 1, 5000, 4, 7, er, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_DBL_NEAR_TOL(0.204038438837793, AVERAGE(er), 1e-10);
+}
+
+UNIT(EntropyRateLongHistory)
+{
+    // A period-7 binary series is determined by any 20 step history.
+    int series[1000];
+    for (size_t i = 0; i < 1000; ++i) series[i] = (0x5A >> (i % 7)) & 1;
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(0.0, inform_entropy_rate(series, 1, 1000, 2, 20, &err), 1e-10);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    ASSERT_DBL_NEAR_TOL(0.0, inform_entropy_rate(series, 1, 1000, 2, 40, &err), 1e-10);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+}
+
+UNIT(EntropyRateLongSeries)
+{
+    // The histograms are accumulated in parallel when built with OpenMP,
+    // which must not change the value, however many threads there are.
+    int *xs = malloc(2 * LONG_SERIES * sizeof(int));
+    ASSERT_NOT_NULL(xs);
+    int *ys = xs + LONG_SERIES;
+    coupled_series(xs, ys, LONG_SERIES);
+
+    int const threads = use_threads(1);
+    for (int const *t = test_threads; *t != 0; ++t)
+    {
+        use_threads(*t);
+        inform_error err = INFORM_SUCCESS;
+        ASSERT_DBL_NEAR_TOL(1.9998794787402117,
+            inform_entropy_rate(ys, 1, LONG_SERIES, 4, 3, &err), 1e-12);
+        ASSERT_DBL_NEAR_TOL(1.9998794865160188,
+            inform_entropy_rate(ys, 3, LONG_SERIES / 3, 4, 3, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+    }
+    use_threads(threads);
+
+    free(xs);
+}
+
 BEGIN_SUITE(EntropyRate)
     ADD_UNIT(EntropyRateNULLSeries)
     ADD_UNIT(EntropyRateNoInits)
@@ -414,4 +480,8 @@ BEGIN_SUITE(EntropyRate)
     ADD_UNIT(LocalEntropyRateSingleSeries_Base4)
     ADD_UNIT(LocalEntropyRateEnsemble)
     ADD_UNIT(LocalEntropyRateEnsemble_Base4)
+    ADD_UNIT(EntropyRateSparse)
+    ADD_UNIT(LocalEntropyRateSparse)
+    ADD_UNIT(EntropyRateLongHistory)
+    ADD_UNIT(EntropyRateLongSeries)
 END_SUITE
@@ -2,7 +2,9 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include <inform/integration.h>
+#include <inform/utilities/partitions.h>
 #include <inform/utilities/random.h>
+#include <math.h>
 #include <ginger/unit.h>
 
 UNIT(IntegrationEvidenceNULLSeries)
@@ -304,6 +306,64 @@ UNIT(IntegrationEvidenceSynchronized)
     free(evidence);
 }
 
+UNIT(IntegrationEvidenceAgreesWithParts)
+{
+    // Enough series and time steps to be spread across threads when built
+    // with OpenMP.
+    srand(2019);
+    size_t const l = 8;
+    size_t const n = 1024;
+    int const bases[] = {2,3,2,2,3,2,2,2};
+    int *series = malloc(l * n * sizeof(int));
+    ASSERT_NOT_NULL(series);
+    for (size_t i = 0; i < l; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            // each series copies the one before it three times in four
+            series[j + n*i] = (i != 0 && rand() % 4 != 0) ?
+                series[j + n*(i-1)] % bases[i] : rand() % bases[i];
+        }
+    }
+
+    double *expected = malloc(3 * n * sizeof(double));
+    ASSERT_NOT_NULL(expected);
+    double *lmi = expected + 2 * n;
+    for (size_t j = 0; j < n; ++j)
+    {
+        expected[j] = INFINITY;
+        expected[j + n] = -INFINITY;
+    }
+    size_t *parts = inform_first_partitioning(l);
+    size_t nparts;
+    while ((nparts = inform_next_partitioning(parts, l)))
+    {
+        inform_error err = INFORM_SUCCESS;
+        ASSERT_NOT_NULL(inform_integration_evidence_part(series, l, n, bases,
+            parts, nparts, lmi, &err));
+        for (size_t j = 0; j < n; ++j)
+        {
+            expected[j] = fmin(expected[j], lmi[j]);
+            expected[j + n] = fmax(expected[j + n], lmi[j]);
+        }
+    }
+    free(parts);
+
+    inform_error err = INFORM_SUCCESS;
+    double *evidence = inform_integration_evidence(series, l, n, bases, NULL,
+        &err);
+    ASSERT_NOT_NULL(evidence);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t j = 0; j < 2 * n; ++j)
+    {
+        ASSERT_DBL_NEAR_TOL(expected[j], evidence[j], 1e-10);
+    }
+
+    free(evidence);
+    free(expected);
+    free(series);
+}
+
 UNIT(IntegrationEvidencePartNULLSeries)
 {
     inform_error err = INFORM_SUCCESS;
@@ -765,6 +825,7 @@ BEGIN_SUITE(Integration)
     ADD_UNIT(IntegrationEvidenceTwoSeries)
     ADD_UNIT(IntegrationEvidenceThreeSeries)
     ADD_UNIT(IntegrationEvidenceSynchronized)
+    ADD_UNIT(IntegrationEvidenceAgreesWithParts)
 
     ADD_UNIT(IntegrationEvidencePartNULLSeries)
     ADD_UNIT(IntegrationEvidencePartTooFewSeries)
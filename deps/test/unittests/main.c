@@ -19,6 +19,7 @@ IMPORT_SUITE(PID);
 IMPORT_SUITE(PredictiveInformation);
 IMPORT_SUITE(RelativeEntropy);
 IMPORT_SUITE(SeparableInformation);
+IMPORT_SUITE(SeriesProfile);
 IMPORT_SUITE(ShannonMulti);
 IMPORT_SUITE(ShannonUni);
 IMPORT_SUITE(TransferEntropy);
@@ -41,6 +42,7 @@ BEGIN_REGISTRATION
     REGISTER(PredictiveInformation)
     REGISTER(RelativeEntropy)
     REGISTER(SeparableInformation)
+    REGISTER(SeriesProfile)
     REGISTER(ShannonMulti)
     REGISTER(ShannonUni)
     REGISTER(TransferEntropy)
@@ -3,7 +3,9 @@
 // license that can be found in the LICENSE file.
 #include <ginger/unit.h>
 #include <ginger/vector.h>
+#include <inform/mutual_info.h>
 #include <inform/pid.h>
+#include <inform/utilities/black_boxing.h>
 #include <inform/utilities/random.h>
 
 #define COMPARE_SOURCES(EXP, SRCS) \
@@ -435,6 +437,167 @@ UNIT(PIDRandom)
     free(data);
 }
 
+UNIT(PIDAgreesWithMutualInfo)
+{
+    size_t const l = 4, n = 200000;
+    int const bs = 3, br[4] = {2, 3, 2, 2};
+
+    int *data = malloc((l + 1) * n * sizeof(int));
+    ASSERT_NOT_NULL(data);
+    for (size_t j = 0; j < l; ++j)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            data[(j + 1)*n + i] = inform_random_int(0, br[j]);
+        }
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        int const s = (data[n + i] + data[2*n + i] * data[3*n + i]) % bs;
+        data[i] = (inform_random_int(0, 4) == 0) ? inform_random_int(0, bs) : s;
+    }
+
+    inform_error err = INFORM_SUCCESS;
+    inform_pid_lattice *lattice = inform_pid(data, data + n, l, n, bs, br, &err);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_NOT_NULL(lattice);
+
+    // the minimum information of a single collection of responses is the
+    // mutual information between their joint state and the stimulus
+    int *series = malloc((l + 2) * n * sizeof(int));
+    ASSERT_NOT_NULL(series);
+    memcpy(series, data, n * sizeof(int));
+    for (size_t i = 0; i < lattice->size; ++i)
+    {
+        inform_pid_source const *src = lattice->sources[i];
+        if (src->size != 1)
+        {
+            continue;
+        }
+        size_t u = 0;
+        int bases[2] = {bs, 1}, box_bases[4];
+        for (size_t j = 0; j < l; ++j)
+        {
+            if (src->name[0] & ((size_t) 1 << j))
+            {
+                memcpy(series + (2 + u)*n, data + (j + 1)*n, n * sizeof(int));
+                box_bases[u++] = br[j];
+                bases[1] *= br[j];
+            }
+        }
+        inform_black_box(series + 2*n, u, 1, n, box_bases, NULL, NULL,
+            series + n, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        double const mi = inform_mutual_info(series, 2, n, bases, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_DBL_NEAR_TOL(mi, src->imin, 1e-10);
+    }
+
+    double total = 0.0;
+    for (size_t i = 0; i < lattice->size; ++i)
+    {
+        total += lattice->sources[i]->pi;
+    }
+    ASSERT_DBL_NEAR_TOL(lattice->top->imin, total, 1e-10);
+
+    inform_pid_lattice_free(lattice);
+    free(series);
+    free(data);
+}
+
+UNIT(PIDLatticeAlloc)
+{
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid_lattice_alloc(0, &err));
+    ASSERT_EQUAL(INFORM_ENOSOURCES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid_lattice_alloc(7, &err));
+    ASSERT_EQUAL(INFORM_ENOMEM, err);
+
+    size_t const sizes[5] = {1, 4, 18, 166, 7579};
+    int data[5*6];
+    for (size_t i = 0; i < 5*6; ++i) data[i] = (i * 7 + i / 3) % 2;
+    for (size_t l = 1; l <= 5; ++l)
+    {
+        err = INFORM_SUCCESS;
+        inform_pid_lattice *a = inform_pid_lattice_alloc(l, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_NOT_NULL(a);
+        ASSERT_EQUAL_U(sizes[l-1], a->size);
+        ASSERT_EQUAL_U(a->size, gvector_len(a->sources));
+        ASSERT_TRUE(a->bottom == a->sources[0]);
+        ASSERT_TRUE(a->top == a->sources[a->size - 1]);
+
+        inform_pid_lattice *b = inform_pid(data, data + 5, l, 5, 2,
+            (int[]){2,2,2,2,2}, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_NOT_NULL(b);
+        ASSERT_EQUAL_U(a->size, b->size);
+        for (size_t i = 0; i < a->size; ++i)
+        {
+            inform_pid_source const *x = a->sources[i], *y = b->sources[i];
+            ASSERT_EQUAL_U(x->size, gvector_len(x->name));
+            ASSERT_EQUAL_U(y->size, x->size);
+            ASSERT_EQUAL_U(0, memcmp(x->name, y->name,
+                x->size * sizeof(size_t)));
+            ASSERT_EQUAL_U(x->n_above, gvector_len(x->above));
+            ASSERT_EQUAL_U(x->n_below, gvector_len(x->below));
+            ASSERT_EQUAL_U(y->n_above, x->n_above);
+            ASSERT_EQUAL_U(y->n_below, x->n_below);
+            for (size_t k = 0; k < x->n_above; ++k)
+            {
+                ASSERT_EQUAL_U(y->above[k] - b->sources[0],
+                    x->above[k] - a->sources[0]);
+            }
+            for (size_t k = 0; k < x->n_below; ++k)
+            {
+                ASSERT_EQUAL_U(y->below[k] - b->sources[0],
+                    x->below[k] - a->sources[0]);
+            }
+            ASSERT_DBL_NEAR(0.0, x->imin);
+            ASSERT_DBL_NEAR(0.0, x->pi);
+        }
+
+        inform_pid_lattice_free(b);
+        inform_pid_lattice_free(a);
+    }
+}
+
+UNIT(PIDIntoReusesLattice)
+{
+    int const xor[12] = {0,1,1,0, 0,0,1,1, 0,1,0,1};
+    int const and[12] = {0,0,0,1, 0,0,1,1, 0,1,0,1};
+
+    inform_error err = INFORM_SUCCESS;
+    inform_pid_lattice *lattice = inform_pid_lattice_alloc(2, &err);
+    ASSERT_NOT_NULL(lattice);
+
+    int const *data[4] = {xor, and, xor, and};
+    for (size_t j = 0; j < 4; ++j)
+    {
+        inform_pid_lattice *fresh = inform_pid(data[j], data[j] + 4, 2, 4, 2,
+            (int[]){2,2}, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_TRUE(lattice == inform_pid_into(data[j], data[j] + 4, 2, 4, 2,
+            (int[]){2,2}, lattice, &err));
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        for (size_t i = 0; i < lattice->size; ++i)
+        {
+            ASSERT_DBL_NEAR(fresh->sources[i]->imin, lattice->sources[i]->imin);
+            ASSERT_DBL_NEAR(fresh->sources[i]->pi, lattice->sources[i]->pi);
+        }
+        inform_pid_lattice_free(fresh);
+    }
+
+    int const data3[16] = {0,1,1,0, 0,0,1,1, 0,1,0,1, 1,1,0,0};
+    ASSERT_NULL(inform_pid_into(data3, data3 + 4, 3, 4, 2, (int[]){2,2,2},
+        lattice, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    inform_pid_lattice_free(lattice);
+}
+
 // UNIT(PIDMemory)
 // {
 //     size_t const m = 7, n = 10000;
@@ -470,5 +633,8 @@ BEGIN_SUITE(PID)
     ADD_UNIT(PIDWilliamsBeer4b)
     ADD_UNIT(PID4Variables)
     ADD_UNIT(PIDRandom)
+    ADD_UNIT(PIDAgreesWithMutualInfo)
+    ADD_UNIT(PIDLatticeAlloc)
+    ADD_UNIT(PIDIntoReusesLattice)
     // ADD_UNIT(PIDMemory)
 END_SUITE
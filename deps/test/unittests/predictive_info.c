@@ -920,6 +920,54 @@ UNIT(LocalPredictiveInfoEnsemble23_Base4)
     }
 }
 
+UNIT(PredictiveInfoSparse)
+{
+    static int xs[5000], ys[5000];
+    coupled_series(xs, ys, 5000);
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(5.544517769617310,
+        inform_predictive_info(ys, 1, 5000, 4, 5, 4, &err), 1e-10);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+}
+
+UNIT(LocalPredictiveInfoSparse)
+{
+    static int xs[5000], ys[5000];
+    static double pi[4992];
+    coupled_series(xs, ys, 5000);
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NOT_NULL(inform_local_predictive_info(ys, 1, 5000, 4, 5, 4, pi, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_DBL_NEAR_TOL(5.544517769617310, AVERAGE(pi), 1e-10);
+}
+
+UNIT(PredictiveInfoLongSeries)
+{
+    // The histograms are accumulated in parallel when built with OpenMP,
+    // which must not change the value, however many threads there are.
+    int *xs = malloc(2 * LONG_SERIES * sizeof(int));
+    ASSERT_NOT_NULL(xs);
+    int *ys = xs + LONG_SERIES;
+    coupled_series(xs, ys, LONG_SERIES);
+
+    int const threads = use_threads(1);
+    for (int const *t = test_threads; *t != 0; ++t)
+    {
+        use_threads(*t);
+        inform_error err = INFORM_SUCCESS;
+        ASSERT_DBL_NEAR_TOL(6.3282298231470691e-4,
+            inform_predictive_info(ys, 1, LONG_SERIES, 4, 2, 3, &err), 1e-12);
+        ASSERT_DBL_NEAR_TOL(6.3271018347776931e-4,
+            inform_predictive_info(ys, 3, LONG_SERIES / 3, 4, 2, 3, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+    }
+    use_threads(threads);
+
+    free(xs);
+}
+
 BEGIN_SUITE(PredictiveInformation)
     ADD_UNIT(PredictiveInfoSeriesNULLSeries)
     ADD_UNIT(PredictiveInfoSeriesNoInits)
@@ -968,4 +1016,7 @@ BEGIN_SUITE(PredictiveInformation)
     ADD_UNIT(LocalPredictiveInfoEnsemble23)
     ADD_UNIT(LocalPredictiveInfoEnsemble21_Base4)
     ADD_UNIT(LocalPredictiveInfoEnsemble23_Base4)
+    ADD_UNIT(PredictiveInfoSparse)
+    ADD_UNIT(LocalPredictiveInfoSparse)
+    ADD_UNIT(PredictiveInfoLongSeries)
 END_SUITE
@@ -2,7 +2,9 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include "util.h"
+#include <inform/active_info.h>
 #include <inform/separable_info.h>
+#include <inform/transfer_entropy.h>
 #include <math.h>
 #include <ginger/unit.h>
 
@@ -720,6 +722,53 @@ UNIT(LocalSeparableInformationMultipleEnsembles)
     }
 }
 
+UNIT(SeparableInformationManySources)
+{
+    // Enough sources to be spread across threads when built with OpenMP.
+    size_t const l = 32, m = 5000;
+    int *xs = malloc((l + 1) * m * sizeof(int));
+    double *local = malloc(m * sizeof(double));
+    ASSERT_NOT_NULL(xs);
+    ASSERT_NOT_NULL(local);
+    int *dest = xs + l * m;
+    coupled_series(xs, dest, m);
+    for (size_t i = 1; i < l; ++i)
+    {
+        for (size_t j = 0; j < m; ++j)
+        {
+            xs[i * m + j] = (xs[j] + dest[(j + i) % m] * (int) i) % 4;
+        }
+    }
+
+    // k = 7 uses sparse histograms, which are not shared between sources
+    for (size_t k = 2; k <= 7; k += 5)
+    {
+        for (size_t n = 1; n <= 2; ++n)
+        {
+            inform_error err = INFORM_SUCCESS;
+            double expect = inform_active_info(dest, n, m / n, 4, k, &err);
+            for (size_t i = 0; i < l; ++i)
+            {
+                expect += inform_transfer_entropy(xs + i * m, dest, NULL, 0, n,
+                    m / n, 4, k, &err);
+            }
+            ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+            ASSERT_DBL_NEAR_TOL(expect,
+                inform_separable_info(xs, dest, l, n, m / n, 4, k, &err), 1e-9);
+            ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+            ASSERT_NOT_NULL(inform_local_separable_info(xs, dest, l, n, m / n,
+                4, k, local, &err));
+            ASSERT_EQUAL(INFORM_SUCCESS, err);
+            ASSERT_DBL_NEAR_TOL(expect, average(local, n * (m / n - k)), 1e-9);
+        }
+    }
+
+    free(local);
+    free(xs);
+}
+
 BEGIN_SUITE(SeparableInformation)
     ADD_UNIT(SeparableInformationNULLSeries)
     ADD_UNIT(SeparableInformationNoSources)
@@ -749,4 +798,5 @@ BEGIN_SUITE(SeparableInformation)
     ADD_UNIT(LocalSeparableInformationMultipleSources)
     ADD_UNIT(LocalSeparableInformationSingleEnsemble)
     ADD_UNIT(LocalSeparableInformationMultipleEnsembles)
+    ADD_UNIT(SeparableInformationManySources)
 END_SUITE
@@ -0,0 +1,111 @@
+// Copyright 2016-2019 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "util.h"
+#include <inform/active_info.h>
+#include <inform/block_entropy.h>
+#include <inform/entropy_rate.h>
+#include <inform/predictive_info.h>
+#include <inform/series_profile.h>
+#include <math.h>
+#include <ginger/unit.h>
+
+#define ASSERT_PROFILE_NAN(PROFILE) \
+    ASSERT_NAN((PROFILE).active_info); \
+    ASSERT_NAN((PROFILE).entropy_rate); \
+    ASSERT_NAN((PROFILE).block_entropy); \
+    ASSERT_NAN((PROFILE).predictive_info)
+
+#define ASSERT_PROFILE_MATCHES(SERIES, N, M, B, K) do { \
+        inform_error err = INFORM_SUCCESS; \
+        inform_series_profile p = inform_profile_series(SERIES, N, M, B, K, &err); \
+        ASSERT_EQUAL(INFORM_SUCCESS, err); \
+        ASSERT_DBL_NEAR_TOL(inform_active_info(SERIES, N, M, B, K, NULL), \
+            p.active_info, 1e-10); \
+        ASSERT_DBL_NEAR_TOL(inform_entropy_rate(SERIES, N, M, B, K, NULL), \
+            p.entropy_rate, 1e-10); \
+        ASSERT_DBL_NEAR_TOL(inform_block_entropy(SERIES, N, M, B, K, NULL), \
+            p.block_entropy, 1e-10); \
+        if ((M) > 2 * (K)) \
+        { \
+            ASSERT_DBL_NEAR_TOL(inform_predictive_info(SERIES, N, M, B, K, K, NULL), \
+                p.predictive_info, 1e-10); \
+        } \
+        else \
+        { \
+            ASSERT_NAN(p.predictive_info); \
+        } \
+    } while (0)
+
+UNIT(SeriesProfileNULLSeries)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_series_profile p = inform_profile_series(NULL, 1, 3, 2, 2, &err);
+    ASSERT_PROFILE_NAN(p);
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+}
+
+UNIT(SeriesProfileZeroHistory)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_series_profile p = inform_profile_series((int[]){0,1,0}, 1, 3, 2, 0, &err);
+    ASSERT_PROFILE_NAN(p);
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+}
+
+UNIT(SeriesProfileHistoryTooLong)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_series_profile p = inform_profile_series((int[]){0,1,0}, 1, 3, 2, 3, &err);
+    ASSERT_PROFILE_NAN(p);
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+}
+
+UNIT(SeriesProfileBadState)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_series_profile p = inform_profile_series((int[]){0,2,0}, 1, 3, 2, 1, &err);
+    ASSERT_PROFILE_NAN(p);
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+}
+
+UNIT(SeriesProfileSingleSeries_Base2)
+{
+    int series[9] = {1,1,0,0,1,0,0,1,0};
+    ASSERT_PROFILE_MATCHES(series, 1, 9, 2, 1);
+    ASSERT_PROFILE_MATCHES(series, 1, 9, 2, 2);
+    ASSERT_PROFILE_MATCHES(series, 1, 9, 2, 4);
+    ASSERT_PROFILE_MATCHES(series, 1, 9, 2, 6);
+}
+
+UNIT(SeriesProfileEnsemble_Base4)
+{
+    int series[36] = {
+        3, 3, 3, 2, 1, 0, 0, 0, 1,
+        2, 2, 3, 3, 3, 3, 2, 1, 0,
+        0, 0, 0, 0, 1, 1, 0, 0, 0,
+        1, 1, 0, 0, 0, 1, 1, 2, 2,
+    };
+    ASSERT_PROFILE_MATCHES(series, 4, 9, 4, 1);
+    ASSERT_PROFILE_MATCHES(series, 4, 9, 4, 2);
+    ASSERT_PROFILE_MATCHES(series, 4, 9, 4, 5);
+}
+
+UNIT(SeriesProfileSparse)
+{
+    static int xs[5000], ys[5000];
+    coupled_series(xs, ys, 5000);
+    ASSERT_PROFILE_MATCHES(ys, 1, 5000, 4, 3);
+    ASSERT_PROFILE_MATCHES(ys, 1, 5000, 4, 7);
+    ASSERT_PROFILE_MATCHES(ys, 2, 2500, 4, 7);
+}
+
+BEGIN_SUITE(SeriesProfile)
+    ADD_UNIT(SeriesProfileNULLSeries)
+    ADD_UNIT(SeriesProfileZeroHistory)
+    ADD_UNIT(SeriesProfileHistoryTooLong)
+    ADD_UNIT(SeriesProfileBadState)
+    ADD_UNIT(SeriesProfileSingleSeries_Base2)
+    ADD_UNIT(SeriesProfileEnsemble_Base4)
+    ADD_UNIT(SeriesProfileSparse)
+END_SUITE
@@ -89,6 +89,26 @@ UNIT(ShannonUniNonUniform)
     inform_dist_free(dist);
 }
 
+UNIT(ShannonUniLargeCounts)
+{
+    inform_dist *dist = inform_dist_alloc(7);
+    inform_dist_fill(dist, 511, 512, 513, 100000, 0, 1, 7);
+
+    double expected = 0.0;
+    for (size_t i = 0; i < dist->size; ++i)
+    {
+        double const p = inform_dist_prob(dist, i);
+        if (p > 0.0)
+        {
+            expected -= p * log2(p);
+        }
+    }
+    ASSERT_DBL_NEAR_TOL(expected, inform_shannon_entropy(dist, 2), 1e-12);
+    ASSERT_DBL_NEAR_TOL(expected / log2(3.0), inform_shannon_entropy(dist, 3), 1e-12);
+
+    inform_dist_free(dist);
+}
+
 UNIT(ShannonUniMutualInformationIndependent)
 {
 
@@ -504,6 +524,7 @@ BEGIN_SUITE(ShannonUni)
     ADD_UNIT(ShannonUniDeltaFunction)
     ADD_UNIT(ShannonUniUniform)
     ADD_UNIT(ShannonUniNonUniform)
+    ADD_UNIT(ShannonUniLargeCounts)
 
     ADD_UNIT(ShannonUniMutualInformationIndependent)
     ADD_UNIT(ShannonUniMutualInformationDependent)
@@ -668,6 +668,64 @@ UNIT(LocalTransferEntropyEnsemble_Base2)
     }
 }
 
+UNIT(TransferEntropySparse)
+{
+    static int xs[5000], ys[5000], ws[5000];
+    coupled_series(xs, ys, 5000);
+    // a background which carries half of the source
+    for (size_t i = 0; i < 5000; ++i)
+    {
+        ws[i] = xs[i] / 2;
+    }
+
+    // the expected values are those of the dense histograms
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(0.579643034348670,
+        inform_transfer_entropy(xs, ys, NULL, 0, 1, 5000, 4, 6, &err), 1e-10);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    ASSERT_DBL_NEAR_TOL(0.514368987065824,
+        inform_transfer_entropy(xs, ys, ws, 1, 1, 5000, 4, 5, &err), 1e-10);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+}
+
+UNIT(LocalTransferEntropySparse)
+{
+    static int xs[5000], ys[5000];
+    static double te[4994];
+    coupled_series(xs, ys, 5000);
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NOT_NULL(inform_local_transfer_entropy(xs, ys, NULL, 0, 1, 5000, 4, 6, te, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_DBL_NEAR_TOL(0.579643034348670, AVERAGE(te), 1e-10);
+}
+
+UNIT(TransferEntropyLongSeries)
+{
+    // The histograms are accumulated in parallel when built with OpenMP,
+    // which must not change the value, however many threads there are.
+    int *xs = malloc(2 * LONG_SERIES * sizeof(int));
+    ASSERT_NOT_NULL(xs);
+    int *ys = xs + LONG_SERIES;
+    coupled_series(xs, ys, LONG_SERIES);
+
+    int const threads = use_threads(1);
+    for (int const *t = test_threads; *t != 0; ++t)
+    {
+        use_threads(*t);
+        inform_error err = INFORM_SUCCESS;
+        ASSERT_DBL_NEAR_TOL(0.79227228136124372,
+            inform_transfer_entropy(xs, ys, NULL, 0, 1, LONG_SERIES, 4, 3, &err), 1e-12);
+        ASSERT_DBL_NEAR_TOL(0.79227625537084867,
+            inform_transfer_entropy(xs, ys, NULL, 0, 3, LONG_SERIES / 3, 4, 3, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+    }
+    use_threads(threads);
+
+    free(xs);
+}
+
 BEGIN_SUITE(TransferEntropy)
     ADD_UNIT(TransferEntropyNULLSeries)
     ADD_UNIT(TransferEntropyNoInits)
@@ -695,4 +753,7 @@ BEGIN_SUITE(TransferEntropy)
     ADD_UNIT(LocalTransferEntropySingleSeries_Base2)
     ADD_UNIT(LocalTransferEntropyEnsemble_Base2)
     ADD_UNIT(LocalCompleteTransferEntropy)
+    ADD_UNIT(TransferEntropySparse)
+    ADD_UNIT(LocalTransferEntropySparse)
+    ADD_UNIT(TransferEntropyLongSeries)
 END_SUITE
@@ -3,6 +3,10 @@
 // license that can be found in the LICENSE file.
 #include "util.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 double average(double const *xs, size_t n)
 {
     double x = 0;
@@ -12,3 +16,29 @@ double average(double const *xs, size_t n)
     }
     return x / n;
 }
+
+void coupled_series(int *xs, int *ys, size_t m)
+{
+    uint32_t state = 2019;
+    for (size_t i = 0; i < m; ++i)
+    {
+        state = 1103515245u * state + 12345u;
+        xs[i] = (state >> 16) % 4;
+        state = 1103515245u * state + 12345u;
+        ys[i] = (i == 0 || (state >> 16) % 3 == 0) ? (int)((state >> 20) % 4) : xs[i - 1];
+    }
+}
+
+int const test_threads[] = {1, 2, 3, 4, 0};
+
+int use_threads(int n)
+{
+#ifdef _OPENMP
+    int const previous = omp_get_max_threads();
+    omp_set_num_threads(n);
+    return previous;
+#else
+    (void) n;
+    return 1;
+#endif
+}
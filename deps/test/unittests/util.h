@@ -10,6 +10,26 @@
 #define AVERAGE(XS) average(XS, sizeof(XS) / sizeof(double))
 double average(double const *xs, size_t n);
 
+/**
+ * Fill `xs` with pseudorandom base-4 states and `ys` with a noisy copy of
+ * `xs` lagged by one step. The same series are generated on every call.
+ */
+void coupled_series(int *xs, int *ys, size_t m);
+
+/// the length of the series in the long series tests, which is enough for
+/// the kernels to split them across threads when built with OpenMP
+#define LONG_SERIES (1 << 20)
+
+/// the numbers of threads with which the long series tests run each kernel,
+/// terminated by zero
+extern int const test_threads[];
+
+/**
+ * Use `n` threads in subsequent OpenMP parallel regions, and return the
+ * number used before. Without OpenMP this does nothing and returns one.
+ */
+int use_threads(int n);
+
 #define inform_dist_fill_array(dist, array) \
     ASSERT_NOT_NULL(dist); \
     ASSERT_EQUAL(sizeof(array)/sizeof(int), inform_dist_size(dist)); \
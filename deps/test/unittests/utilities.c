@@ -2,6 +2,8 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include <float.h>
+#include <limits.h>
+#include <math.h>
 #include <inform/dist.h>
 #include <inform/utilities.h>
 #include <ginger/unit.h>
@@ -304,6 +306,231 @@ UNIT(BinBoundsAll)
     }
 }
 
+UNIT(BinBoundsUnsorted)
+{
+    inform_error err = INFORM_SUCCESS;
+    int binned[6];
+    int expect[6] = {0,0,2,2,3,3};
+    ASSERT_EQUAL(4, inform_bin_bounds((double[]){1,2,5,6,8,9}, 6,
+                (double[]){5, 2.5, 7.5}, 3, binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 6; ++i)
+    {
+        ASSERT_EQUAL(expect[i], binned[i]);
+    }
+}
+
+UNIT(BinBoundsRepeated)
+{
+    inform_error err = INFORM_SUCCESS;
+    int binned[6];
+    int expect[6] = {0,0,2,2,3,3};
+    ASSERT_EQUAL(4, inform_bin_bounds((double[]){1,2,3,4,5,6}, 6,
+                (double[]){2.5, 2.5, 5}, 3, binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 6; ++i)
+    {
+        ASSERT_EQUAL(expect[i], binned[i]);
+    }
+}
+
+UNIT(BinBoundsLong)
+{
+    size_t const n = 100003;
+    double *series = malloc(n * sizeof(double));
+    int *binned = malloc(n * sizeof(int));
+    ASSERT_NOT_NULL(series);
+    ASSERT_NOT_NULL(binned);
+    for (size_t i = 0; i < n; ++i)
+    {
+        series[i] = 0.5 * (i % 97);
+    }
+    double bounds[96];
+    for (size_t i = 0; i < 96; ++i)
+    {
+        bounds[i] = 0.5 * i + 0.25;
+    }
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_EQUAL(97, inform_bin_bounds(series, n, bounds, 96, binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < n; ++i)
+    {
+        ASSERT_EQUAL((int) (i % 97), binned[i]);
+    }
+    free(binned);
+    free(series);
+}
+
+UNIT(BinQuantilesInvalidArguments)
+{
+    inform_error err = INFORM_SUCCESS;
+    int binned[3];
+    ASSERT_EQUAL(0, inform_bin_quantiles(NULL, 3, 2, binned, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL(0, inform_bin_quantiles((double[]){1,2,3}, 0, 2, binned,
+                &err));
+    ASSERT_EQUAL(INFORM_ESHORTSERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL(0, inform_bin_quantiles((double[]){1,2,3}, 3, 1, binned,
+                &err));
+    ASSERT_EQUAL(INFORM_EBIN, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL(0, inform_bin_quantiles((double[]){1,2,3}, 3, 2, NULL,
+                &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+}
+
+UNIT(BinQuantilesEqual)
+{
+    inform_error err = INFORM_SUCCESS;
+    int binned[12];
+    int expect[12] = {1,0,3,2,1,0,3,2,1,0,3,2};
+    ASSERT_EQUAL(4, inform_bin_quantiles(
+                (double[]){6,1,12,9,5,2,11,8,4,3,10,7}, 12, 4, binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 12; ++i)
+    {
+        ASSERT_EQUAL(expect[i], binned[i]);
+    }
+}
+
+UNIT(BinQuantilesTied)
+{
+    inform_error err = INFORM_SUCCESS;
+    int binned[6];
+    int expect[6] = {0,0,0,0,1,1};
+    ASSERT_EQUAL(2, inform_bin_quantiles((double[]){1,1,1,1,2,3}, 6, 3,
+                binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 6; ++i)
+    {
+        ASSERT_EQUAL(expect[i], binned[i]);
+    }
+
+    ASSERT_EQUAL(1, inform_bin_quantiles((double[]){2,2,2,2,2,2}, 6, 3,
+                binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 6; ++i)
+    {
+        ASSERT_EQUAL(0, binned[i]);
+    }
+}
+
+UNIT(BinQuantilesLong)
+{
+    size_t const n = 1 << 20;
+    double *series = malloc(n * sizeof(double));
+    int *binned = malloc(n * sizeof(int));
+    ASSERT_NOT_NULL(series);
+    ASSERT_NOT_NULL(binned);
+    for (size_t i = 0; i < n; ++i)
+    {
+        series[i] = (double) ((i * 7919) % n) / n - 0.5;
+    }
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_EQUAL(8, inform_bin_quantiles(series, n, 8, binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    size_t counts[8] = {0};
+    for (size_t i = 0; i < n; ++i)
+    {
+        ASSERT_TRUE(0 <= binned[i] && binned[i] < 8);
+        counts[binned[i]]++;
+    }
+    for (size_t i = 0; i < 8; ++i)
+    {
+        ASSERT_TRUE(counts[i] > n / 8 - n / 64);
+        ASSERT_TRUE(counts[i] < n / 8 + n / 64);
+    }
+    free(binned);
+    free(series);
+}
+
+UNIT(QuantileSketchInvalidArguments)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_quantile_sketch_add(NULL, (double[]){1}, 1, &err);
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_quantile_sketch_query(NULL, 0.5, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    inform_quantile_sketch *sketch = inform_quantile_sketch_alloc(&err);
+    ASSERT_NOT_NULL(sketch);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    inform_quantile_sketch_add(sketch, NULL, 1, &err);
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_quantile_sketch_query(sketch, 0.5, &err));
+    ASSERT_EQUAL(INFORM_ESHORTSERIES, err);
+
+    err = INFORM_SUCCESS;
+    inform_quantile_sketch_add(sketch, (double[]){1}, 1, &err);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_NAN(inform_quantile_sketch_query(sketch, 1.5, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    inform_quantile_sketch_free(sketch);
+}
+
+UNIT(QuantileSketchEmpty)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_quantile_sketch *sketch = inform_quantile_sketch_alloc(&err);
+    ASSERT_NOT_NULL(sketch);
+    inform_quantile_sketch_add(sketch, (double[]){1}, 0, &err);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (int i = 0; i <= 4; ++i)
+    {
+        err = INFORM_SUCCESS;
+        ASSERT_NAN(inform_quantile_sketch_query(sketch, i / 4.0, &err));
+        ASSERT_EQUAL(INFORM_ESHORTSERIES, err);
+    }
+    inform_quantile_sketch_free(sketch);
+}
+
+UNIT(QuantileSketchQuery)
+{
+    size_t const n = 200001;
+    double *series = malloc(n * sizeof(double));
+    ASSERT_NOT_NULL(series);
+    for (size_t i = 0; i < n; ++i)
+    {
+        series[i] = (double) ((i * 7919) % n) - 100000.0;
+    }
+
+    inform_error err = INFORM_SUCCESS;
+    inform_quantile_sketch *sketch = inform_quantile_sketch_alloc(&err);
+    ASSERT_NOT_NULL(sketch);
+    inform_quantile_sketch_add(sketch, series, n / 2, &err);
+    inform_quantile_sketch_add(sketch, series + n / 2, n - n / 2, &err);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    ASSERT_DBL_NEAR(-100000.0, inform_quantile_sketch_query(sketch, 0.0, &err));
+    ASSERT_DBL_NEAR(100000.0, inform_quantile_sketch_query(sketch, 1.0, &err));
+    for (int i = 1; i < 10; ++i)
+    {
+        if (i == 5) continue;
+        double const expect = 20000.0 * i - 100000.0;
+        double const got = inform_quantile_sketch_query(sketch, i / 10.0, &err);
+        ASSERT_TRUE(fabs(got - expect) <= fabs(expect) / 64);
+    }
+    ASSERT_TRUE(fabs(inform_quantile_sketch_query(sketch, 0.5, &err)) <= 1.0);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    inform_quantile_sketch_free(sketch);
+    free(series);
+}
+
 UNIT(CoalesceNullSeries)
 {
     inform_error err = INFORM_SUCCESS;
@@ -367,6 +594,167 @@ UNIT(CoalesceNoGaps)
     }
 }
 
+UNIT(Coalesce64NullSeries)
+{
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_EQUAL(0, inform_coalesce64(NULL, 3, (int[3]){0}, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+}
+
+UNIT(Coalesce64)
+{
+    int64_t series[8] = {
+        INT64_C(1) << 40, 5, INT64_C(1) << 62, 5,
+        INT64_C(1) << 40, 0, INT64_C(1) << 62, 5,
+    };
+    int expected[8] = {2, 1, 3, 1, 2, 0, 3, 1};
+    int coal[8];
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_EQUAL(4, inform_coalesce64(series, 8, coal, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        ASSERT_EQUAL(expected[i], coal[i]);
+    }
+}
+
+UNIT(CoalesceSpread)
+{
+    inform_error err = INFORM_SUCCESS;
+    int series[8] = {1000000, -5, 7, 1000000, INT_MIN, INT_MAX, -5, 7};
+    int binned[8];
+    int expect[8] = {3, 1, 2, 3, 0, 4, 1, 2};
+    ASSERT_EQUAL(5, inform_coalesce(series, 8, binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        ASSERT_EQUAL(expect[i], binned[i]);
+    }
+}
+
+UNIT(CoalesceNegative)
+{
+    inform_error err = INFORM_SUCCESS;
+    int series[6] = {-3,-1,-3,2,-1,2};
+    int binned[6];
+    int expect[6] = {0,1,0,2,1,2};
+    ASSERT_EQUAL(3, inform_coalesce(series, 6, binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 6; ++i)
+    {
+        ASSERT_EQUAL(expect[i], binned[i]);
+    }
+}
+
+UNIT(CoalesceLong)
+{
+    size_t const n = 300000;
+    int *series = malloc(n * sizeof(int));
+    int *binned = malloc(n * sizeof(int));
+    ASSERT_NOT_NULL(series);
+    ASSERT_NOT_NULL(binned);
+
+    // states spanning fewer and more values than there are observations
+    int const scales[2] = {1, 100000};
+    for (size_t k = 0; k < 2; ++k)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            series[i] = scales[k] * (inform_random_int(0, 1000) - 500);
+        }
+        inform_error err = INFORM_SUCCESS;
+        int const b = inform_coalesce(series, n, binned, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_TRUE(0 < b && b <= 1000);
+
+        int *seen = calloc(b, sizeof(int));
+        ASSERT_NOT_NULL(seen);
+        for (size_t i = 0; i < n; ++i)
+        {
+            ASSERT_TRUE(0 <= binned[i] && binned[i] < b);
+            seen[binned[i]] = 1;
+            if (i > 0)
+            {
+                // the states keep their order
+                ASSERT_EQUAL(series[i] < series[i-1], binned[i] < binned[i-1]);
+                ASSERT_EQUAL(series[i] == series[i-1],
+                    binned[i] == binned[i-1]);
+            }
+        }
+        for (int j = 0; j < b; ++j)
+        {
+            ASSERT_EQUAL(1, seen[j]);
+        }
+        free(seen);
+    }
+
+    free(binned);
+    free(series);
+}
+
+UNIT(CoalescerNullArguments)
+{
+    inform_error err = INFORM_SUCCESS;
+    int coal[2];
+    ASSERT_EQUAL(0, inform_coalescer_push(NULL, (int[]){1,2}, 2, coal, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    inform_coalescer *coalescer = inform_coalescer_alloc(&err);
+    ASSERT_NOT_NULL(coalescer);
+    ASSERT_TRUE(inform_coalescer_states(coalescer) == NULL);
+
+    ASSERT_EQUAL(0, inform_coalescer_push(coalescer, NULL, 2, coal, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL(0, inform_coalescer_push(coalescer, (int[]){1,2}, 2, NULL,
+        &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    inform_coalescer_free(coalescer);
+}
+
+UNIT(CoalescerPush)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_coalescer *coalescer = inform_coalescer_alloc(&err);
+    ASSERT_NOT_NULL(coalescer);
+
+    int coal[6];
+    int const first[4] = {5, 2, 5, 9};
+    int const expect_first[4] = {0, 1, 0, 2};
+    ASSERT_EQUAL(3, inform_coalescer_push(coalescer, first, 4, coal, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        ASSERT_EQUAL(expect_first[i], coal[i]);
+    }
+
+    ASSERT_EQUAL(3, inform_coalescer_push(coalescer, first, 0, coal, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    int64_t const second[6] = {9, 3, INT64_C(1) << 40, 2, 3, 5};
+    int const expect_second[6] = {2, 3, 4, 1, 3, 0};
+    ASSERT_EQUAL(5, inform_coalescer_push64(coalescer, second, 6, coal, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 6; ++i)
+    {
+        ASSERT_EQUAL(expect_second[i], coal[i]);
+    }
+
+    int64_t const states[5] = {5, 2, 9, 3, INT64_C(1) << 40};
+    int64_t const *got = inform_coalescer_states(coalescer);
+    ASSERT_TRUE(got != NULL);
+    for (size_t i = 0; i < 5; ++i)
+    {
+        ASSERT_TRUE(states[i] == got[i]);
+    }
+
+    inform_coalescer_free(coalescer);
+}
+
 UNIT(EncodeNullState)
 {
     inform_error err = INFORM_SUCCESS;
@@ -556,6 +944,46 @@ UNIT(DecodeEncode)
     }
 }
 
+UNIT(Encode64TooLarge)
+{
+    int state[64] = {0};
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_EQUAL(-1, inform_encode64(state, 64, 2, &err));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL(-1, inform_encode64(state, 32, 4, &err));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+}
+
+UNIT(Encode64BaseTwo)
+{
+    int state[63];
+    for (size_t i = 0; i < 63; ++i) state[i] = 1;
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_EQUAL(INT64_MAX, inform_encode64(state, 63, 2, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    state[0] = 0;
+    ASSERT_EQUAL(INT64_MAX >> 1, inform_encode64(state, 63, 2, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+}
+
+UNIT(Decode64Encode64)
+{
+    int state[62];
+    inform_error err = INFORM_SUCCESS;
+    for (int64_t i = (INT64_C(1) << 62) - 81; i < (INT64_C(1) << 62); ++i)
+    {
+        inform_decode64(i, 2, state, 62, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+        ASSERT_EQUAL(i, inform_encode64(state, 62, 2, &err));
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+    }
+}
+
 UNIT(RandomInt)
 {
     for (int b = 2; b < 5; ++b)
@@ -595,6 +1023,145 @@ UNIT(RandomIntMinMax)
     }
 }
 
+UNIT(RngSeed)
+{
+    inform_rng rng, other;
+    inform_rng_seed(&rng, 1879);
+    ASSERT_TRUE(inform_rng_next(&rng) == 0xa49084bf0a5af6b5);
+    ASSERT_TRUE(inform_rng_next(&rng) == 0x801d47240fe89630);
+    ASSERT_TRUE(inform_rng_next(&rng) == 0x29b9aa2e997f6bf9);
+
+    inform_rng_seed(&rng, 1879);
+    inform_rng_seed(&other, 1880);
+    ASSERT_TRUE(inform_rng_next(&rng) != inform_rng_next(&other));
+}
+
+UNIT(RngJump)
+{
+    inform_rng rng, stream, again;
+    inform_rng_seed(&rng, 2019);
+    stream = rng;
+    inform_rng_jump(&stream);
+    again = rng;
+    inform_rng_jump(&again);
+    for (size_t i = 0; i < 100; ++i)
+    {
+        uint64_t const x = inform_rng_next(&stream);
+        ASSERT_TRUE(x == inform_rng_next(&again));
+        ASSERT_TRUE(x != inform_rng_next(&rng));
+    }
+}
+
+UNIT(RngInt)
+{
+    inform_rng rng;
+    inform_rng_seed(&rng, 2019);
+    for (int b = 2; b < 5; ++b)
+    {
+        inform_dist *dist = inform_dist_alloc(b + 1);
+        for (size_t i = 0; i < 100000; ++i)
+        {
+            int x = inform_rng_int(&rng, -1, b);
+            ASSERT_TRUE(-1 <= x && x < b);
+            inform_dist_tick(dist, x + 1);
+        }
+        for (size_t i = 0; i < inform_dist_size(dist); ++i)
+        {
+            ASSERT_TRUE(inform_dist_get(dist, i) > 0);
+        }
+        inform_dist_free(dist);
+    }
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        int x = inform_rng_int(&rng, INT_MIN, INT_MAX);
+        ASSERT_TRUE(x != INT_MAX);
+        uint64_t const n = (uint64_t) 3 << 32;
+        ASSERT_TRUE(inform_rng_bounded(&rng, n) < n);
+    }
+}
+
+UNIT(RngIntEmptyRange)
+{
+    inform_rng rng, copy;
+    inform_rng_seed(&rng, 2019);
+    copy = rng;
+
+    ASSERT_EQUAL(3, inform_rng_int(&rng, 3, 3));
+    ASSERT_EQUAL(3, inform_rng_int(&rng, 3, -5));
+    ASSERT_EQUAL(INT_MAX, inform_rng_int(&rng, INT_MAX, INT_MIN));
+
+    int xs[4] = {0, 0, 0, 0};
+    ASSERT_TRUE(inform_rng_ints(&rng, 7, 2, 4, xs) == xs);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        ASSERT_EQUAL(7, xs[i]);
+    }
+
+    // the generator is not advanced by an empty range
+    ASSERT_TRUE(inform_rng_next(&rng) == inform_rng_next(&copy));
+}
+
+UNIT(RngIntWideRange)
+{
+    inform_rng rng;
+    inform_rng_seed(&rng, 2019);
+    bool negative = false, positive = false;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        int const x = inform_rng_int(&rng, INT_MIN + 1, INT_MAX);
+        ASSERT_TRUE(INT_MIN < x && x < INT_MAX);
+        negative |= (x < 0);
+        positive |= (x > 0);
+    }
+    ASSERT_TRUE(negative && positive);
+}
+
+UNIT(RngInts)
+{
+    inform_rng rng, other;
+    inform_rng_seed(&rng, 2019);
+    other = rng;
+
+    int *xs = inform_rng_ints(&rng, 1, 4, 1000, NULL);
+    ASSERT_NOT_NULL(xs);
+    int ys[1000];
+    ASSERT_TRUE(inform_rng_series(&other, 1000, 3, ys) == ys);
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(1 <= xs[i] && xs[i] < 4);
+        ASSERT_EQUAL(xs[i], ys[i] + 1);
+    }
+    free(xs);
+}
+
+UNIT(RngShuffle)
+{
+    inform_rng rng;
+    inform_rng_seed(&rng, 2019);
+
+    int xs[100];
+    for (int i = 0; i < 100; ++i) xs[i] = i;
+    inform_rng_shuffle(&rng, xs, 100);
+
+    int seen[100] = {0};
+    size_t moved = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_TRUE(0 <= xs[i] && xs[i] < 100);
+        seen[xs[i]]++;
+        moved += (xs[i] != i);
+    }
+    for (size_t i = 0; i < 100; ++i)
+    {
+        ASSERT_EQUAL(1, seen[i]);
+    }
+    ASSERT_TRUE(moved > 50);
+
+    inform_rng_shuffle(&rng, xs, 0);
+    inform_rng_shuffle(&rng, xs, 1);
+}
+
 UNIT(TPMNullSeries)
 {
     inform_error err = INFORM_SUCCESS;
@@ -1330,6 +1897,70 @@ UNIT(BlackBoxMultipleSeriesEnsemble)
     }
 }
 
+UNIT(BlackBox64EncodingError)
+{
+    int series[64] = {0};
+    int b[64];
+    for (size_t i = 0; i < 64; ++i) b[i] = 2;
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_black_box64(series, 64, 1, 1, b, NULL, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+}
+
+UNIT(BlackBox64MatchesBlackBox)
+{
+    int series[16] = {0,1,1,0,1,0,0,1,
+                      2,0,1,2,2,1,0,1};
+    int box[16];
+    int64_t box64[16];
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NOT_NULL(inform_black_box(series, 2, 2, 4, (int[]){2,3},
+        (size_t[]){2,1}, (size_t[]){0,1}, box, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_NOT_NULL(inform_black_box64(series, 2, 2, 4, (int[]){2,3},
+        (size_t[]){2,1}, (size_t[]){0,1}, box64, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        ASSERT_EQUAL(box[i], box64[i]);
+    }
+}
+
+UNIT(BlackBox64ManySeries)
+{
+    // 40 binary nodes, where node i is on at time t if and only if i
+    // divides t + 1
+    int series[40 * 8];
+    int b[40];
+    for (size_t i = 0; i < 40; ++i)
+    {
+        b[i] = 2;
+        for (size_t t = 0; t < 8; ++t)
+        {
+            series[8*i + t] = ((t + 1) % (i + 1) == 0);
+        }
+    }
+
+    inform_error err = INFORM_SUCCESS;
+    int64_t *box = inform_black_box64(series, 40, 1, 8, b, NULL, NULL, NULL,
+        &err);
+    ASSERT_NOT_NULL(box);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t t = 0; t < 8; ++t)
+    {
+        int state[40];
+        for (size_t i = 0; i < 40; ++i) state[i] = series[8*i + t];
+        ASSERT_EQUAL(inform_encode64(state, 40, 2, NULL), box[t]);
+    }
+
+    int coal[8];
+    ASSERT_EQUAL(8, inform_coalesce64(box, 8, coal, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    free(box);
+}
+
 UNIT(BlackBoxPartsNullSeries)
 {
     inform_error err = INFORM_SUCCESS;
@@ -1691,6 +2322,92 @@ UNIT(PartitionsBellNumbers)
         ASSERT_EQUAL_U(bell_numbers[i-1], bell_number(i));
 }
 
+UNIT(PartitionsCount)
+{
+    size_t const bell_numbers[11] = {
+        1, 2, 5, 15, 52, 203, 877, 4140, 21147, 115975, 678570,
+    };
+    for (size_t i = 1; i <= 11; ++i)
+        ASSERT_EQUAL_U(bell_numbers[i-1], inform_count_partitionings(i, 0));
+
+    size_t const stirling_numbers[5] = {1, 15, 25, 10, 1};
+    for (size_t k = 1; k <= 5; ++k)
+        ASSERT_EQUAL_U(stirling_numbers[k-1], inform_count_partitionings(5, k));
+
+    ASSERT_EQUAL_U(0, inform_count_partitionings(0, 0));
+    ASSERT_EQUAL_U(0, inform_count_partitionings(3, 4));
+    ASSERT_EQUAL_U(SIZE_MAX, inform_count_partitionings(30, 0));
+}
+
+UNIT(PartitionsNextInto)
+{
+    size_t const size = 6;
+    for (size_t blocks = 0; blocks <= size; ++blocks)
+    {
+        size_t *all = inform_first_partitioning(size);
+        size_t *parts = inform_first_partitioning_into(size, blocks);
+        ASSERT_NOT_NULL(all);
+        ASSERT_NOT_NULL(parts);
+
+        // the partitionings into `blocks` partitions, in the same order as
+        // they appear among all of the partitionings
+        size_t n = 1, count = 0;
+        do
+        {
+            if (blocks == 0 || n == blocks)
+            {
+                if (count != 0)
+                {
+                    ASSERT_EQUAL_U(blocks == 0 ? n : blocks,
+                        inform_next_partitioning_into(parts, size, blocks));
+                }
+                for (size_t j = 0; j < size; ++j)
+                    ASSERT_EQUAL_U(all[j], parts[j]);
+                ++count;
+            }
+        } while ((n = inform_next_partitioning(all, size)));
+        ASSERT_EQUAL_U(0, inform_next_partitioning_into(parts, size, blocks));
+        ASSERT_EQUAL_U(inform_count_partitionings(size, blocks), count);
+
+        free(parts);
+        free(all);
+    }
+    ASSERT_NULL(inform_first_partitioning_into(3, 4));
+}
+
+UNIT(PartitionsRankUnrank)
+{
+    size_t const size = 6;
+    size_t parts[6];
+    for (size_t blocks = 0; blocks <= size; ++blocks)
+    {
+        size_t *xs = inform_first_partitioning_into(size, blocks);
+        ASSERT_NOT_NULL(xs);
+        size_t const count = inform_count_partitionings(size, blocks);
+        for (size_t rank = 0; rank < count; ++rank)
+        {
+            ASSERT_EQUAL_U(rank, inform_rank_partitioning(xs, size, blocks));
+            ASSERT_TRUE(parts == inform_unrank_partitioning(rank, size, blocks,
+                parts));
+            for (size_t j = 0; j < size; ++j)
+                ASSERT_EQUAL_U(xs[j], parts[j]);
+            inform_next_partitioning_into(xs, size, blocks);
+        }
+        ASSERT_NULL(inform_unrank_partitioning(count, size, blocks, parts));
+        free(xs);
+    }
+
+    size_t *xs = inform_unrank_partitioning(10, 4, 0, NULL);
+    ASSERT_NOT_NULL(xs);
+    size_t const expected[4] = {0,1,1,2};
+    for (size_t j = 0; j < 4; ++j)
+        ASSERT_EQUAL_U(expected[j], xs[j]);
+    ASSERT_EQUAL_U(SIZE_MAX, inform_rank_partitioning(xs, 4, 2));
+    xs[3] = 3;
+    ASSERT_EQUAL_U(SIZE_MAX, inform_rank_partitioning(xs, 4, 0));
+    free(xs);
+}
+
 BEGIN_SUITE(Utilities)
     ADD_UNIT(RangeNullSeries)
     ADD_UNIT(RangeEmpty)
@@ -1723,6 +2440,16 @@ BEGIN_SUITE(Utilities)
     ADD_UNIT(BinBoundsTwo)
     ADD_UNIT(BinBoundsNone)
     ADD_UNIT(BinBoundsAll)
+    ADD_UNIT(BinBoundsUnsorted)
+    ADD_UNIT(BinBoundsRepeated)
+    ADD_UNIT(BinBoundsLong)
+    ADD_UNIT(BinQuantilesInvalidArguments)
+    ADD_UNIT(BinQuantilesEqual)
+    ADD_UNIT(BinQuantilesTied)
+    ADD_UNIT(BinQuantilesLong)
+    ADD_UNIT(QuantileSketchInvalidArguments)
+    ADD_UNIT(QuantileSketchEmpty)
+    ADD_UNIT(QuantileSketchQuery)
 
     ADD_UNIT(CoalesceNullSeries)
     ADD_UNIT(CoalesceEmpty)
@@ -1730,6 +2457,13 @@ BEGIN_SUITE(Utilities)
     ADD_UNIT(CoalesceUnchanged)
     ADD_UNIT(CoalesceShifted)
     ADD_UNIT(CoalesceNoGaps)
+    ADD_UNIT(Coalesce64NullSeries)
+    ADD_UNIT(Coalesce64)
+    ADD_UNIT(CoalesceSpread)
+    ADD_UNIT(CoalesceNegative)
+    ADD_UNIT(CoalesceLong)
+    ADD_UNIT(CoalescerNullArguments)
+    ADD_UNIT(CoalescerPush)
 
     ADD_UNIT(EncodeNullState)
     ADD_UNIT(EncodeEmpty)
@@ -1748,9 +2482,19 @@ BEGIN_SUITE(Utilities)
     ADD_UNIT(DecodeBaseThree)
 
     ADD_UNIT(DecodeEncode)
+    ADD_UNIT(Encode64TooLarge)
+    ADD_UNIT(Encode64BaseTwo)
+    ADD_UNIT(Decode64Encode64)
 
     ADD_UNIT(RandomInt)
     ADD_UNIT(RandomIntMinMax)
+    ADD_UNIT(RngSeed)
+    ADD_UNIT(RngJump)
+    ADD_UNIT(RngInt)
+    ADD_UNIT(RngIntEmptyRange)
+    ADD_UNIT(RngIntWideRange)
+    ADD_UNIT(RngInts)
+    ADD_UNIT(RngShuffle)
 
     ADD_UNIT(TPMNullSeries)
     ADD_UNIT(TPMNoInits)
@@ -1778,6 +2522,9 @@ BEGIN_SUITE(Utilities)
     ADD_UNIT(BlackBoxSingleSeriesEnsemble)
     ADD_UNIT(BlackBoxMultipleSeries)
     ADD_UNIT(BlackBoxMultipleSeriesEnsemble)
+    ADD_UNIT(BlackBox64EncodingError)
+    ADD_UNIT(BlackBox64MatchesBlackBox)
+    ADD_UNIT(BlackBox64ManySeries)
 
     ADD_UNIT(BlackBoxPartsNullSeries)
     ADD_UNIT(BlackBoxPartsEmptySeries)
@@ -1795,4 +2542,7 @@ BEGIN_SUITE(Utilities)
     ADD_UNIT(PartitionsNext3)
     ADD_UNIT(PartitionsNext4)
     ADD_UNIT(PartitionsBellNumbers)
+    ADD_UNIT(PartitionsCount)
+    ADD_UNIT(PartitionsNextInto)
+    ADD_UNIT(PartitionsRankUnrank)
 END_SUITE
@@ -4,9 +4,97 @@ const informcpp = require('../build/Release/informcpp');
  * The current implementation only supports 1-dimension time series of
  * integer values. This is represented with the `Series` type. If the
  * contents of a `Series` variable is invalid, a `TypeError` is raised.
+ *
+ * An `Int32Array` or `ArrayBuffer` is handed to Inform without being
+ * copied, so prefer them over plain arrays for long time series.
  */
 export type Series = number[] | Int32Array | ArrayBuffer;
 
+/**
+ * A time series, or several trials of one, which has been copied into the
+ * addon and validated once. Its base and range are recorded, so passing a
+ * handle to any measure in place of a series (or trials) skips the
+ * conversion and the scans for negative states and for the base that a
+ * plain `Series` incurs on every call.
+ * Prefer handles when the same series is analyzed many times, e.g. with
+ * several history lengths or in a permutation test.
+ *
+ * ```javascript
+ * > xs = new SeriesHandle([0,0,1,1,1,1,0,0,0])
+ * > [xs.base, xs.min, xs.max, xs.length]
+ * [ 2, 0, 1, 9 ]
+ * > activeInfo(xs, 2)
+ * 0.3059584928680418
+ * ```
+ */
+export interface SeriesHandle {
+    /** the base of the series, $\max(2, \mathrm{max} + 1)$ */
+    readonly base: number;
+    /** the smallest state of the series */
+    readonly min: number;
+    /** the largest state of the series */
+    readonly max: number;
+    /** the number of observations over all trials */
+    readonly length: number;
+    /** the number of trials */
+    readonly trials: number;
+    /** the number of time steps of each trial */
+    readonly steps: number;
+}
+
+/**
+ * Validate a series (or trials of one) and copy it into a [[SeriesHandle]].
+ * A `TypeError` is raised if the series is malformed, and an `Error` if it is
+ * empty or contains a negative state.
+ */
+export const SeriesHandle: new (series: Series | Trials) => SeriesHandle = informcpp.SeriesHandle;
+
+/**
+ * Observations of several independent trials, i.e. realizations of the same
+ * process from different initial conditions. Inform pools the trials into a
+ * single set of histograms rather than averaging per-trial values. Every
+ * trial must have the same number of time steps.
+ *
+ * Trials may be given either as an array of series, one per trial, which
+ * are copied into a single buffer, or as one flat series together with its
+ * shape, which is handed to Inform without being copied:
+ *
+ * ```javascript
+ * > activeInfo([[0,0,1,1,1,1,0,0,0], [1,0,0,1,0,0,1,0,0]], 2)
+ * 0.35987902873686084
+ * > data = new Int32Array([0,0,1,1,1,1,0,0,0,1,0,0,1,0,0,1,0,0])
+ * > activeInfo({ data, trials: 2, steps: 9 }, 2)
+ * 0.35987902873686084
+ * ```
+ */
+export type Trials = Series[] | { data: Series; trials: number; steps: number } | Binned;
+
+/**
+ * A continuously-valued time series (or trials of one, given its shape),
+ * which Inform bins natively before computing a measure, without an
+ * intermediate `Int32Array`. The series is split into either
+ *
+ * - `bins` bins of equal width spanning its range,
+ * - bins of width `step` starting from its least value, or
+ * - the bins delimited by `bounds`, a value falling in the bin of the first
+ *   boundary which exceeds it.
+ *
+ * An `Error` is raised if the binning is invalid, e.g. if fewer than two
+ * bins are requested or the series is constant.
+ *
+ * ```javascript
+ * > xs = new Float64Array([0.1, 0.2, 0.9, 0.8, 0.7, 0.6, 0.3, 0.2, 0.1])
+ * > activeInfo({ data: xs, bins: 2 }, 2)
+ * 0.3059584928680418
+ * > activeInfo({ data: xs, bounds: [0.5] }, 2)
+ * 0.3059584928680418
+ * ```
+ */
+export type Binned = { data: Float64Array; trials?: number; steps?: number } & (
+    | { bins: number }
+    | { step: number }
+    | { bounds: number[] | Float64Array });
+
 /**
  * [Mutual information](https://en.wikipedia.org/wiki/Mutual_information)
  * (MI) is a measure of mutual dependence between at least
@@ -23,6 +111,10 @@ export type Series = number[] | Int32Array | ArrayBuffer;
  *
  * See [Cover1991] for more details.
  *
+ * If `xs` and `ys` are adjacent views of a single buffer, e.g.
+ * `joint.subarray(0, n)` and `joint.subarray(n)`, then the two series are
+ * handed to Inform as-is rather than being copied into a combined buffer.
+ *
  * @param xs  observations of first variable
  * @param ys  observations of second variable
  * @returns   the mutual information between the variables
@@ -40,10 +132,122 @@ export type Series = number[] | Int32Array | ArrayBuffer;
  * [Cover1991] Cover, T.M. and Thomas, J.A. (1991) "Elements of information theory". New York: Wiley. ISBN
  * 0-471-06259-6.
  */
-export function mutualInfo(xs: Series, ys: Series): number {
+export function mutualInfo(xs: Series | Trials | SeriesHandle, ys: Series | Trials | SeriesHandle): number {
     return informcpp.mutualInfo(xs, ys);
 }
 
+/**
+ * Compute the [mutual information](#mutualinfo) between two time series on
+ * the libuv worker pool. The time series are copied before the promise is
+ * returned, so the caller is free to modify them while the computation runs.
+ *
+ * @param xs  observations of first variable
+ * @param ys  observations of second variable
+ * @returns   a promise of the mutual information between the variables
+ *
+ * # Examples
+ *
+ * ```javascript
+ * > xs = [0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1];
+ * > ys = [0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,1];
+ * > await mutualInfoAsync(xs, ys)
+ * 0.21417094500762912
+ * ```
+ */
+export function mutualInfoAsync(
+    xs: Series | Trials | SeriesHandle,
+    ys: Series | Trials | SeriesHandle,
+): Promise<number> {
+    return informcpp.mutualInfoAsync(xs, ys);
+}
+
+/**
+ * Compute the [mutual information](#mutualinfo) between every pair of a list
+ * of time series in a single call. Each series is validated once, and the
+ * pairs are spread across the available cores.
+ *
+ * The result is a dense, row-major `n × n` matrix whose element `i * n + j`
+ * is the mutual information between `series[i]` and `series[j]`. The matrix
+ * is symmetric, and its diagonal holds the entropy of each series.
+ *
+ * @param series  a list of equal-length time series
+ * @returns       the pairwise mutual information between the series
+ *
+ * # Examples
+ *
+ * ```javascript
+ * > xs = [0,0,1,1,2,1,1,0,0];
+ * > ys = [0,0,0,1,1,1,0,0,0];
+ * > mutualInfoMatrix([xs, ys])
+ * Float64Array [ 1.3921472236645345, 0.47385138961004536, 0.47385138961004536, 0.9182958340544896 ]
+ * ```
+ */
+export function mutualInfoMatrix(series: Array<Series | Trials | SeriesHandle>): Float64Array {
+    return informcpp.mutualInfoMatrix(series);
+}
+
+/**
+ * Compute the [mutual information](#mutualinfo) between two time series over
+ * a sliding window of `window` time steps, which advances by `step` time
+ * steps at a time. The histograms are kept from one window to the next, and
+ * only the observations which leave or enter the window are updated, so each
+ * step costs $O(\text{step})$ rather than $O(\text{window})$.
+ *
+ * @param xs      observations of first variable
+ * @param ys      observations of second variable
+ * @param window  the number of time steps in each window
+ * @param step    the number of time steps between the starts of consecutive windows
+ * @returns       the mutual information within each window, in order
+ *
+ * # Examples
+ *
+ * ```javascript
+ * > xs = [0,0,1,1,2,1,1,0,0];
+ * > ys = [0,0,0,1,1,1,0,0,0];
+ * > mutualInfoWindows(xs, ys, 5, 2)
+ * Float64Array [ 0.5709505944546684, 0.17095059445466854, 0.5709505944546684 ]
+ * ```
+ */
+export function mutualInfoWindows(
+    xs: Series | Trials | SeriesHandle,
+    ys: Series | Trials | SeriesHandle,
+    window: number,
+    step = 1,
+): Float64Array {
+    return informcpp.mutualInfoWindows(xs, ys, window, step);
+}
+
+/**
+ * Compute the local (pointwise) [mutual information](#mutualinfo) between two
+ * time series at each time step; the [[mutualInfo]] is their average.
+ *
+ * The values are written into `out` if it is given, which avoids allocating
+ * a new array on each call over long series. It must hold at least as many
+ * values as there are time steps; the result is `out` itself, or a view of
+ * its leading values if it is longer.
+ *
+ * @param xs   observations of first variable
+ * @param ys   observations of second variable
+ * @param out  an optional array to write the local values into
+ * @returns    the local mutual information at each time step
+ *
+ * # Examples
+ *
+ * ```javascript
+ * > xs = [0,0,1,1,1,1,0,0,0];
+ * > ys = [1,0,0,1,0,0,1,0,0];
+ * > localMutualInfo(xs, ys)
+ * Float64Array [ 0.2630344058337938, -0.15200309344504995, 0.16992500144231237, ... ]
+ * ```
+ */
+export function localMutualInfo(
+    xs: Series | Trials | SeriesHandle,
+    ys: Series | Trials | SeriesHandle,
+    out?: Float64Array,
+): Float64Array {
+    return informcpp.localMutualInfo(xs, ys, out);
+}
+
 /**
  * Active information (AI) was introduced in [Lizier2012]() to quantify
  * information storage in distributed computation. This implementation allows the
@@ -73,10 +277,121 @@ export function mutualInfo(xs: Series, ys: Series): number {
  * storage in complex distributed computation](http://dx.doi.org/10.1016/j.ins.2012.04.016)"
  * _Information Sciences_, (208):39-54. doi:10.1016/j.ins.2012.04.016
  */
-export function activeInfo(series: Series, k: number): number {
+export function activeInfo(series: Series | Trials | SeriesHandle, k: number): number {
     return informcpp.activeInfo(series, k);
 }
 
+/**
+ * Compute the [active information](#activeinfo) of a time series on the
+ * libuv worker pool. The time series is copied before the promise is
+ * returned, so the caller is free to modify it while the computation runs.
+ *
+ * @param series  observations of the source variable
+ * @param k       the history length ($k \geq 1$)
+ * @returns       a promise of the active information of the time series
+ *
+ * # Examples:
+ * ```javascript
+ * > ys = [0,0,1,1,1,1,0,0,0]
+ * > await activeInfoAsync(xs, 2)
+ * 0.3059584928680418
+ * ```
+ */
+export function activeInfoAsync(series: Series | Trials | SeriesHandle, k: number): Promise<number> {
+    return informcpp.activeInfoAsync(series, k);
+}
+
+/**
+ * Compute the [active information](#activeinfo) of a time series over a
+ * sliding window of `window` time steps, which advances by `step` time steps
+ * at a time. Each step costs $O(\text{step})$ rather than
+ * $O(\text{window})$; see [[mutualInfoWindows]].
+ *
+ * @param series  observations of the source variable
+ * @param k       the history length ($k \geq 1$)
+ * @param window  the number of time steps in each window
+ * @param step    the number of time steps between the starts of consecutive windows
+ * @returns       the active information within each window, in order
+ *
+ * # Examples:
+ * ```javascript
+ * > xs = [0,0,1,1,1,1,0,0,0]
+ * > activeInfoWindows(xs, 2, 6, 3)
+ * Float64Array [ 0, 0.31127812445913294 ]
+ * ```
+ */
+export function activeInfoWindows(
+    series: Series | Trials | SeriesHandle,
+    k: number,
+    window: number,
+    step = 1,
+): Float64Array {
+    return informcpp.activeInfoWindows(series, k, window, step);
+}
+
+/**
+ * Compute the local (pointwise) [active information](#activeinfo) of a time
+ * series at each time step after the first $k$, trial by trial; the
+ * [[activeInfo]] is their average. The values are written into `out` if it
+ * is given; see [[localMutualInfo]].
+ *
+ * @param series  observations of the source variable
+ * @param k       the history length ($k \geq 1$)
+ * @param out     an optional array to write the local values into
+ * @returns       the local active information at each time step
+ *
+ * # Examples:
+ * ```javascript
+ * > xs = [0,0,1,1,1,1,0,0,0]
+ * > localActiveInfo(xs, 2, new Float64Array(7))
+ * Float64Array [ -0.19264507794239588, 0.8073549220576041, 0.22239242133644802, ... ]
+ * ```
+ */
+export function localActiveInfo(series: Series | Trials | SeriesHandle, k: number, out?: Float64Array): Float64Array {
+    return informcpp.localActiveInfo(series, k, out);
+}
+
+/**
+ * The measures of a time series computed together by [[seriesProfile]].
+ */
+export interface SeriesProfile {
+    /** the [active information](#activeinfo) with history length $k$ */
+    activeInfo: number;
+    /** the entropy rate with history length $k$ */
+    entropyRate: number;
+    /** the block entropy of the length-$k$ blocks */
+    blockEntropy: number;
+    /** the predictive information with past and future length $k$, or `NaN` if the series is too short */
+    predictiveInfo: number;
+}
+
+/**
+ * Compute the [active information](#activeinfo), entropy rate, block entropy
+ * and predictive information of a time series in a single pass. The series
+ * is validated once and each length-$k$ block is encoded once, so this is
+ * considerably cheaper than computing the measures separately.
+ *
+ * The predictive information requires at least $2k + 1$ time steps; for
+ * shorter series it is `NaN`.
+ *
+ * @param series  observations of the variable
+ * @param k       the history length ($k \geq 1$)
+ * @returns       the measures of the time series
+ *
+ * # Examples:
+ * ```javascript
+ * > seriesProfile([0,0,1,1,1,1,0,0,0], 2)
+ * { activeInfo: 0.3059584928680419,
+ *   entropyRate: 0.6792696431662097,
+ *   blockEntropy: 1.811278124459133,
+ *   predictiveInfo: 0.6666666666666667 }
+ * ```
+ */
+export function seriesProfile(series: Series | Trials | SeriesHandle, k: number): SeriesProfile {
+    const [activeInfo, entropyRate, blockEntropy, predictiveInfo] = informcpp.seriesProfile(series, k);
+    return { activeInfo, entropyRate, blockEntropy, predictiveInfo };
+}
+
 /**
  * Transfer entropy (TE) was introduced by [Schreiber2000]() to quantify
  * information transfer between an information source and target,
@@ -111,6 +426,121 @@ export function activeInfo(series: Series, k: number): number {
  * transfer](https://dx.doi.org/10.1103/PhysRevLett.85.461)". _Physical Review Letters_. **85** (2):
  * 461-464. doi:10.1103/PhysRevLett.85.461
  */
-export function transferEntropy(source: Series, target: Series, k: number): number {
+export function transferEntropy(
+    source: Series | Trials | SeriesHandle,
+    target: Series | Trials | SeriesHandle,
+    k: number,
+): number {
     return informcpp.transferEntropy(source, target, k);
 }
+
+/**
+ * Compute the [transfer entropy](#transferentropy) between two time series
+ * on the libuv worker pool. The time series are copied before the promise is
+ * returned, so the caller is free to modify them while the computation runs.
+ *
+ * @param source  observations of the source variable
+ * @param target  observations of the target variable
+ * @param k       the history length ($k \geq 1$)
+ * @returns       a promise of the transfer entropy between the variables
+ *
+ * # Examples
+ * ```javascript
+ * > xs = [0,1,1,1,1,0,0,0,0]
+ * > ys = [0,0,1,1,1,1,0,0,0]
+ * > await transferEntropyAsync(xs, ys, 2)
+ * 0.6792696431662097
+ * ```
+ */
+export function transferEntropyAsync(
+    source: Series | Trials | SeriesHandle,
+    target: Series | Trials | SeriesHandle,
+    k: number,
+): Promise<number> {
+    return informcpp.transferEntropyAsync(source, target, k);
+}
+
+/**
+ * Compute the [transfer entropy](#transferentropy) between every ordered pair
+ * of a list of time series in a single call. Each series is validated once,
+ * the history of each target is encoded once and reused for every source,
+ * and the targets are spread across the available cores.
+ *
+ * The result is a dense, row-major `n × n` matrix whose element `i * n + j`
+ * is the transfer entropy from `series[i]` to `series[j]`.
+ *
+ * @param series  a list of equal-length time series
+ * @param k       the history length ($k \geq 1$)
+ * @returns       the pairwise transfer entropy between the series
+ *
+ * # Examples
+ * ```javascript
+ * > xs = [0,1,1,1,1,0,0,0,0]
+ * > ys = [0,0,1,1,1,1,0,0,0]
+ * > transferEntropyMatrix([xs, ys], 2)
+ * Float64Array [ 0, 0.6792696431662097, 0, 0 ]
+ * ```
+ */
+export function transferEntropyMatrix(series: Array<Series | Trials | SeriesHandle>, k: number): Float64Array {
+    return informcpp.transferEntropyMatrix(series, k);
+}
+
+/**
+ * Compute the [transfer entropy](#transferentropy) between two time series
+ * over a sliding window of `window` time steps, which advances by `step` time
+ * steps at a time. Each step costs $O(\text{step})$ rather than
+ * $O(\text{window})$; see [[mutualInfoWindows]].
+ *
+ * @param source  observations of the source variable
+ * @param target  observations of the target variable
+ * @param k       the history length ($k \geq 1$)
+ * @param window  the number of time steps in each window
+ * @param step    the number of time steps between the starts of consecutive windows
+ * @returns       the transfer entropy within each window, in order
+ *
+ * # Examples
+ * ```javascript
+ * > xs = [0,1,1,1,1,0,0,0,0]
+ * > ys = [0,0,1,1,1,1,0,0,0]
+ * > transferEntropyWindows(xs, ys, 2, 6, 3)
+ * Float64Array [ 0, 0.5 ]
+ * ```
+ */
+export function transferEntropyWindows(
+    source: Series | Trials | SeriesHandle,
+    target: Series | Trials | SeriesHandle,
+    k: number,
+    window: number,
+    step = 1,
+): Float64Array {
+    return informcpp.transferEntropyWindows(source, target, k, window, step);
+}
+
+/**
+ * Compute the local (pointwise) [transfer entropy](#transferentropy) from a
+ * source to a target time series at each time step after the first $k$,
+ * trial by trial; the [[transferEntropy]] is their average. The values are
+ * written into `out` if it is given; see [[localMutualInfo]].
+ *
+ * @param source  observations of the source variable
+ * @param target  observations of the target variable
+ * @param k       the history length ($k \geq 1$)
+ * @param out     an optional array to write the local values into
+ * @returns       the local transfer entropy at each time step
+ *
+ * # Examples
+ * ```javascript
+ * > xs = [1,0,0,1,0,0,1,0,0]
+ * > ys = [0,0,1,1,1,1,0,0,0]
+ * > localTransferEntropy(xs, ys, 2)
+ * Float64Array [ 0, 0, 0.5849625007211562, -0.4150374992788438, 0.5849625007211562, 0, 0 ]
+ * ```
+ */
+export function localTransferEntropy(
+    source: Series | Trials | SeriesHandle,
+    target: Series | Trials | SeriesHandle,
+    k: number,
+    out?: Float64Array,
+): Float64Array {
+    return informcpp.localTransferEntropy(source, target, k, out);
+}
@@ -1,6 +1,8 @@
 import * as seedrandom from 'seedrandom';
 import * as Core from './Core';
-import { Series } from './Core';
+import { Series, SeriesHandle, Trials } from './Core';
+
+const informcpp = require('../build/Release/informcpp');
 
 /**
  * An RNG to use by default. This global allows us to avoid recreating
@@ -49,6 +51,64 @@ export interface SigValue {
     sig: Sig;
 }
 
+/**
+ * The measures supported by [[permutationTest]].
+ */
+export type Measure = 'mutualInfo' | 'activeInfo' | 'transferEntropy';
+
+/**
+ * Draw a seed for the native permutation test from a JavaScript RNG.
+ */
+function drawSeed(rng: RNG): number {
+    return Math.floor(rng.double() * 4294967296);
+}
+
+/**
+ * Compute a measure together with its statistical significance using a
+ * permutation test which runs entirely within the native addon. As with the
+ * other functions in this module, surrogates are generated by shuffling the
+ * second series for `mutualInfo`, the series for `activeInfo` and the source
+ * for `transferEntropy`. Shuffling uses a seeded
+ * [xoshiro256**](http://prng.di.unimi.it/) generator, and the permutations
+ * are spread across all available cores.
+ *
+ * The result depends only on `seed`, not on the number of cores. Note that
+ * it does not coincide with the result of passing an [[RNG]] to one of the
+ * other functions in this module, since those shuffle in JavaScript.
+ *
+ * @param measure  the name of the measure to test
+ * @param args     the arguments to pass to the measure
+ * @param nperm    number of permutations
+ * @param seed     a non-negative integer seed
+ * @returns        the computed value and estimated statistical significance
+ *
+ * # Examples:
+ *
+ * ```typescript
+ * import { Significance } from 'inform';
+ *
+ * const { permutationTest } = Significance;
+ *
+ * const xs = [0,0,1,1,2,1,1,0,0];
+ * const ys = [0,0,0,1,1,1,0,0,0];
+ *
+ * permutationTest('transferEntropy', [xs, ys, 2], 100000, 2019);
+ * ```
+ */
+export function permutationTest(
+    measure: Measure,
+    args: Array<Series | Trials | SeriesHandle | number>,
+    nperm: number,
+    seed?: number,
+): SigValue {
+    if (nperm < 10) {
+        throw new TypeError(`too few permutations; got ${nperm} < 10`);
+    }
+    seed = seed === undefined ? drawSeed(localRNG) : seed;
+    const { value, p, se } = informcpp.permutationTest(measure, args, nperm, seed);
+    return { value, sig: { p, se } };
+}
+
 /**
  * Randomly shuffle an `Int32Array` in place using
  * Durstenfeld's version of the [Fisher-Yates
@@ -80,7 +140,7 @@ function shuffleInPlace(series: Int32Array, rng?: RNG): Int32Array {
  * @param xs     observations of the first variable
  * @param ys     observations of the second variable
  * @param nperm  number of permutations
- * @param rng    a random number generator
+ * @param rng    a random number generator, or a seed for [[permutationTest]]
  * @returns      the computed mutual information and estimated statistical significance
  *
  * @see [`informjs.mutualInfo`](_core_.html#mutualinfo)
@@ -96,7 +156,7 @@ function shuffleInPlace(series: Int32Array, rng?: RNG): Int32Array {
  * const xs = [0,0,1,1,2,1,1,0,0];
  * const ys = [0,0,0,1,1,1,0,0,0];
  *
- * mutualInfo(xs, ys, 100000); // Uses a default RNG, automatically seeded
+ * mutualInfo(xs, ys, 100000); // Uses the native engine, automatically seeded
  * // value will always be the same, but sig will vary based on the seed.
  * //
  * // {
@@ -113,10 +173,13 @@ function shuffleInPlace(series: Int32Array, rng?: RNG): Int32Array {
  * // }
  * ```
  */
-export function mutualInfo(xs: Series, ys: Series, nperm: number, rng?: RNG): SigValue {
+export function mutualInfo(xs: Series, ys: Series, nperm: number, rng?: RNG | number): SigValue {
     if (nperm < 10) {
         throw new TypeError(`too few permutations; got ${nperm} < 10`);
     }
+    if (rng === undefined || typeof rng === 'number') {
+        return permutationTest('mutualInfo', [xs, ys], nperm, rng);
+    }
 
     const as = new Int32Array(xs.slice(0));
     const bs = new Int32Array(ys.slice(0));
@@ -139,7 +202,7 @@ export function mutualInfo(xs: Series, ys: Series, nperm: number, rng?: RNG): Si
  * @param xs     observations of the first variable
  * @param k      the history length ($k \geq 1$)
  * @param nperm  number of permutations
- * @param rng    a random number generator
+ * @param rng    a random number generator, or a seed for [[permutationTest]]
  * @returns      the computed active information and estimated statistical significance
  *
  * @see [`informjs.activeInfo`](_core_.html#activeInfo)
@@ -154,7 +217,7 @@ export function mutualInfo(xs: Series, ys: Series, nperm: number, rng?: RNG): Si
  *
  * const xs = [0,0,1,1,2,1,1,0,0];
  *
- * activeInfo(xs, 2, 100000); // Uses a default RNG, automatically seeded
+ * activeInfo(xs, 2, 100000); // Uses the native engine, automatically seeded
  * // value will always be the same, but sig will vary based on the seed.
  * //
  * // {
@@ -171,10 +234,13 @@ export function mutualInfo(xs: Series, ys: Series, nperm: number, rng?: RNG): Si
  * // }
  * ```
  */
-export function activeInfo(xs: Series, k: number, nperm: number, rng?: RNG): SigValue {
+export function activeInfo(xs: Series, k: number, nperm: number, rng?: RNG | number): SigValue {
     if (nperm < 10) {
         throw new TypeError(`too few permutations; got ${nperm} < 10`);
     }
+    if (rng === undefined || typeof rng === 'number') {
+        return permutationTest('activeInfo', [xs, k], nperm, rng);
+    }
 
     const as = new Int32Array(xs.slice(0));
 
@@ -197,7 +263,7 @@ export function activeInfo(xs: Series, k: number, nperm: number, rng?: RNG): Sig
  * @param target  observations of the target variable
  * @param k       the history length ($k \geq 1$)
  * @param nperm   number of permutations
- * @param rng     a random number generator
+ * @param rng     a random number generator, or a seed for [[permutationTest]]
  * @returns       the computed transfer entropy and estimated statistical significance
  *
  * @see [`informjs.transferEntropy`](_core_.html#transferentropy)
@@ -213,7 +279,7 @@ export function activeInfo(xs: Series, k: number, nperm: number, rng?: RNG): Sig
  * const xs = [0,0,1,1,2,1,1,0,0];
  * const ys = [0,0,0,1,1,1,0,0,0];
  *
- * transferEntropy(xs, ys, 2, 100000); // Uses a default RNG, automatically seeded
+ * transferEntropy(xs, ys, 2, 100000); // Uses the native engine, automatically seeded
  * // value will always be the same, but sig will vary based on the seed.
  * //
  * // {
@@ -230,10 +296,19 @@ export function activeInfo(xs: Series, k: number, nperm: number, rng?: RNG): Sig
  * // }
  * ```
  */
-export function transferEntropy(source: Series, target: Series, k: number, nperm: number, rng?: RNG): SigValue {
+export function transferEntropy(
+    source: Series,
+    target: Series,
+    k: number,
+    nperm: number,
+    rng?: RNG | number,
+): SigValue {
     if (nperm < 10) {
         throw new TypeError(`too few permutations; got ${nperm} < 10`);
     }
+    if (rng === undefined || typeof rng === 'number') {
+        return permutationTest('transferEntropy', [source, target, k], nperm, rng);
+    }
     const ss = new Int32Array(source.slice(0));
     const ts = new Int32Array(target.slice(0));
 
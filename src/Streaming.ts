@@ -0,0 +1,211 @@
+import { Series, SeriesHandle } from './Core';
+
+const informcpp = require('../build/Release/informcpp');
+
+/**
+ * Estimate the [mutual information](_core_.html#mutualinfo) between two
+ * unbounded streams of observations. Each call to `push` folds a chunk of
+ * observations into histograms kept by the addon, so neither the streams
+ * nor any past chunks need to be kept in memory, and `value` does not
+ * rescan the histograms.
+ *
+ * Unlike [[mutualInfo]], the base of the observations must be given up front,
+ * as the histograms cannot grow once observations have been made.
+ *
+ * # Examples
+ *
+ * ```javascript
+ * > estimator = new MutualInfoEstimator(3);
+ * > estimator.push([0,0,1,1,2], [0,0,0,1,1]).push([1,1,0,0], [1,0,0,0]);
+ * > estimator.value()
+ * 0.47385138961004536
+ * ```
+ */
+export class MutualInfoEstimator {
+    /**
+     * Restore an estimator from the state returned by [[serialize]].
+     *
+     * @param state  the serialized state of an estimator
+     * @returns      an estimator which continues from that state
+     */
+    public static deserialize(state: ArrayBuffer): MutualInfoEstimator {
+        const estimator = Object.create(MutualInfoEstimator.prototype);
+        estimator.native = new informcpp.MutualInfoEstimator(state);
+        return estimator;
+    }
+
+    private native: any;
+
+    /**
+     * @param base  the number of states of each stream ($b \geq 2$)
+     */
+    constructor(base: number) {
+        this.native = new informcpp.MutualInfoEstimator(base);
+    }
+
+    /**
+     * Observe the next chunk of each stream. The chunk is validated in its
+     * entirety before it is observed, so an invalid chunk leaves the
+     * estimator unchanged.
+     *
+     * @param xs  the next observations of the first variable
+     * @param ys  the next observations of the second variable
+     * @returns   the estimator
+     */
+    public push(xs: Series | SeriesHandle, ys: Series | SeriesHandle): this {
+        this.native.push(xs, ys);
+        return this;
+    }
+
+    /**
+     * @returns  the mutual information of the observations so far, or `NaN` if there are none
+     */
+    public value(): number {
+        return this.native.value();
+    }
+
+    /**
+     * Serialize the state of the estimator so that it can be restored with
+     * [[deserialize]], e.g. after the process restarts. The state is written
+     * in native byte order.
+     *
+     * @returns  the state of the estimator
+     */
+    public serialize(): ArrayBuffer {
+        return this.native.serialize();
+    }
+}
+
+/**
+ * Estimate the [active information](_core_.html#activeinfo) of an unbounded
+ * stream of observations. The last `k` observations are kept between chunks,
+ * so pushing a series in several chunks gives the same estimate as pushing
+ * it all at once.
+ *
+ * # Examples
+ *
+ * ```javascript
+ * > estimator = new ActiveInfoEstimator(2, 2);
+ * > estimator.push([0,0,1,1]).push([1,1,0,0,0]);
+ * > estimator.value()
+ * 0.3059584928680419
+ * ```
+ */
+export class ActiveInfoEstimator {
+    /**
+     * Restore an estimator from the state returned by [[serialize]].
+     *
+     * @param state  the serialized state of an estimator
+     * @returns      an estimator which continues from that state
+     */
+    public static deserialize(state: ArrayBuffer): ActiveInfoEstimator {
+        const estimator = Object.create(ActiveInfoEstimator.prototype);
+        estimator.native = new informcpp.ActiveInfoEstimator(state);
+        return estimator;
+    }
+
+    private native: any;
+
+    /**
+     * @param k     the history length ($k \geq 1$)
+     * @param base  the number of states of the stream ($b \geq 2$)
+     */
+    constructor(k: number, base: number) {
+        this.native = new informcpp.ActiveInfoEstimator(k, base);
+    }
+
+    /**
+     * Observe the next chunk of the stream.
+     *
+     * @param series  the next observations
+     * @returns       the estimator
+     */
+    public push(series: Series | SeriesHandle): this {
+        this.native.push(series);
+        return this;
+    }
+
+    /**
+     * @returns  the active information of the observations so far, or `NaN` if there are none
+     */
+    public value(): number {
+        return this.native.value();
+    }
+
+    /**
+     * Serialize the state of the estimator so that it can be restored with
+     * [[deserialize]].
+     *
+     * @returns  the state of the estimator
+     */
+    public serialize(): ArrayBuffer {
+        return this.native.serialize();
+    }
+}
+
+/**
+ * Estimate the [transfer entropy](_core_.html#transferentropy) from one
+ * unbounded stream of observations to another. The last `k` observations of
+ * the target and the last observation of the source are kept between chunks.
+ *
+ * # Examples
+ *
+ * ```javascript
+ * > estimator = new TransferEntropyEstimator(2, 2);
+ * > estimator.push([0,1,1,1], [0,0,1,1]).push([1,0,0,0,0], [1,1,0,0,0]);
+ * > estimator.value()
+ * 0.6792696431662097
+ * ```
+ */
+export class TransferEntropyEstimator {
+    /**
+     * Restore an estimator from the state returned by [[serialize]].
+     *
+     * @param state  the serialized state of an estimator
+     * @returns      an estimator which continues from that state
+     */
+    public static deserialize(state: ArrayBuffer): TransferEntropyEstimator {
+        const estimator = Object.create(TransferEntropyEstimator.prototype);
+        estimator.native = new informcpp.TransferEntropyEstimator(state);
+        return estimator;
+    }
+
+    private native: any;
+
+    /**
+     * @param k     the history length ($k \geq 1$)
+     * @param base  the number of states of each stream ($b \geq 2$)
+     */
+    constructor(k: number, base: number) {
+        this.native = new informcpp.TransferEntropyEstimator(k, base);
+    }
+
+    /**
+     * Observe the next chunk of each stream.
+     *
+     * @param source  the next observations of the source variable
+     * @param target  the next observations of the target variable
+     * @returns       the estimator
+     */
+    public push(source: Series | SeriesHandle, target: Series | SeriesHandle): this {
+        this.native.push(source, target);
+        return this;
+    }
+
+    /**
+     * @returns  the transfer entropy of the observations so far, or `NaN` if there are none
+     */
+    public value(): number {
+        return this.native.value();
+    }
+
+    /**
+     * Serialize the state of the estimator so that it can be restored with
+     * [[deserialize]].
+     *
+     * @returns  the state of the estimator
+     */
+    public serialize(): ArrayBuffer {
+        return this.native.serialize();
+    }
+}
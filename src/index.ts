@@ -1,4 +1,5 @@
 import * as Significance from './Significance';
 
 export * from './Core';
+export * from './Streaming';
 export { Significance };
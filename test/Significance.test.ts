@@ -1,10 +1,11 @@
-import { Significance } from '../src';
+import { SeriesHandle, Significance } from '../src';
 import * as seed from 'seedrandom';
 
 describe('check exports', () => {
     test('.has mutualInfo', () => expect(Significance.mutualInfo).toBeDefined());
     test('.has activeInfo', () => expect(Significance.activeInfo).toBeDefined());
     test('.has transferEntropy', () => expect(Significance.transferEntropy).toBeDefined());
+    test('.has permutationTest', () => expect(Significance.permutationTest).toBeDefined());
 });
 
 describe('mutual information', () => {
@@ -94,3 +95,69 @@ describe('transfer entropy', () => {
         expect(te.sig.se).toBeCloseTo(0.01, 2);
     });
 });
+
+describe('permutation test', () => {
+    const { permutationTest } = Significance;
+
+    test('.throws for too-few permutations', () => {
+        expect(() => permutationTest('mutualInfo', [[0, 0, 1, 1], [0, 1, 0, 1]], 9, 2019)).toThrow(/too few/);
+    });
+
+    test('.throws for unsupported measures', () => {
+        expect(() => permutationTest('entropy' as any, [[0, 0, 1, 1]], 100, 2019)).toThrow(/unsupported/);
+    });
+
+    test('.is deterministic for a given seed', () => {
+        const xs = [0, 0, 1, 1, 2, 1, 1, 0, 0];
+        const ys = [0, 0, 0, 1, 1, 1, 0, 0, 0];
+        const a = permutationTest('mutualInfo', [xs, ys], 1000, 2019);
+        const b = permutationTest('mutualInfo', [xs, ys], 1000, 2019);
+        expect(a).toEqual(b);
+        expect(Significance.mutualInfo(xs, ys, 1000, 2019)).toEqual(a);
+    });
+
+    test('.accepts series handles', () => {
+        const xs = [0, 0, 1, 1, 2, 1, 1, 0, 0];
+        const ys = [0, 0, 0, 1, 1, 1, 0, 0, 0];
+        const sig = permutationTest('transferEntropy', [new SeriesHandle(xs), new SeriesHandle(ys), 2], 1000, 2019);
+        expect(sig).toEqual(permutationTest('transferEntropy', [xs, ys, 2], 1000, 2019));
+        expect(Significance.transferEntropy(xs, ys, 2, 100, seed('2019')).value).toBeCloseTo(sig.value, 10);
+    });
+
+    test('.can', () => {
+        let sig = permutationTest('mutualInfo', [[0, 0, 0, 0], [0, 0, 0, 0]], 100, 2019);
+        expect(sig.value).toBeCloseTo(0, 6);
+        expect(sig.sig.p).toBeCloseTo(1, 6);
+
+        sig = permutationTest('activeInfo', [[1, 0, 1, 0, 1, 0, 1, 0], 2], 1000, 2019);
+        expect(sig.value).toBeCloseTo(1, 6);
+        expect(sig.sig.p).toBeCloseTo(0.06, 1);
+
+        sig = permutationTest('transferEntropy', [[0, 0, 1, 0, 0, 0, 0, 0], [0, 0, 0, 1, 0, 0, 0, 0], 2], 10000, 2019);
+        expect(sig.value).toBeCloseTo(0.540852, 6);
+        expect(sig.sig.p).toBeCloseTo(0.125, 1);
+
+        sig = permutationTest('transferEntropy', [[0, 0, 1, 0, 0, 0, 0, 0], [0, 0, 0, 1, 0, 0, 0, 0], 2], 1000, 2019);
+        expect(sig.value).toBeCloseTo(0.540852, 6);
+        expect(sig.sig.p).toBeCloseTo(0.151, 3);
+        expect(sig.sig.se).toBeCloseTo(0.011, 3);
+    });
+
+    test('.handles histograms too large to allocate per thread', () => {
+        // bases of 4101 and 261 need more than 2^24 mutual information and
+        // transfer entropy counters per thread, respectively
+        const states = Array.from({ length: 200 }, (_, i) => (i * i * 7 + i * 3) % 11);
+        const xs = states.map((x) => x * 410);
+
+        let sig = permutationTest('mutualInfo', [xs, xs], 100, 2019);
+        expect(sig.value).toBeCloseTo(2.549306, 6);
+        expect(sig.sig.p).toBeCloseTo(1 / 101, 10);
+
+        const us = states.map((x) => x * 26);
+        const vs = [0, ...us.slice(0, -1)];
+        sig = permutationTest('transferEntropy', [us, vs, 1], 100, 2019);
+        expect(sig.value).toBeCloseTo(0.937852, 6);
+        expect(sig.sig.p).toBeCloseTo(1 / 101, 10);
+        expect(permutationTest('transferEntropy', [us, vs, 1], 100, 2019)).toEqual(sig);
+    });
+});
@@ -0,0 +1,106 @@
+import {
+    ActiveInfoEstimator,
+    activeInfo,
+    MutualInfoEstimator,
+    mutualInfo,
+    TransferEntropyEstimator,
+    transferEntropy,
+} from '../src';
+
+const xs = [0, 1, 1, 1, 1, 0, 0, 0, 0, 1, 2, 2, 0, 1, 0, 0, 2, 1];
+const ys = [0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 1, 2, 2, 0, 1, 0, 0, 2];
+
+describe('mutual information estimator', () => {
+    test('.throws for invalid bases', () => {
+        expect(() => new MutualInfoEstimator(1)).toThrow(/base/);
+    });
+
+    test('.throws for invalid chunks', () => {
+        const estimator = new MutualInfoEstimator(2);
+        expect(() => estimator.push([0, 1], [0])).toThrow(/different lengths/);
+        expect(() => estimator.push([0, 2], [0, 1])).toThrow(/unexpected state/);
+        expect(() => estimator.push([0, -1], [0, 1])).toThrow(/negative/);
+        expect(estimator.value()).toBeNaN();
+    });
+
+    test.each([1, 4, 7, 18])('.agrees with mutualInfo (chunks of %d)', chunk => {
+        const estimator = new MutualInfoEstimator(3);
+        for (let i = 0; i < xs.length; i += chunk) {
+            estimator.push(xs.slice(i, i + chunk), new Int32Array(ys.slice(i, i + chunk)));
+        }
+        expect(estimator.value()).toBeCloseTo(mutualInfo(xs, ys), 10);
+    });
+
+    test('.serialize', () => {
+        const estimator = new MutualInfoEstimator(3).push(xs.slice(0, 9), ys.slice(0, 9));
+        const restored = MutualInfoEstimator.deserialize(estimator.serialize());
+        expect(restored).toBeInstanceOf(MutualInfoEstimator);
+        restored.push(xs.slice(9), ys.slice(9));
+        expect(restored.value()).toBeCloseTo(mutualInfo(xs, ys), 10);
+    });
+
+    test('.deserializes version 1 states', () => {
+        // The first version of the format wrote every histogram without the
+        // width of its counters.
+        const words = [0x534a4649, 1, 1, 2, 4, 0, 4, 0, 2, 0, 0, 2, 2, 0, 2, 2, 2, 0, 2, 2];
+        const state = new ArrayBuffer(4 * words.length);
+        const view = new DataView(state);
+        words.forEach((word, i) => view.setUint32(4 * i, word, true));
+        expect(MutualInfoEstimator.deserialize(state).value()).toBeCloseTo(1, 10);
+    });
+
+    test('.throws for invalid states', () => {
+        const state = new ActiveInfoEstimator(2, 3).serialize();
+        expect(() => MutualInfoEstimator.deserialize(state)).toThrow(/invalid/);
+        expect(() => MutualInfoEstimator.deserialize(new ArrayBuffer(12))).toThrow(/invalid/);
+    });
+});
+
+describe('active information estimator', () => {
+    test('.throws for invalid arguments', () => {
+        expect(() => new ActiveInfoEstimator(0, 2)).toThrow(/zero/);
+        expect(() => new ActiveInfoEstimator(2, 1)).toThrow(/base/);
+    });
+
+    test.each([1, 2, 5, 18])('.agrees with activeInfo (chunks of %d)', chunk => {
+        const estimator = new ActiveInfoEstimator(2, 3);
+        for (let i = 0; i < xs.length; i += chunk) {
+            estimator.push(xs.slice(i, i + chunk));
+        }
+        expect(estimator.value()).toBeCloseTo(activeInfo(xs, 2), 10);
+    });
+
+    test('.serialize', () => {
+        const estimator = new ActiveInfoEstimator(2, 3).push(xs.slice(0, 10));
+        const restored = ActiveInfoEstimator.deserialize(estimator.serialize());
+        restored.push(xs.slice(10));
+        expect(restored.value()).toBeCloseTo(activeInfo(xs, 2), 10);
+    });
+
+    test('.throws for truncated states', () => {
+        const state = new ActiveInfoEstimator(2, 3).serialize();
+        expect(() => ActiveInfoEstimator.deserialize(state.slice(0, state.byteLength - 1))).toThrow(/invalid/);
+    });
+});
+
+describe('transfer entropy estimator', () => {
+    test('.throws for invalid arguments', () => {
+        expect(() => new TransferEntropyEstimator(0, 2)).toThrow(/zero/);
+        expect(() => new TransferEntropyEstimator(2, 1)).toThrow(/base/);
+    });
+
+    test.each([1, 2, 5, 18])('.agrees with transferEntropy (chunks of %d)', chunk => {
+        const estimator = new TransferEntropyEstimator(2, 3);
+        for (let i = 0; i < xs.length; i += chunk) {
+            estimator.push(xs.slice(i, i + chunk), ys.slice(i, i + chunk));
+        }
+        expect(estimator.value()).toBeCloseTo(transferEntropy(xs, ys, 2), 10);
+    });
+
+    test('.serialize', () => {
+        const estimator = new TransferEntropyEstimator(2, 3).push(xs.slice(0, 10), ys.slice(0, 10));
+        const restored = TransferEntropyEstimator.deserialize(estimator.serialize());
+        restored.push(xs.slice(10), ys.slice(10));
+        expect(restored.value()).toBeCloseTo(transferEntropy(xs, ys, 2), 10);
+    });
+});
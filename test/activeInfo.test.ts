@@ -1,4 +1,4 @@
-import { activeInfo } from '../src';
+import { activeInfo, activeInfoAsync, activeInfoWindows, localActiveInfo, seriesProfile, SeriesHandle } from '../src';
 
 describe('active information', () => {
     test('.throws for empty', () => {
@@ -70,3 +70,192 @@ describe('active information', () => {
         expect(activeInfo(xs, k)).toBeCloseTo(ai, 6);
     });
 });
+
+describe('active information (views)', () => {
+    test('.offset views', () => {
+        const xs = new Int32Array([9, 9, 9, 1, 1, 0, 0, 1]).subarray(3);
+        expect(activeInfo(xs, 2)).toBeCloseTo(0.918296, 6);
+    });
+});
+
+describe('active information (async)', () => {
+    test('.rejects for empty', async () => {
+        await expect(activeInfoAsync([], 2)).rejects.toThrow(/NULL/);
+    });
+
+    test('.rejects for invalid element', async () => {
+        await expect(activeInfoAsync([-1, 0, 0], 2)).rejects.toThrow(/negative/);
+        await expect(activeInfoAsync([0.5, 0, 0], 2)).rejects.toThrow(/not an integer/);
+    });
+
+    test('.rejects for invalid history length', async () => {
+        await expect(activeInfoAsync([0, 0, 0], 0)).rejects.toThrow(/history length/);
+        await expect(activeInfoAsync([0, 0, 0, 0], 5)).rejects.toThrow(/history length/);
+    });
+
+    test('.agrees with activeInfo', async () => {
+        const xs = [3, 3, 3, 2, 1, 0, 0, 0, 1];
+        await expect(activeInfoAsync(xs, 2)).resolves.toBeCloseTo(1.270942, 6);
+        await expect(activeInfoAsync(new Int32Array(xs), 3)).resolves.toBeCloseTo(1.459148, 6);
+    });
+});
+
+describe('active information (trials)', () => {
+    const trials = [
+        [0, 0, 1, 1, 1, 1, 0, 0, 0],
+        [1, 0, 0, 1, 0, 0, 1, 0, 0],
+    ];
+    const data = new Int32Array([0, 0, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0]);
+
+    test('.throws for different trial lengths', () => {
+        expect(() => activeInfo([[0, 0, 1], [0, 1]], 1)).toThrow(/different lengths/);
+    });
+
+    test('.throws for an inconsistent shape', () => {
+        expect(() => activeInfo({ data, trials: 2, steps: 8 }, 2)).toThrow(/inconsistent/);
+        expect(() => activeInfo({ data, trials: 2 } as any, 2)).toThrow(/steps/);
+    });
+
+    test('.can', () => {
+        expect(activeInfo(trials, 2)).toBeCloseTo(0.359879, 6);
+        expect(activeInfo(trials.map(xs => new Int32Array(xs)), 2)).toBeCloseTo(0.359879, 6);
+        expect(activeInfo({ data, trials: 2, steps: 9 }, 2)).toBeCloseTo(0.359879, 6);
+        expect(activeInfo({ data: data.buffer, trials: 2, steps: 9 }, 2)).toBeCloseTo(0.359879, 6);
+    });
+
+    test('.async', async () => {
+        await expect(activeInfoAsync(trials, 2)).resolves.toBeCloseTo(0.359879, 6);
+    });
+});
+
+describe('active information (windows)', () => {
+    const xs = [0, 0, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0];
+
+    test('.throws for invalid windows', () => {
+        expect(() => activeInfoWindows(xs, 2, 19, 1)).toThrow(/longer/);
+        expect(() => activeInfoWindows(xs, 2, 5, 0)).toThrow(/step/);
+        expect(() => activeInfoWindows(xs, 2, 2, 1)).toThrow(/too long/);
+        expect(() => activeInfoWindows(xs, 0, 5, 1)).toThrow(/zero/);
+    });
+
+    test.each([
+        [6, 1],
+        [6, 4],
+        [5, 7],
+        [18, 1],
+    ])('.agrees with activeInfo (window = %d, step = %d)', (window, step) => {
+        const ai = activeInfoWindows(xs, 2, window, step);
+        expect(ai.length).toBe(Math.floor((xs.length - window) / step) + 1);
+        ai.forEach((value, i) => {
+            const start = i * step;
+            expect(value).toBeCloseTo(activeInfo(xs.slice(start, start + window), 2), 10);
+        });
+    });
+
+    test('.throws when histories cannot be encoded', () => {
+        const ys = xs.map((x) => x * 65535);
+        expect(() => activeInfoWindows(ys, 4, 12, 1)).toThrow(/encoding/);
+    });
+
+    test('.large bases', () => {
+        const ys = xs.map((x) => x * 5000);
+        activeInfoWindows(ys, 2, 6, 4).forEach((value, i) => {
+            expect(value).toBeCloseTo(activeInfo(xs.slice(4 * i, 4 * i + 6), 2), 10);
+        });
+    });
+});
+
+describe('active information (local)', () => {
+    const xs = [0, 0, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0];
+    const mean = (values: Float64Array) => values.reduce((a, b) => a + b, 0) / values.length;
+
+    test('.throws for invalid arguments', () => {
+        expect(() => localActiveInfo(xs, 0)).toThrow(/zero/);
+        expect(() => localActiveInfo(xs, 2, new Float64Array(15))).toThrow(/too short/);
+        expect(() => localActiveInfo(xs, 2, [] as any)).toThrow(/Float64Array/);
+    });
+
+    test('.averages to activeInfo', () => {
+        const ai = localActiveInfo(xs, 2);
+        expect(ai.length).toBe(16);
+        expect(mean(ai)).toBeCloseTo(activeInfo(xs, 2), 10);
+    });
+
+    test('.averages to activeInfo for trials', () => {
+        const trials = { data: xs, trials: 2, steps: 9 };
+        const ai = localActiveInfo(trials, 2);
+        expect(ai.length).toBe(14);
+        expect(mean(ai)).toBeCloseTo(activeInfo(trials, 2), 10);
+    });
+
+    test('.writes into the output array', () => {
+        const out = new Float64Array(16);
+        expect(localActiveInfo(xs, 2, out)).toBe(out);
+        expect(out).toEqual(localActiveInfo(xs, 2));
+
+        const longer = new Float64Array(20).fill(-1);
+        const ai = localActiveInfo(xs, 2, longer);
+        expect(ai.buffer).toBe(longer.buffer);
+        expect(ai).toEqual(out);
+        expect(longer[16]).toBe(-1);
+    });
+});
+
+describe('series profile', () => {
+    test('.throws for invalid history length', () => {
+        expect(() => seriesProfile([0, 0, 0], 0)).toThrow(/history length/);
+        expect(() => seriesProfile([0, 0, 0], 3)).toThrow(/history length/);
+    });
+
+    test('.can', () => {
+        const profile = seriesProfile([0, 0, 1, 1, 1, 1, 0, 0, 0], 2);
+        expect(profile.activeInfo).toBeCloseTo(0.305958, 6);
+        expect(profile.entropyRate).toBeCloseTo(0.679270, 6);
+        expect(profile.blockEntropy).toBeCloseTo(1.811278, 6);
+        expect(profile.predictiveInfo).toBeCloseTo(0.666667, 6);
+    });
+
+    test('.agrees with activeInfo for trials', () => {
+        const trials = [
+            [0, 0, 1, 1, 1, 1, 0, 0, 0],
+            [1, 0, 0, 1, 0, 0, 1, 0, 0],
+        ];
+        expect(seriesProfile(trials, 2).activeInfo).toBeCloseTo(activeInfo(trials, 2), 10);
+    });
+
+    test('.predictive information needs 2k + 1 time steps', () => {
+        expect(seriesProfile([0, 0, 1, 1], 2).predictiveInfo).toBeNaN();
+    });
+});
+
+describe('series handle', () => {
+    test('.throws for empty series', () => {
+        expect(() => new SeriesHandle([])).toThrow();
+    });
+
+    test('.throws for negative states', () => {
+        expect(() => new SeriesHandle([0, -1, 1])).toThrow(/negative state/);
+    });
+
+    test('.records base and range', () => {
+        const xs = new SeriesHandle([1, 1, 3, 2]);
+        expect([xs.base, xs.min, xs.max, xs.length]).toEqual([4, 1, 3, 4]);
+        expect([xs.trials, xs.steps]).toEqual([1, 4]);
+    });
+
+    test('.records the shape of trials', () => {
+        const xs = new SeriesHandle([
+            [0, 0, 1],
+            [1, 0, 0],
+        ]);
+        expect([xs.trials, xs.steps, xs.length]).toEqual([2, 3, 6]);
+    });
+
+    test('.agrees with plain series', () => {
+        const xs = [0, 0, 1, 1, 1, 1, 0, 0, 0];
+        const handle = new SeriesHandle(xs);
+        expect(activeInfo(handle, 2)).toBeCloseTo(activeInfo(xs, 2), 10);
+        expect(activeInfoWindows(handle, 2, 6, 3)).toEqual(activeInfoWindows(xs, 2, 6, 3));
+        expect(seriesProfile(handle, 2)).toEqual(seriesProfile(xs, 2));
+    });
+});
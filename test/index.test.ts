@@ -4,5 +4,21 @@ describe('check exports', () => {
     test('.has mutualInfo', () => expect(informjs.mutualInfo).toBeDefined());
     test('.has activeInfo', () => expect(informjs.activeInfo).toBeDefined());
     test('.has transferEntropy', () => expect(informjs.transferEntropy).toBeDefined());
+    test('.has mutualInfoAsync', () => expect(informjs.mutualInfoAsync).toBeDefined());
+    test('.has activeInfoAsync', () => expect(informjs.activeInfoAsync).toBeDefined());
+    test('.has transferEntropyAsync', () => expect(informjs.transferEntropyAsync).toBeDefined());
+    test('.has mutualInfoMatrix', () => expect(informjs.mutualInfoMatrix).toBeDefined());
+    test('.has transferEntropyMatrix', () => expect(informjs.transferEntropyMatrix).toBeDefined());
+    test('.has mutualInfoWindows', () => expect(informjs.mutualInfoWindows).toBeDefined());
+    test('.has activeInfoWindows', () => expect(informjs.activeInfoWindows).toBeDefined());
+    test('.has transferEntropyWindows', () => expect(informjs.transferEntropyWindows).toBeDefined());
+    test('.has localMutualInfo', () => expect(informjs.localMutualInfo).toBeDefined());
+    test('.has localActiveInfo', () => expect(informjs.localActiveInfo).toBeDefined());
+    test('.has localTransferEntropy', () => expect(informjs.localTransferEntropy).toBeDefined());
+    test('.has seriesProfile', () => expect(informjs.seriesProfile).toBeDefined());
+    test('.has SeriesHandle', () => expect(informjs.SeriesHandle).toBeDefined());
+    test('.has MutualInfoEstimator', () => expect(informjs.MutualInfoEstimator).toBeDefined());
+    test('.has ActiveInfoEstimator', () => expect(informjs.ActiveInfoEstimator).toBeDefined());
+    test('.has TransferEntropyEstimator', () => expect(informjs.TransferEntropyEstimator).toBeDefined());
     test('.has Significance', () => expect(informjs.Significance).toBeDefined());
 });
@@ -1,4 +1,4 @@
-import { mutualInfo } from '../src';
+import { localMutualInfo, mutualInfo, mutualInfoAsync, mutualInfoMatrix, mutualInfoWindows } from '../src';
 
 describe('mutual information', () => {
     test('.throws for different lengths', () => {
@@ -60,3 +60,169 @@ describe('mutual information', () => {
         expect(mutualInfo(xsBuffer, ysBuffer)).toBeCloseTo(mi, 6);
     });
 });
+
+describe('mutual information (views)', () => {
+    test('.offset views', () => {
+        const xs = new Int32Array([9, 9, 0, 0, 1, 1, 2, 1, 1, 0, 0]).subarray(2);
+        const ys = new Int32Array([9, 0, 0, 0, 1, 1, 1, 0, 0, 0]).subarray(1);
+        expect(mutualInfo(xs, ys)).toBeCloseTo(0.473851, 6);
+    });
+
+    test('.adjacent views', () => {
+        const joint = new Int32Array([0, 0, 1, 1, 2, 1, 1, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0]);
+        const xs = joint.subarray(0, 9);
+        const ys = joint.subarray(9);
+        expect(mutualInfo(xs, ys)).toBeCloseTo(0.473851, 6);
+        expect(mutualInfo(ys, xs)).toBeCloseTo(0.473851, 6);
+    });
+});
+
+describe('mutual information (async)', () => {
+    test('.rejects for different lengths', async () => {
+        await expect(mutualInfoAsync([], [0])).rejects.toThrow(/different lengths/);
+        await expect(mutualInfoAsync([0], [])).rejects.toThrow(/different lengths/);
+    });
+
+    test('.rejects for empty', async () => {
+        await expect(mutualInfoAsync([], [])).rejects.toThrow(/NULL/);
+    });
+
+    test('.rejects for invalid element', async () => {
+        await expect(mutualInfoAsync([-1, 0, 0], [1, 1, 0])).rejects.toThrow(/negative/);
+        await expect(mutualInfoAsync([0.5, 0, 0], [1, 1, 0])).rejects.toThrow(/not an integer/);
+    });
+
+    test('.agrees with mutualInfo', async () => {
+        const xs = [0, 0, 1, 1, 2, 1, 1, 0, 0];
+        const ys = new Int32Array([0, 0, 0, 1, 1, 1, 0, 0, 0]);
+        const pending = mutualInfoAsync(xs, ys);
+        ys.fill(0);
+        await expect(pending).resolves.toBeCloseTo(0.473851, 6);
+    });
+});
+
+describe('mutual information (matrix)', () => {
+    const series = [
+        [0, 0, 1, 1, 2, 1, 1, 0, 0],
+        [0, 0, 0, 1, 1, 1, 0, 0, 0],
+        new Int32Array([1, 1, 0, 1, 0, 1, 1, 1, 0]),
+        [0, 1, 0, 0, 1, 0, 0, 1, 0],
+    ];
+
+    test('.throws for different lengths', () => {
+        expect(() => mutualInfoMatrix([[0, 0, 0], [0, 0, 0, 0]])).toThrow(/different lengths/);
+    });
+
+    test('.throws for empty', () => {
+        expect(() => mutualInfoMatrix([[], []])).toThrow(/NULL/);
+    });
+
+    test('.throws for negative states', () => {
+        expect(() => mutualInfoMatrix([[0, 1, 0], [1, -1, 1]])).toThrow(/negative/);
+    });
+
+    test('.empty', () => {
+        expect(mutualInfoMatrix([])).toEqual(new Float64Array());
+    });
+
+    test('.large bases', () => {
+        const mi = mutualInfoMatrix([[0, 2000000000, 1, 5], [0, 2000000000, 3, 1]]);
+        expect(Array.from(mi)).toEqual([2, 2, 2, 2]);
+    });
+
+    test('.agrees with mutualInfo', () => {
+        const n = series.length;
+        const mi = mutualInfoMatrix(series);
+        expect(mi).toBeInstanceOf(Float64Array);
+        expect(mi.length).toBe(n * n);
+        for (let i = 0; i < n; ++i) {
+            for (let j = 0; j < n; ++j) {
+                expect(mi[i * n + j]).toBeCloseTo(mutualInfo(series[i], series[j]), 10);
+            }
+        }
+    });
+});
+
+describe('mutual information (windows)', () => {
+    const xs = [0, 0, 1, 1, 2, 1, 1, 0, 0, 1, 2, 2, 0, 1];
+    const ys = [0, 0, 0, 1, 1, 1, 0, 0, 0, 1, 1, 0, 0, 1];
+
+    test('.throws for invalid windows', () => {
+        expect(() => mutualInfoWindows(xs, ys, 15, 1)).toThrow(/longer/);
+        expect(() => mutualInfoWindows(xs, ys, 5, 0)).toThrow(/step/);
+        expect(() => mutualInfoWindows(xs, ys, 0, 1)).toThrow(/too short/);
+    });
+
+    test.each([
+        [5, 1],
+        [5, 3],
+        [4, 6],
+        [14, 1],
+    ])('.agrees with mutualInfo (window = %d, step = %d)', (window, step) => {
+        const mi = mutualInfoWindows(xs, ys, window, step);
+        expect(mi.length).toBe(Math.floor((xs.length - window) / step) + 1);
+        mi.forEach((value, i) => {
+            const start = i * step;
+            const expected = mutualInfo(xs.slice(start, start + window), ys.slice(start, start + window));
+            expect(value).toBeCloseTo(expected, 10);
+        });
+    });
+
+    test('.large bases', () => {
+        const mi = mutualInfoWindows(xs.map((x) => x * 1000000000), ys.map((y) => y * 2000000000), 5, 3);
+        mi.forEach((value, i) => {
+            expect(value).toBeCloseTo(mutualInfo(xs.slice(3 * i, 3 * i + 5), ys.slice(3 * i, 3 * i + 5)), 10);
+        });
+    });
+});
+
+describe('mutual information (local)', () => {
+    const xs = [0, 0, 1, 1, 1, 1, 0, 0, 0];
+    const ys = [1, 0, 0, 1, 0, 0, 1, 0, 0];
+
+    test('.throws for different lengths', () => {
+        expect(() => localMutualInfo(xs, ys.slice(1))).toThrow(/different lengths/);
+    });
+
+    test('.averages to mutualInfo', () => {
+        const mi = localMutualInfo(xs, ys);
+        expect(mi.length).toBe(9);
+        expect(mi.reduce((a, b) => a + b, 0) / mi.length).toBeCloseTo(mutualInfo(xs, ys), 10);
+    });
+
+    test('.writes into the output array', () => {
+        const out = new Float64Array(9);
+        expect(localMutualInfo(xs, ys, out)).toBe(out);
+        expect(out).toEqual(localMutualInfo(xs, ys));
+        expect(() => localMutualInfo(xs, ys, new Float64Array(8))).toThrow(/too short/);
+    });
+});
+
+describe('mutual information (binned)', () => {
+    const xs = new Float64Array([0.1, 0.2, 0.9, 0.8, 0.7, 0.6, 0.3, 0.2, 0.1]);
+    const ys = new Float64Array([0.9, 0.2, 0.1, 0.7, 0.3, 0.4, 0.8, 0.0, 0.2]);
+    const expected = mutualInfo([0, 0, 1, 1, 1, 1, 0, 0, 0], [1, 0, 0, 1, 0, 0, 1, 0, 0]);
+
+    test('.bins continuous series', () => {
+        expect(mutualInfo({ data: xs, bins: 2 }, { data: ys, bounds: [0.5] })).toBeCloseTo(expected, 10);
+        expect(mutualInfo({ data: xs, step: 0.45 }, { data: ys, bounds: new Float64Array([0.5]) })).toBeCloseTo(
+            expected,
+            10,
+        );
+    });
+
+    test('.bins trials', () => {
+        const binned = { data: new Float64Array([...xs, ...xs]), bins: 2, trials: 2, steps: 9 };
+        const trials = [[0, 0, 1, 1, 1, 1, 0, 0, 0], [0, 0, 1, 1, 1, 1, 0, 0, 0]];
+        expect(mutualInfo(binned, trials)).toBeCloseTo(mutualInfo(trials, trials), 10);
+    });
+
+    test('.throws for invalid binnings', () => {
+        expect(() => mutualInfo({ data: xs } as any, { data: ys, bins: 2 })).toThrow(/exactly one/);
+        expect(() => mutualInfo({ data: xs, bins: 2, step: 0.5 } as any, { data: ys, bins: 2 })).toThrow(/exactly one/);
+        expect(() => mutualInfo({ data: xs, bounds: 0.5 } as any, { data: ys, bins: 2 })).toThrow(/not an array/);
+        expect(() => mutualInfo({ data: new Float64Array(9).fill(1), bins: 2 }, { data: ys, bins: 2 })).toThrow(
+            /invalid binning/,
+        );
+    });
+});
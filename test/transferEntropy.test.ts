@@ -1,4 +1,10 @@
-import { transferEntropy } from '../src';
+import {
+    localTransferEntropy,
+    transferEntropy,
+    transferEntropyAsync,
+    transferEntropyMatrix,
+    transferEntropyWindows,
+} from '../src';
 
 describe('transfer entropy', () => {
     test('.throws for different lengths', () => {
@@ -70,3 +76,176 @@ describe('transfer entropy', () => {
         expect(transferEntropy(ys, ys, 2)).toBeCloseTo(d, 6);
     });
 });
+
+describe('transfer entropy (views)', () => {
+    test('.offset views', () => {
+        const xs = new Int32Array([9, 1, 1, 0, 0, 1]).subarray(1);
+        const ys = new Int32Array([9, 9, 1, 1, 1, 0, 0]).subarray(2);
+        expect(transferEntropy(xs, ys, 2)).toBeCloseTo(0.666667, 6);
+    });
+});
+
+describe('transfer entropy (async)', () => {
+    test('.rejects for different lengths', async () => {
+        await expect(transferEntropyAsync([0, 0, 0], [0, 0, 0, 0], 2)).rejects.toThrow(/different lengths/);
+    });
+
+    test('.rejects for empty', async () => {
+        await expect(transferEntropyAsync([], [], 2)).rejects.toThrow(/NULL/);
+    });
+
+    test('.rejects for invalid history length', async () => {
+        await expect(transferEntropyAsync([0, 0, 0], [0, 0, 0], 0)).rejects.toThrow(/history length/);
+        await expect(transferEntropyAsync([0, 0], [0, 0], 3)).rejects.toThrow(/history length/);
+    });
+
+    test('.agrees with transferEntropy', async () => {
+        const xs = [0, 1, 0, 1, 0, 0, 1, 1, 0, 0];
+        const ys = [0, 0, 1, 0, 1, 1, 1, 0, 1, 1];
+        const results = await Promise.all([
+            transferEntropyAsync(xs, xs, 2),
+            transferEntropyAsync(ys, xs, 2),
+            transferEntropyAsync(xs, ys, 2),
+            transferEntropyAsync(ys, ys, 2),
+        ]);
+        expect(results[0]).toBeCloseTo(0.0, 6);
+        expect(results[1]).toBeCloseTo(0.344361, 6);
+        expect(results[2]).toBeCloseTo(0.25, 6);
+        expect(results[3]).toBeCloseTo(0.0, 6);
+    });
+});
+
+describe('transfer entropy (matrix)', () => {
+    const series = [
+        [0, 1, 1, 1, 1, 0, 0, 0, 0],
+        [0, 0, 1, 1, 1, 1, 0, 0, 0],
+        new Int32Array([1, 0, 0, 1, 0, 0, 1, 0, 0]),
+        [0, 1, 2, 0, 1, 2, 0, 0, 1],
+    ];
+
+    test('.throws for different lengths', () => {
+        expect(() => transferEntropyMatrix([[0, 0, 0], [0, 0, 0, 0]], 2)).toThrow(/different lengths/);
+    });
+
+    test('.throws for invalid history lengths', () => {
+        expect(() => transferEntropyMatrix([[0, 1, 0], [1, 0, 1]], 0)).toThrow(/zero/);
+        expect(() => transferEntropyMatrix([[0, 1, 0], [1, 0, 1]], 3)).toThrow(/too long/);
+    });
+
+    test('.throws for negative states', () => {
+        expect(() => transferEntropyMatrix([[0, 1, 0], [1, -1, 1]], 1)).toThrow(/negative/);
+    });
+
+    test('.empty', () => {
+        expect(transferEntropyMatrix([], 2)).toEqual(new Float64Array());
+    });
+
+    test('.throws when histories cannot be encoded', () => {
+        const xs = [0, 1, 2, 3, 65535, 1, 2, 3, 4, 5, 6, 7];
+        const ys = [1, 0, 2, 1, 3, 65535, 2, 1, 0, 1, 2, 3];
+        expect(() => transferEntropyMatrix([xs, ys], 4)).toThrow(/encoding/);
+    });
+
+    test('.large bases', () => {
+        const xs = [0, 2000000000, 1, 5, 1, 2];
+        const ys = [0, 2000000000, 3, 1, 1, 0];
+        const te = transferEntropyMatrix([xs, ys], 1);
+        expect(te[1]).toBeCloseTo(transferEntropy([0, 6, 1, 5, 1, 2], [0, 6, 3, 1, 1, 0], 1), 10);
+        expect(te[2]).toBeCloseTo(transferEntropy([0, 6, 3, 1, 1, 0], [0, 6, 1, 5, 1, 2], 1), 10);
+    });
+
+    test.each([1, 2, 3])('.agrees with transferEntropy (k = %d)', (k) => {
+        const n = series.length;
+        const te = transferEntropyMatrix(series, k);
+        expect(te).toBeInstanceOf(Float64Array);
+        expect(te.length).toBe(n * n);
+        for (let i = 0; i < n; ++i) {
+            for (let j = 0; j < n; ++j) {
+                expect(te[i * n + j]).toBeCloseTo(transferEntropy(series[i], series[j], k), 10);
+            }
+        }
+    });
+});
+
+describe('transfer entropy (trials)', () => {
+    const xs = [
+        [0, 1, 1, 1, 1, 0, 0, 0, 0],
+        [1, 1, 0, 0, 0, 0, 1, 1, 0],
+    ];
+    const ys = [
+        [0, 0, 1, 1, 1, 1, 0, 0, 0],
+        [0, 1, 1, 0, 0, 0, 0, 1, 1],
+    ];
+
+    test('.throws for different numbers of trials', () => {
+        const flat = { data: ([] as number[]).concat(...ys), trials: 1, steps: 18 };
+        expect(() => transferEntropy(xs, flat, 2)).toThrow(/numbers of trials/);
+    });
+
+    test('.can', () => {
+        const data = new Int32Array(([] as number[]).concat(...ys));
+        expect(transferEntropy(xs, ys, 2)).toBeCloseTo(0.632482, 6);
+        expect(transferEntropy(xs, { data, trials: 2, steps: 9 }, 2)).toBeCloseTo(0.632482, 6);
+        expect(transferEntropyMatrix([xs, ys], 2)[1]).toBeCloseTo(0.632482, 6);
+    });
+});
+
+describe('transfer entropy (windows)', () => {
+    const xs = [0, 1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 1, 1, 0];
+    const ys = [0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 1, 1];
+
+    test('.throws for invalid windows', () => {
+        expect(() => transferEntropyWindows(xs, ys, 2, 19, 1)).toThrow(/longer/);
+        expect(() => transferEntropyWindows(xs, ys, 2, 5, 0)).toThrow(/step/);
+        expect(() => transferEntropyWindows(xs, ys, 2, 2, 1)).toThrow(/too long/);
+    });
+
+    test.each([
+        [6, 1],
+        [6, 4],
+        [5, 7],
+        [18, 1],
+    ])('.agrees with transferEntropy (window = %d, step = %d)', (window, step) => {
+        const te = transferEntropyWindows(xs, ys, 2, window, step);
+        expect(te.length).toBe(Math.floor((xs.length - window) / step) + 1);
+        te.forEach((value, i) => {
+            const start = i * step;
+            const expected = transferEntropy(xs.slice(start, start + window), ys.slice(start, start + window), 2);
+            expect(value).toBeCloseTo(expected, 10);
+        });
+    });
+
+    test('.throws when histories cannot be encoded', () => {
+        const big = ys.map((y) => y * 65535);
+        expect(() => transferEntropyWindows(xs, big, 3, 12, 1)).toThrow(/encoding/);
+    });
+
+    test('.large bases', () => {
+        const te = transferEntropyWindows(xs.map((x) => x * 5000), ys.map((y) => y * 5000), 2, 6, 4);
+        te.forEach((value, i) => {
+            const expected = transferEntropy(xs.slice(4 * i, 4 * i + 6), ys.slice(4 * i, 4 * i + 6), 2);
+            expect(value).toBeCloseTo(expected, 10);
+        });
+    });
+});
+
+describe('transfer entropy (local)', () => {
+    const xs = [1, 0, 0, 1, 0, 0, 1, 0, 0];
+    const ys = [0, 0, 1, 1, 1, 1, 0, 0, 0];
+
+    test('.can', () => {
+        const te = localTransferEntropy(xs, ys, 2);
+        expect(Array.from(te)).toEqual([0, 0, 0.5849625007211562, -0.4150374992788438, 0.5849625007211562, 0, 0]);
+    });
+
+    test('.averages to transferEntropy', () => {
+        const te = localTransferEntropy(xs, ys, 2);
+        expect(te.reduce((a, b) => a + b, 0) / te.length).toBeCloseTo(transferEntropy(xs, ys, 2), 10);
+    });
+
+    test('.writes into the output array', () => {
+        const out = new Float64Array(7);
+        expect(localTransferEntropy(xs, ys, 2, out)).toBe(out);
+        expect(() => localTransferEntropy(xs, ys, 2, new Float64Array(6))).toThrow(/too short/);
+    });
+});